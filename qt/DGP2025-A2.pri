@@ -24,6 +24,7 @@ SOURCES += \
 	$$SOURCEDIR/core/Partition.cpp \
 	$$SOURCEDIR/core/PolygonMesh.cpp \
 	$$SOURCEDIR/core/PolygonMeshTest.cpp \
+	$$SOURCEDIR/core/TriangleMesh.cpp \
 #
 	$$SOURCEDIR/gui/GuiAboutDialog.cpp \
 	$$SOURCEDIR/gui/GuiGLBuffer.cpp \
@@ -38,9 +39,16 @@ SOURCES += \
 #
 	$$SOURCEDIR/io/AppLoader.cpp \
 	$$SOURCEDIR/io/AppSaver.cpp \
+	$$SOURCEDIR/io/GzFile.cpp \
+	$$SOURCEDIR/io/Loader.cpp \
+	$$SOURCEDIR/io/LoaderDgpb.cpp \
 	$$SOURCEDIR/io/LoaderPly.cpp \
 	$$SOURCEDIR/io/LoaderStl.cpp \
 	$$SOURCEDIR/io/LoaderWrl.cpp \
+	$$SOURCEDIR/io/MemoryFile.cpp \
+	$$SOURCEDIR/io/OutputBuffer.cpp \
+	$$SOURCEDIR/io/Saver.cpp \
+	$$SOURCEDIR/io/SaverDgpb.cpp \
 	$$SOURCEDIR/io/SaverPly.cpp \
 	$$SOURCEDIR/io/SaverStl.cpp \
 	$$SOURCEDIR/io/SaverWrl.cpp \
@@ -48,9 +56,13 @@ SOURCES += \
 	$$SOURCEDIR/io/TokenizerFile.cpp \
 	$$SOURCEDIR/io/TokenizerString.cpp \
 #
+	$$SOURCEDIR/util/Arena.cpp \
 	$$SOURCEDIR/util/BBox.cpp \
 	$$SOURCEDIR/util/Endian.cpp \
+	$$SOURCEDIR/util/Quantize.cpp \
 	$$SOURCEDIR/util/StaticRotation.cpp \
+	$$SOURCEDIR/util/ThreadPool.cpp \
+	$$SOURCEDIR/util/TriangleNormals.cpp \
 #
 	$$SOURCEDIR/wrl/Ply.cpp \
 	$$SOURCEDIR/wrl/Appearance.cpp \
@@ -79,6 +91,7 @@ HEADERS += \
 	$$SOURCEDIR/core/Partition.hpp \
 	$$SOURCEDIR/core/PolygonMesh.hpp \
 	$$SOURCEDIR/core/PolygonMeshTest.hpp \
+	$$SOURCEDIR/core/TriangleMesh.hpp \
 #
 	$$SOURCEDIR/gui/GuiAboutDialog.hpp \
 	$$SOURCEDIR/gui/GuiGLBuffer.hpp \
@@ -93,11 +106,17 @@ HEADERS += \
 #
 	$$SOURCEDIR/io/AppLoader.hpp \
 	$$SOURCEDIR/io/AppSaver.hpp \
+	$$SOURCEDIR/io/Dgpb.hpp \
+	$$SOURCEDIR/io/GzFile.hpp \
 	$$SOURCEDIR/io/Loader.hpp \
+	$$SOURCEDIR/io/LoaderDgpb.hpp \
 	$$SOURCEDIR/io/LoaderPly.hpp \
 	$$SOURCEDIR/io/LoaderStl.hpp \
 	$$SOURCEDIR/io/LoaderWrl.hpp \
+	$$SOURCEDIR/io/MemoryFile.hpp \
+	$$SOURCEDIR/io/OutputBuffer.hpp \
 	$$SOURCEDIR/io/Saver.hpp \
+	$$SOURCEDIR/io/SaverDgpb.hpp \
 	$$SOURCEDIR/io/SaverPly.hpp \
 	$$SOURCEDIR/io/SaverStl.hpp \
 	$$SOURCEDIR/io/SaverWrl.hpp \
@@ -106,10 +125,14 @@ HEADERS += \
 	$$SOURCEDIR/io/TokenizerFile.hpp \
 	$$SOURCEDIR/io/TokenizerString.hpp \
 #
+	$$SOURCEDIR/util/Arena.hpp \
 	$$SOURCEDIR/util/CastMacros.hpp \
 	$$SOURCEDIR/util/BBox.hpp \
 	$$SOURCEDIR/util/Endian.hpp \
+	$$SOURCEDIR/util/Quantize.hpp \
 	$$SOURCEDIR/util/StaticRotation.hpp \
+	$$SOURCEDIR/util/ThreadPool.hpp \
+	$$SOURCEDIR/util/TriangleNormals.hpp \
 #
 	$$SOURCEDIR/wrl/Ply.hpp \
 	$$SOURCEDIR/wrl/Appearance.hpp \
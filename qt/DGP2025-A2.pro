@@ -38,6 +38,11 @@ win32 {
     DSHOW_LIBS = -lStrmiids -lVfw32 -lOle32 -lOleAut32 -lopengl32
 }
 
+unix {
+    # gzip compressed files, see io/GzFile.cpp
+    LIBS += -lz
+}
+
 unix:!macx {
     QMAKE_LFLAGS += -Wl
     # QMAKE_CXXFLAGS += -g
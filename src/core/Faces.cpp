@@ -78,6 +78,16 @@ Faces::Faces(const int nV, const vector<int>& coordIndex) {
 
 }
 
+Faces::Faces(const TriangleMesh& mesh) {
+    // every face ends at corner 4*iF+3
+    int nF = mesh.getNumberOfFaces();
+    TriangleMesh::toCoordIndex(mesh.getTriangleIndex(),m_CoordIndex);
+    m_FacesIndex.resize(nF);
+    for (int iF = 0; iF < nF; ++iF)
+        m_FacesIndex[iF] = 4*iF+3;
+    m_nVerts = mesh.getNumberOfVertices();
+}
+
 int Faces::getNumberOfVertices() const {
   return m_nVerts;
 }
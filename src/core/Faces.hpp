@@ -38,6 +38,7 @@
 #define _FACES_HPP_
 
 #include <vector>
+#include "TriangleMesh.hpp"
 
 using namespace std;
 
@@ -46,6 +47,10 @@ class Faces {
 public:
           Faces(const int nV, const vector<int>& coordIndex);
 
+  // the corners are numbered as in the VRML layout of the mesh, with
+  // a -1 separator after each triangle
+          Faces(const TriangleMesh& mesh);
+
   // The constructor should compare the nV value passed as a parameter
   // with the non-negative values in stored in the coordIndex index
   // array, and update the value of nV stored internally if
@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:34:23 taubin>
+//------------------------------------------------------------------------
+//
+// TriangleMesh.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <math.h>
+#include "TriangleMesh.hpp"
+
+TriangleMesh::TriangleMesh(const int nV, const vector<int>& triangleIndex):
+  _nV(nV),
+  _triangleIndex(triangleIndex) {
+  for(const int iV : _triangleIndex)
+    if(iV>=_nV) _nV = iV+1;
+}
+
+int TriangleMesh::getNumberOfVertices() const {
+  return _nV;
+}
+
+int TriangleMesh::getNumberOfFaces() const {
+  return static_cast<int>(_triangleIndex.size()/3);
+}
+
+int TriangleMesh::getNumberOfCorners() const {
+  return static_cast<int>(_triangleIndex.size());
+}
+
+const vector<int>& TriangleMesh::getTriangleIndex() const {
+  return _triangleIndex;
+}
+
+// static
+bool TriangleMesh::isTriangleMesh(const vector<int>& coordIndex) {
+  // every fourth value is a separator, and only those
+  const size_t nC = coordIndex.size();
+  if(nC%4!=0) return false;
+  const int* ci = coordIndex.data();
+  for(size_t iC=0;iC<nC;iC+=4)
+    if(ci[iC]<0 || ci[iC+1]<0 || ci[iC+2]<0 || ci[iC+3]>=0)
+      return false;
+  return true;
+}
+
+// static
+bool TriangleMesh::fromCoordIndex
+(const vector<int>& coordIndex, vector<int>& triangleIndex) {
+  triangleIndex.clear();
+  if(isTriangleMesh(coordIndex)==false) return false;
+  const size_t nF = coordIndex.size()/4;
+  triangleIndex.resize(3*nF);
+  const int* ci = coordIndex.data();
+  int*       ti = triangleIndex.data();
+  for(size_t iF=0;iF<nF;iF++,ci+=4,ti+=3) {
+    ti[0] = ci[0]; ti[1] = ci[1]; ti[2] = ci[2];
+  }
+  return true;
+}
+
+// static
+void TriangleMesh::toCoordIndex
+(const vector<int>& triangleIndex, vector<int>& coordIndex) {
+  const size_t nF = triangleIndex.size()/3;
+  coordIndex.resize(4*nF);
+  const int* ti = triangleIndex.data();
+  int*       ci = coordIndex.data();
+  for(size_t iF=0;iF<nF;iF++,ti+=3,ci+=4) {
+    ci[0] = ti[0]; ci[1] = ti[1]; ci[2] = ti[2]; ci[3] = -1;
+  }
+}
+
+float TriangleMesh::getAcmr(const int cacheSize) const {
+  const int nF = getNumberOfFaces();
+  if(nF==0 || cacheSize<=0) return 0.0f;
+  // a vertex is in the cache if fewer than cacheSize vertices have
+  // been transformed since it was
+  vector<long> timeStamp(_nV,-static_cast<long>(cacheSize)-1);
+  long nTransformed = 0;
+  for(const int iV : _triangleIndex) {
+    if(iV<0) continue;
+    if(nTransformed-timeStamp[iV]>cacheSize)
+      timeStamp[iV] = nTransformed++;
+  }
+  return static_cast<float>(nTransformed)/static_cast<float>(nF);
+}
+
+// scores of the Forsyth algorithm
+#define FORSYTH_CACHE_SIZE    32
+#define FORSYTH_MAX_VALENCE   32
+
+// the tables are filled once, by the first caller, in a thread safe way
+struct ForsythScores {
+  float _cache[FORSYTH_CACHE_SIZE];
+  float _valence[FORSYTH_MAX_VALENCE];
+  ForsythScores() {
+    // the vertices of the last face get a fixed score, so that the
+    // next face does not simply reuse its edge
+    for(int i=0;i<FORSYTH_CACHE_SIZE;i++) {
+      if(i<3) {
+        _cache[i] = 0.75f;
+      } else {
+        float s = 1.0f-static_cast<float>(i-3)/(FORSYTH_CACHE_SIZE-3);
+        _cache[i] = powf(s,1.5f);
+      }
+    }
+    // vertices with few faces left are finished first
+    for(int i=0;i<FORSYTH_MAX_VALENCE;i++)
+      _valence[i] = (i>0)?2.0f/sqrtf(static_cast<float>(i)):0.0f;
+  }
+  float score(const int cachePos, const int nActive) const {
+    if(nActive==0) return -1.0f;
+    float s = (cachePos>=0)?_cache[cachePos]:0.0f;
+    return s+((nActive<FORSYTH_MAX_VALENCE)?
+              _valence[nActive]:
+              2.0f/sqrtf(static_cast<float>(nActive)));
+  }
+};
+
+void TriangleMesh::getVertexCacheOrder(vector<int>& faceOrder) const {
+  const int nF = getNumberOfFaces();
+  const int nV = _nV;
+  faceOrder.clear();
+  if(nF==0) return;
+  static const ForsythScores forsyth;
+
+  int iV,iF,i,j;
+
+  // faces of each vertex; the first nActive[iV] are not emitted yet
+  vector<int> first(nV+1,0);
+  for(const int v : _triangleIndex) first[v+1]++;
+  for(iV=0;iV<nV;iV++) first[iV+1] += first[iV];
+  vector<int> vFace(first[nV]);
+  vector<int> nActive(nV,0);
+  for(iF=0;iF<nF;iF++)
+    for(j=0;j<3;j++) {
+      iV = _triangleIndex[3*iF+j];
+      vFace[first[iV]+nActive[iV]++] = iF;
+    }
+
+  vector<int>   cachePos(nV,-1);
+  vector<float> vScore(nV);
+  for(iV=0;iV<nV;iV++) vScore[iV] = forsyth.score(-1,nActive[iV]);
+  vector<bool>  emitted(nF,false);
+
+  int   cache[FORSYTH_CACHE_SIZE+3];
+  int   newCache[FORSYTH_CACHE_SIZE+3];
+  int   nCache = 0;
+  int   bestF  = -1;
+  float bestScore;
+  int   nextF  = 0; // faces before nextF have been emitted
+
+  faceOrder.reserve(nF);
+  while(static_cast<int>(faceOrder.size())<nF) {
+
+    // no face left around the cache vertices; restart from the first
+    // face not emitted yet
+    if(bestF<0) {
+      while(emitted[nextF]) nextF++;
+      bestF = nextF;
+    }
+
+    faceOrder.push_back(bestF);
+    emitted[bestF] = true;
+    const int* f = &_triangleIndex[3*bestF];
+
+    // the face is no longer active at its vertices
+    for(j=0;j<3;j++) {
+      iV = f[j];
+      int* vf = &vFace[first[iV]];
+      for(i=0;vf[i]!=bestF;i++);
+      vf[i] = vf[--nActive[iV]];
+      vf[nActive[iV]] = bestF;
+    }
+
+    // the vertices of the face move to the front of the LRU cache
+    int nNew = 0;
+    for(j=0;j<3;j++)
+      if((j<1 || f[j]!=f[0]) && (j<2 || f[j]!=f[1]))
+        newCache[nNew++] = f[j];
+    for(i=0;i<nCache;i++)
+      if(cache[i]!=f[0] && cache[i]!=f[1] && cache[i]!=f[2])
+        newCache[nNew++] = cache[i];
+    for(i=0;i<nNew;i++) {
+      iV = newCache[i];
+      cachePos[iV] = (i<FORSYTH_CACHE_SIZE)?i:-1;
+      vScore[iV] = forsyth.score(cachePos[iV],nActive[iV]);
+    }
+
+    // rescore the faces around the vertices of the cache, including
+    // the ones which fell off it, and pick the best one
+    bestF     = -1;
+    bestScore = -1.0f;
+    for(i=0;i<nNew;i++) {
+      iV = newCache[i];
+      const int* vf = &vFace[first[iV]];
+      for(int k=0;k<nActive[iV];k++) {
+        iF = vf[k];
+        const int* g = &_triangleIndex[3*iF];
+        float s = vScore[g[0]]+vScore[g[1]]+vScore[g[2]];
+        if(s>bestScore) { bestScore = s; bestF = iF; }
+      }
+    }
+
+    nCache = (nNew<FORSYTH_CACHE_SIZE)?nNew:FORSYTH_CACHE_SIZE;
+    for(i=0;i<nCache;i++) cache[i] = newCache[i];
+  }
+}
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:34:23 taubin>
+//------------------------------------------------------------------------
+//
+// TriangleMesh.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _TRIANGLE_MESH_HPP_
+#define _TRIANGLE_MESH_HPP_
+
+#include <vector>
+
+using namespace std;
+
+class TriangleMesh {
+
+  // - Connectivity of a triangle mesh stored with a fixed stride of
+  //   three vertex indices per face, and without the -1 face
+  //   separators of the VRML coordIndex layout, which take a quarter
+  //   of its space
+  // - Face iF comprises the corners 3*iF, 3*iF+1, and 3*iF+2
+  // - The triangleIndex array passed to the constructor is referenced,
+  //   not copied, and must not change while the TriangleMesh is used
+
+public:
+
+          TriangleMesh(const int nV, const vector<int>& triangleIndex);
+
+  // nV, or one more than the largest vertex index if larger
+  int     getNumberOfVertices()                    const;
+  int     getNumberOfFaces()                       const;
+  int     getNumberOfCorners()                     const;
+
+  // no range checks, so that loops over the faces do not branch
+  int     getFaceVertex(const int iF, const int j) const {
+    return _triangleIndex[3*iF+j];
+  }
+  const int* getFace(const int iF)                 const {
+    return _triangleIndex.data()+3*iF;
+  }
+
+  const vector<int>& getTriangleIndex()            const;
+
+  // - getAcmr() simulates a FIFO post-transform vertex cache of
+  //   cacheSize entries over the faces in their current order, and
+  //   returns the average number of vertices transformed per face
+  //   (ACMR), between about 0.5 for large regular meshes and 3
+  // - getVertexCacheOrder() computes an order of the faces with a low
+  //   ACMR, using the greedy algorithm of T. Forsyth, "Linear-Speed
+  //   Vertex Cache Optimisation" (2006); faceOrder[i] is the index of
+  //   the face which goes in position i
+  float   getAcmr(const int cacheSize=32)          const;
+  void    getVertexCacheOrder(vector<int>& faceOrder) const;
+
+  // conversions between the two layouts; fromCoordIndex() returns
+  // false, and leaves triangleIndex empty, if coordIndex has a face
+  // which is not a triangle
+  static bool isTriangleMesh(const vector<int>& coordIndex);
+  static bool fromCoordIndex(const vector<int>& coordIndex,
+                             vector<int>& triangleIndex);
+  static void toCoordIndex(const vector<int>& triangleIndex,
+                           vector<int>& coordIndex);
+
+private:
+
+  int                _nV;
+  const vector<int>& _triangleIndex;
+
+};
+
+#endif /* _TRIANGLE_MESH_HPP_ */
@@ -68,16 +68,23 @@ GuiGLBuffer::GuiGLBuffer(IndexedFaceSet* pIfs, QColor& materialColor):
 
   if(pIfs==(IndexedFaceSet*)0) return;
 
-  vector<float>& coord       = pIfs->getCoord();
-  vector<int>&   coordIndex  = pIfs->getCoordIndex();
+  // values held in compact encodings are decoded into temporary
+  // buffers, and the IndexedFaceSet keeps them encoded
+  vector<float>  coordBuffer,colorBuffer,normalBuffer;
+  const vector<float>& coord = pIfs->readCoord(coordBuffer);
+  // triangle meshes held in triangleIndex are drawn without converting
+  // them back to the VRML layout
+  bool           triangles   = pIfs->hasTriangleIndex();
+  vector<int>&   coordIndex  =
+    (triangles)?pIfs->getTriangleIndex():pIfs->getCoordIndex();
 
   bool           colorPerVertex = pIfs->getColorPerVertex();
-  vector<float>& color       = pIfs->getColor();
+  const vector<float>& color = pIfs->readColor(colorBuffer);
   vector<int>&   colorIndex  = pIfs->getColorIndex();
   // IndexedFaceSet::Binding   cBinding    = pIfs->getColorBinding();
 
   bool           normalPerVertex = pIfs->getNormalPerVertex();
-  vector<float>& normal      = pIfs->getNormal();
+  const vector<float>& normal = pIfs->readNormal(normalBuffer);
   vector<int>&   normalIndex = pIfs->getNormalIndex();
   // IndexedFaceSet::Binding   nBinding    = pIfs->getNormalBinding();
 
@@ -110,62 +117,101 @@ GuiGLBuffer::GuiGLBuffer(IndexedFaceSet* pIfs, QColor& materialColor):
     int   j[3];
 
     int iN,iC,iV,k,h,i0,i1,iF;
-    for(iF=i0=i1=0;i1<(int)coordIndex.size();i1++) {
-      if(coordIndex[i1]<0) {
-        // number of triangles in this face
-        // nTrianglesFace = i1-i0-2;
+    if(triangles) {
+      // three corners per face, and no separators to look for; the
+      // properties are bound per vertex or per face
+      for(iF=0;iF<nF;iF++) {
 
         if(_hasNormal && normalPerVertex==false) {
-          // NORMAL_PER_FACE_INDEXED or NORMAL_PER_FACE
           iN = (normalIndex.size()>0)?normalIndex[iF]:iF;
           for(h=0;h<3;h++)
             n[0][h] = n[1][h] = n[2][h] = normal[3*iN+h];
         }
 
         if(_hasColor && colorPerVertex==false) {
-          // COLOR_PER_FACE_INDEXED or COLOR_PER_FACE
           iC = (colorIndex.size()>0)?colorIndex[iF]:iF;
           for(h=0;h<3;h++)
             c[0][h] = c[1][h] = c[2][h] = color[3*iC+h];
         }
 
-        // triangulate face [i0:i1) on the fly and add triangles to current mesh
-        for(j[0]=i0,j[1]=i0+1,j[2]=i0+2;j[2]<i1;j[1]=j[2]++) {
-          // triangle [j0,j1,j2]
-          for(k=0;k<3;k++) {
-            // get vertex coordinates
-            iV = coordIndex[j[k]];
+        for(k=0;k<3;k++) {
+          iV = coordIndex[3*iF+k];
+          for(h=0;h<3;h++)
+            x[k][h] = coord[3*iV+h];
+          if(_hasNormal && normalPerVertex==true)
             for(h=0;h<3;h++)
-              x[k][h] = coord[3*iV+h];
+              n[k][h] = normal[3*iV+h];
+          if(_hasColor && colorPerVertex==true)
+            for(h=0;h<3;h++)
+              c[k][h] = color[3*iV+h];
+        }
 
-            if(_hasNormal && normalPerVertex==true) {
-              // NORMAL_PER_CORNER or NORNAL_PER_VERTEX
-              iN = (normalIndex.size()>0)?normalIndex[j[k]]:iV;
-              for(h=0;h<3;h++)
-                n[k][h] = normal[3*iN+h];
-            }
+        for(k=2;k>=0;k--) {
+          m_vertices.append(QVector3D(x[k][0],x[k][1],x[k][2]));
+          if(_hasNormal)
+            m_normals.append(QVector3D(n[k][0],n[k][1],n[k][2]));
+          if(_hasColor)
+            m_colors.append(QVector3D(c[k][0],c[k][1],c[k][2]));
+        }
+      }
+    } else /* VRML layout */ {
+      for(iF=i0=i1=0;i1<(int)coordIndex.size();i1++) {
+        if(coordIndex[i1]<0) {
+          // number of triangles in this face
+          // nTrianglesFace = i1-i0-2;
+
+          if(_hasNormal && normalPerVertex==false) {
+            // NORMAL_PER_FACE_INDEXED or NORMAL_PER_FACE
+            iN = (normalIndex.size()>0)?normalIndex[iF]:iF;
+            for(h=0;h<3;h++)
+              n[0][h] = n[1][h] = n[2][h] = normal[3*iN+h];
+          }
 
-            if(_hasColor && colorPerVertex==true) {
-              // COLOR_PER_CORNER or COLOR_PER_VERTEX
-              iC = (colorIndex.size()>0)?colorIndex[j[k]]:iV;
+          if(_hasColor && colorPerVertex==false) {
+            // COLOR_PER_FACE_INDEXED or COLOR_PER_FACE
+            iC = (colorIndex.size()>0)?colorIndex[iF]:iF;
+            for(h=0;h<3;h++)
+              c[0][h] = c[1][h] = c[2][h] = color[3*iC+h];
+          }
+
+          // triangulate face [i0:i1) on the fly and add triangles to current mesh
+          for(j[0]=i0,j[1]=i0+1,j[2]=i0+2;j[2]<i1;j[1]=j[2]++) {
+            // triangle [j0,j1,j2]
+            for(k=0;k<3;k++) {
+              // get vertex coordinates
+              iV = coordIndex[j[k]];
               for(h=0;h<3;h++)
-                c[k][h] = color[3*iC+h];
+                x[k][h] = coord[3*iV+h];
+
+              if(_hasNormal && normalPerVertex==true) {
+                // NORMAL_PER_CORNER or NORNAL_PER_VERTEX
+                iN = (normalIndex.size()>0)?normalIndex[j[k]]:iV;
+                for(h=0;h<3;h++)
+                  n[k][h] = normal[3*iN+h];
+              }
+
+              if(_hasColor && colorPerVertex==true) {
+                // COLOR_PER_CORNER or COLOR_PER_VERTEX
+                iC = (colorIndex.size()>0)?colorIndex[j[k]]:iV;
+                for(h=0;h<3;h++)
+                  c[k][h] = color[3*iC+h];
+              }
+
             }
 
+            // push values into buffers
+            for(k=2;k>=0;k--) {
+              m_vertices.append(QVector3D(x[k][0],x[k][1],x[k][2]));
+              if(_hasNormal)
+                m_normals.append(QVector3D(n[k][0],n[k][1],n[k][2]));
+              if(_hasColor)
+                m_colors.append(QVector3D(c[k][0],c[k][1],c[k][2]));
+            }
           }
 
-          // push values into buffers
-          for(k=2;k>=0;k--) {
-            m_vertices.append(QVector3D(x[k][0],x[k][1],x[k][2]));
-            if(_hasNormal)
-              m_normals.append(QVector3D(n[k][0],n[k][1],n[k][2]));
-            if(_hasColor)
-              m_colors.append(QVector3D(c[k][0],c[k][1],c[k][2]));
-          }
+          // advance to next face
+          i0 = i1+1; iF++;
         }
-
-        // advance to next face
-        i0 = i1+1; iF++;
       }
     }
 
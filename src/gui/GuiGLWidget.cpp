@@ -163,7 +163,8 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
     sgt.start();
     Node* node=(Node*)0;
     while((node=sgt.next())!=(Node*)0) {
-      if(Shape* shape = dynamic_cast<Shape*>(node)) {
+      if(node->isShape()) {
+        Shape* shape = (Shape*)node;
 
         // cout << "    found Shape \"" << shape->getName() << "\"\n";
         
@@ -175,12 +176,14 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
         //      << materialColor.blue()  << ")\n";
 
         node = shape->getAppearance();
-        if(Appearance* appearance = dynamic_cast<Appearance*>(node)) {
+        if(node!=(Node*)0 && node->isAppearance()) {
+          Appearance* appearance = (Appearance*)node;
           
           // cout << "      has Appearance\n";
 
           node = appearance->getMaterial();
-          if(Material* material = dynamic_cast<Material*>(node)) {
+          if(node!=(Node*)0 && node->isMaterial()) {
+            Material* material = (Material*)node;
             
             // cout << "        has Material\n";
 
@@ -197,7 +200,8 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
         }
 
         node = shape->getGeometry();
-        if(IndexedFaceSet* pIfs = dynamic_cast<IndexedFaceSet*>(node)) {
+        if(node!=(Node*)0 && node->isIndexedFaceSet()) {
+          IndexedFaceSet* pIfs = (IndexedFaceSet*)node;
 
           // cout << "      has geometry IndexedFaceSet\n";
           // cout << "      creating shader ... \n";
@@ -215,7 +219,8 @@ void GuiGLWidget::setSceneGraph(SceneGraph* pWrl, bool resetHomeView) {
           shader->setVertexBuffer(ifsb);
           _shaderMap[shape] = shader;
 
-        } else if(IndexedLineSet* pIls = dynamic_cast<IndexedLineSet*>(node)) {
+        } else if(node!=(Node*)0 && node->isIndexedLineSet()) {
+          IndexedLineSet* pIls = (IndexedLineSet*)node;
 
           // cout << "      has geometry IndexedLineSet\n";
           // cout << "      creating shader ... \n";
@@ -286,21 +291,24 @@ void GuiGLWidget::invertNormal() {
     GuiGLBuffer*   vbo      = shader->getVertexBuffer();
 
     Node* geometry = shape->getGeometry();
-    if(IndexedFaceSet* ifs=dynamic_cast<IndexedFaceSet*>(geometry)) {
+    if(geometry!=(Node*)0 && geometry->isIndexedFaceSet()) {
+      IndexedFaceSet* ifs = (IndexedFaceSet*)geometry;
 
+      bool quantized = ifs->hasQuantizedNormal();
       vector<float> &normal = ifs->getNormal();    
       float n0,n1,n2;
       for(unsigned i=0;i<normal.size();i+=3) {
         n0 = normal[i+0]; n1 = normal[i+1]; n2 = normal[i+2];
         normal[i+0] = -n0; normal[i+1] = -n1; normal[i+2] = -n2;
       }
+      if(quantized) ifs->quantizeNormal();
 
       QColor materialColor(255,150,90);
-      if(Appearance* appearance =
-         dynamic_cast<Appearance*>(shape->getAppearance())) {
-        if(Material* material =
-           dynamic_cast<Material*>(appearance->getMaterial())) {
-          Color& diffuseColor = material->getDiffuseColor();
+      Node* appearance = shape->getAppearance();
+      if(appearance!=(Node*)0 && appearance->isAppearance()) {
+        Node* material = ((Appearance*)appearance)->getMaterial();
+        if(material!=(Node*)0 && material->isMaterial()) {
+          Color& diffuseColor = ((Material*)material)->getDiffuseColor();
           materialColor.setRedF(diffuseColor.r);
           materialColor.setGreenF(diffuseColor.g);
           materialColor.setBlueF(diffuseColor.b);
@@ -358,8 +366,9 @@ void GuiGLWidget::initializeGL() {
 //////////////////////////////////////////////////////////////////////
 void GuiGLWidget::paintShape(QMatrix4x4& mvp, Shape* shape) {
   if(shape==(Shape*)0 || shape->getShow()==false) return;
-  if(dynamic_cast<IndexedFaceSet*>(shape->getGeometry()) ||
-     dynamic_cast<IndexedLineSet*>(shape->getGeometry())) {
+  Node* geometry = shape->getGeometry();
+  if(geometry!=(Node*)0 &&
+     (geometry->isIndexedFaceSet() || geometry->isIndexedLineSet())) {
     if(GuiGLShader* shader = _shaderMap[shape]) {
       shader->setMVPMatrix(mvp);
       shader->paint(*this);
@@ -373,12 +382,19 @@ void GuiGLWidget::paintGroup(QMatrix4x4& mvp, Group* group) {
   unsigned nChildren = group->getNumberOfChildren();
   for(unsigned i=0;i<nChildren;i++) {
     Node* node = (*group)[i];
-    if(Shape* s = dynamic_cast<Shape*>(node)) {
-      paintShape(mvp, s);
-    } else if(Transform* t = dynamic_cast<Transform*>(node)) {
-      paintTransform(mvp, t);
-    } else if(Group* g = dynamic_cast<Group*>(node)) {
-      paintGroup(mvp, g);
+    switch(node->getNodeType()) {
+    case Node::SHAPE:
+      paintShape(mvp, (Shape*)node);
+      break;
+    case Node::TRANSFORM:
+      paintTransform(mvp, (Transform*)node);
+      break;
+    case Node::GROUP:
+    case Node::SCENE_GRAPH:
+      paintGroup(mvp, (Group*)node);
+      break;
+    default:
+      break;
     }
   }
 }
@@ -56,13 +56,19 @@
 #include "io/LoaderPly.hpp"
 #include "io/SaverPly.hpp"
 
+#include "io/LoaderDgpb.hpp"
+#include "io/SaverDgpb.hpp"
+
 int     GuiMainWindow::_timerInterval = 20;
 int     GuiMainWindow::_lDPI          = 96;
 QString GuiMainWindow::_platformName  = "unknown";
 
 //////////////////////////////////////////////////////////////////////
 GuiMainWindow::GuiMainWindow(QWidget* parent):
-  QMainWindow(parent) {
+  QMainWindow(parent),
+  _loadCancel(false),
+  _loadBytesRead(0),
+  _loadBytesTotal(0) {
   setupUi(this);
   setWindowIcon(QIcon("qt.icns"));
   setWindowTitle(QString("DGP2025-A2 | Student : %1").arg(STUDENT_NAME));
@@ -82,11 +88,36 @@ GuiMainWindow::GuiMainWindow(QWidget* parent):
   SaverPly* plySaver = new SaverPly();
   _saver.registerSaver(plySaver);
 
+  LoaderDgpb* dgpbLoader = new LoaderDgpb();
+  _loader.registerLoader(dgpbLoader);
+  SaverDgpb* dgpbSaver = new SaverDgpb();
+  _saver.registerSaver(dgpbSaver);
+
   // for animation
   _timer = new QTimer(this);
   _timer->setInterval(_timerInterval);
   connect(_timer, SIGNAL(timeout()), glWidget, SLOT(update()));
 
+  // progress of the file being loaded, polled from the worker thread
+  _loadProgressBar = new QProgressBar(this);
+  _loadProgressBar->setRange(0,1000);
+  _loadProgressBar->setTextVisible(false);
+  _loadProgressBar->setMaximumWidth(200);
+  _loadProgressBar->hide();
+  statusBar()->addPermanentWidget(_loadProgressBar);
+  _loadCancelButton = new QPushButton(tr("Cancel"),this);
+  _loadCancelButton->hide();
+  statusBar()->addPermanentWidget(_loadCancelButton);
+  connect(_loadCancelButton, SIGNAL(clicked()), this, SLOT(cancelLoad()));
+  _loadTimer = new QTimer(this);
+  _loadTimer->setInterval(100);
+  connect(_loadTimer, SIGNAL(timeout()), this, SLOT(updateLoadProgress()));
+  _loader.setProgress([this](const size_t nBytesRead, const size_t nBytesTotal) {
+      _loadBytesRead  = nBytesRead;
+      _loadBytesTotal = nBytesTotal;
+      return (_loadCancel==false);
+    });
+
   int tHeight = (_lDPI<=96)?600:(_lDPI<=144)?900:1200;
   int tWidth = (_lDPI<=96)?400:(_lDPI<=144)?600:800;
   int gHeight = tHeight;
@@ -112,6 +143,10 @@ GuiMainWindow::GuiMainWindow(QWidget* parent):
 
 //////////////////////////////////////////////////////////////////////
 GuiMainWindow::~GuiMainWindow() {
+  if(_loadThread.joinable()) {
+    _loadCancel = true;
+    _loadThread.join();
+  }
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -120,23 +155,80 @@ void GuiMainWindow::showStatusBarMessage(const QString & message) {
 }
 
 //////////////////////////////////////////////////////////////////////
-SceneGraph* GuiMainWindow::loadSceneGraph(const char* fname) {
+bool GuiMainWindow::loadSceneGraph(const char* fname) {
   static char str[1024];
+  if(_loadThread.joinable()) {
+    showStatusBarMessage("Another file is being loaded");
+    return false;
+  }
   snprintf(str,1024,"Trying to load \"%s\" ...",fname);
   showStatusBarMessage(QString(str));
-  SceneGraph* pWrl = new SceneGraph();
-  if(_loader.load(fname,*pWrl)) { // if success
-    snprintf(str,1024,"Loaded \"%s\"",fname);
-    pWrl->updateBBox();
+
+  _loadCancel     = false;
+  _loadBytesRead  = 0;
+  _loadBytesTotal = 0;
+  fileLoadAction->setEnabled(false);
+  _loadProgressBar->setValue(0);
+  _loadProgressBar->show();
+  _loadCancelButton->setEnabled(true);
+  _loadCancelButton->show();
+  _loadTimer->start();
+
+  // the viewer keeps drawing the current scene graph while the new one
+  // is loaded; the worker thread only touches _loader and the new
+  // scene graph, which is handed over to the GUI thread when complete
+  std::string filename(fname);
+  _loadThread = std::thread([this,filename]() {
+      SceneGraph* pWrl = new SceneGraph();
+      // large assemblies load and are deleted faster from an arena
+      pWrl->setUseArena(true);
+      if(_loader.load(filename.c_str(),*pWrl)) {
+        pWrl->updateBBox();
+      } else {
+        delete pWrl;
+        pWrl = (SceneGraph*)0;
+      }
+      QMetaObject::invokeMethod(this,[this,pWrl,filename]() {
+          loadFinished(pWrl,filename);
+        },Qt::QueuedConnection);
+    });
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+void GuiMainWindow::loadFinished
+(SceneGraph* pWrl, const std::string& filename) {
+  static char str[1024];
+  _loadThread.join();
+  _loadTimer->stop();
+  _loadProgressBar->hide();
+  _loadCancelButton->hide();
+  fileLoadAction->setEnabled(true);
+  if(pWrl!=(SceneGraph*)0) { // if success
+    snprintf(str,1024,"Loaded \"%s\"",filename.c_str());
     glWidget->setSceneGraph(pWrl,true);
     toolsWidget->updateState();
+  } else if(_loadCancel) {
+    snprintf(str,1024,"Cancelled loading \"%s\"",filename.c_str());
   } else {
-    snprintf(str,1024,"Unable to load \"%s\"",fname);
-    delete pWrl;
-    pWrl = (SceneGraph*)0;
+    snprintf(str,1024,"Unable to load \"%s\"",filename.c_str());
   }
   showStatusBarMessage(QString(str));
-  return pWrl;
+}
+
+//////////////////////////////////////////////////////////////////////
+void GuiMainWindow::updateLoadProgress() {
+  size_t nBytesRead  = _loadBytesRead;
+  size_t nBytesTotal = _loadBytesTotal;
+  if(nBytesTotal>0 && nBytesRead<=nBytesTotal)
+    _loadProgressBar->setValue(static_cast<int>((1000.0*nBytesRead)/nBytesTotal));
+}
+
+//////////////////////////////////////////////////////////////////////
+void GuiMainWindow::cancelLoad() {
+  _loadCancel = true;
+  _loadCancelButton->setEnabled(false);
+  showStatusBarMessage("Cancelling ...");
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -150,7 +242,7 @@ void GuiMainWindow::on_fileLoadAction_triggered() {
   QFileDialog fileDialog(this);
   fileDialog.setFileMode(QFileDialog::ExistingFile); // allowed to select only one 
   fileDialog.setAcceptMode(QFileDialog::AcceptOpen);
-  fileDialog.setNameFilter(tr("3D Files (*.wrl *.ply *.stl)"));
+  fileDialog.setNameFilter(tr("3D Files (*.wrl *.ply *.stl *.dgpb *.wrl.gz *.ply.gz *.stl.gz)"));
   QStringList fileNames;
   if(fileDialog.exec()) {
     fileNames = fileDialog.selectedFiles();
@@ -183,7 +275,7 @@ void GuiMainWindow::on_fileSaveAction_triggered() {
   // TODO Sat Sep 10 22:18:57 2016
   // get list of file extensions from registered Savers
 
-  fileDialog.setNameFilter(tr("3D Files (*.wrl *.ply *.stl)"));
+  fileDialog.setNameFilter(tr("3D Files (*.wrl *.ply *.stl *.dgpb *.wrl.gz *.ply.gz *.stl.gz)"));
   QStringList fileNames;
   if(fileDialog.exec()) {
     fileNames = fileDialog.selectedFiles();
@@ -40,6 +40,10 @@
 #include <QMainWindow>
 #include "ui_GuiMainWindow.h"
 #include <QTimer>
+#include <QProgressBar>
+#include <QPushButton>
+#include <atomic>
+#include <thread>
 // #include <QGridLayout>
 #include <io/AppLoader.hpp>
 #include <io/AppSaver.hpp>
@@ -68,7 +72,10 @@ public:
   GuiViewerData& getData() const;
   SceneGraph*    getSceneGraph();
   void           setSceneGraph(SceneGraph* pWrl, bool resetHomeView);
-  SceneGraph*    loadSceneGraph(const char* fname);
+  // loads the file in a worker thread, and replaces the scene graph
+  // once the file has been loaded; returns false if another file is
+  // still being loaded
+  bool           loadSceneGraph(const char* fname);
 
   void updateState();
   void refresh();
@@ -84,6 +91,8 @@ private slots:
   void on_toolsShowAction_triggered();
   void on_toolsHideAction_triggered();
   void on_helpAboutAction_triggered();
+  void updateLoadProgress();
+  void cancelLoad();
 
 protected:
 
@@ -91,10 +100,21 @@ protected:
 
 private:
 
+  void loadFinished(SceneGraph* pWrl, const std::string& filename);
+
   AppLoader       _loader;
   AppSaver        _saver;
   QTimer         *_timer;
 
+  // state of the file being loaded, shared with the worker thread
+  std::thread         _loadThread;
+  std::atomic<bool>   _loadCancel;
+  std::atomic<size_t> _loadBytesRead;
+  std::atomic<size_t> _loadBytesTotal;
+  QTimer             *_loadTimer;
+  QProgressBar       *_loadProgressBar;
+  QPushButton        *_loadCancelButton;
+
   static int      _timerInterval;
   static int      _lDPI;
   static QString  _platformName;
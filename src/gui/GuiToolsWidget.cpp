@@ -88,10 +88,12 @@ void GuiToolsWidget::updateState() {
 
   int   bboxDepth = data.getBBoxDepth();
   bool  bboxCube  = data.getBBoxCube();
+  bool  bboxOccupied = data.getBBoxOccupied();
   float bboxScale = data.getBBoxScale();
 
   spinBoxBBoxDepth->setValue(bboxDepth);
   checkBoxBBoxCube->setChecked(bboxCube);
+  checkBoxBBoxOccupied->setChecked(bboxOccupied);
   editBBoxScale->setText("  "+QString::number(bboxScale,'f',2));
 
   int N = 1<<bboxDepth;
@@ -122,6 +124,8 @@ void GuiToolsWidget::updateState() {
     pushButtonSceneGraphIndexedFaceSetsHide->setEnabled(false);
     pushButtonSceneGraphIndexedLineSetsShow->setEnabled(false);
     pushButtonSceneGraphIndexedLineSetsHide->setEnabled(false);
+    pushButtonSceneGraphReorderVertices->setEnabled(false);
+    pushButtonSceneGraphReorderTriangles->setEnabled(false);
 
     pushButtonPointsRemove->setEnabled(false);
     pushButtonPointsShow->setEnabled(false);
@@ -164,6 +168,9 @@ void GuiToolsWidget::updateState() {
     value = processor.hasIndexedLineSetHidden();
     pushButtonSceneGraphIndexedLineSetsShow->setEnabled(value);
 
+    pushButtonSceneGraphReorderVertices->setEnabled(hasFaces);
+    pushButtonSceneGraphReorderTriangles->setEnabled(hasFaces);
+
     Node* points = wrl->find("POINTS"); // should be a Shape node
     bool  hasPoints = (points!=(Node*)0 && points->isShape());
     if(hasPoints) {
@@ -259,7 +266,8 @@ void GuiToolsWidget::bboxSetDepth(int depth) {
     if(processor.hasBBox()) {
       float scale = data.getBBoxScale();
       bool  cube  = data.getBBoxCube();
-      processor.bboxAdd(newDepth,scale,cube);
+      bool  occupied = data.getBBoxOccupied();
+      processor.bboxAdd(newDepth,scale,cube,occupied);
       _mainWindow->setSceneGraph(pWrl,false);
       _mainWindow->refresh();
     }
@@ -289,7 +297,8 @@ void GuiToolsWidget::on_spinBoxBBoxDepth_valueChanged(int depth) {
     if(processor.hasBBox()) {
       float scale = data.getBBoxScale();
       bool  cube  = data.getBBoxCube();
-      processor.bboxAdd(newDepth,scale,cube);
+      bool  occupied = data.getBBoxOccupied();
+      processor.bboxAdd(newDepth,scale,cube,occupied);
       _mainWindow->setSceneGraph(pWrl,false);
       _mainWindow->refresh();
       updateState();
@@ -305,7 +314,8 @@ void GuiToolsWidget::on_pushButtonBBoxAdd_clicked() {
   data.setBBoxDepth(depth);
   float scale = data.getBBoxScale();
   bool  cube  = data.getBBoxCube();
-  processor.bboxAdd(depth,scale,cube);
+  bool  occupied = data.getBBoxOccupied();
+  processor.bboxAdd(depth,scale,cube,occupied);
   _mainWindow->setSceneGraph(pWrl,false);
   _mainWindow->refresh();
   updateState();
@@ -335,7 +345,8 @@ void GuiToolsWidget::on_editBBoxScale_returnPressed() {
       int   depth = data.getBBoxDepth();
       float scale = data.getBBoxScale();
       bool  cube  = data.getBBoxCube();
-      processor.bboxAdd(depth,scale,cube);
+      bool  occupied = data.getBBoxOccupied();
+      processor.bboxAdd(depth,scale,cube,occupied);
       _mainWindow->setSceneGraph(data.getSceneGraph(),false);
       _mainWindow->refresh();
       updateState();
@@ -351,7 +362,24 @@ void GuiToolsWidget::on_checkBoxBBoxCube_stateChanged(int state) {
     int   depth = data.getBBoxDepth();
     float scale = data.getBBoxScale();
     bool  cube  = data.getBBoxCube();
-    processor.bboxAdd(depth,scale,cube);
+    bool  occupied = data.getBBoxOccupied();
+    processor.bboxAdd(depth,scale,cube,occupied);
+    _mainWindow->setSceneGraph(data.getSceneGraph(),false);
+    _mainWindow->refresh();
+    updateState();
+  }
+}
+
+void GuiToolsWidget::on_checkBoxBBoxOccupied_stateChanged(int state) {
+  GuiViewerData& data = _mainWindow->getData();
+  data.setBBoxOccupied((state!=0));
+  SceneGraphProcessor processor(*(data.getSceneGraph()));
+  if(processor.hasBBox()) {
+    int   depth = data.getBBoxDepth();
+    float scale = data.getBBoxScale();
+    bool  cube  = data.getBBoxCube();
+    bool  occupied = data.getBBoxOccupied();
+    processor.bboxAdd(depth,scale,cube,occupied);
     _mainWindow->setSceneGraph(data.getSceneGraph(),false);
     _mainWindow->refresh();
     updateState();
@@ -554,6 +582,34 @@ void GuiToolsWidget::on_pushButtonSceneGraphIndexedLineSetsHide_clicked() {
   }
 }
 
+void GuiToolsWidget::on_pushButtonSceneGraphReorderVertices_clicked() {
+  GuiViewerData& data = _mainWindow->getData();
+  SceneGraph*    pWrl = data.getSceneGraph();
+  if(pWrl!=(SceneGraph*)0) {
+    SceneGraphProcessor processor(*pWrl);
+    processor.vertexReorder();
+    _mainWindow->setSceneGraph(pWrl,false);
+    _mainWindow->refresh();
+    updateState();
+  }
+}
+
+void GuiToolsWidget::on_pushButtonSceneGraphReorderTriangles_clicked() {
+  GuiViewerData& data = _mainWindow->getData();
+  SceneGraph*    pWrl = data.getSceneGraph();
+  if(pWrl!=(SceneGraph*)0) {
+    SceneGraphProcessor processor(*pWrl);
+    float acmr0 = processor.getAcmr();
+    processor.triangleReorder();
+    float acmr1 = processor.getAcmr();
+    _mainWindow->setSceneGraph(pWrl,false);
+    _mainWindow->refresh();
+    updateState();
+    _mainWindow->showStatusBarMessage
+      (QString("ACMR %1 -> %2").arg(acmr0,0,'f',3).arg(acmr1,0,'f',3));
+  }
+}
+
 void GuiToolsWidget::on_pushButtonSurfaceRemove_clicked() {
   GuiViewerData& data = _mainWindow->getData();
   SceneGraph*    pWrl = data.getSceneGraph();
@@ -80,6 +80,7 @@ private slots:
   void on_pushButtonBBoxRemove_clicked();
   void on_editBBoxScale_returnPressed();
   void on_checkBoxBBoxCube_stateChanged(int satate);
+  void on_checkBoxBBoxOccupied_stateChanged(int state);
 
   // scene graph
   void on_pushButtonSceneGraphNormalNone_clicked();
@@ -91,6 +92,8 @@ private slots:
   void on_pushButtonSceneGraphIndexedFaceSetsHide_clicked();
   void on_pushButtonSceneGraphIndexedLineSetsShow_clicked();
   void on_pushButtonSceneGraphIndexedLineSetsHide_clicked();
+  void on_pushButtonSceneGraphReorderVertices_clicked();
+  void on_pushButtonSceneGraphReorderTriangles_clicked();
 
 
   // points
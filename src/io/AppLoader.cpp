@@ -33,27 +33,133 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AppLoader.hpp"
+#include "GzFile.hpp"
+#include "LoaderStl.hpp"
+#include "Dgpb.hpp"
+#include "util/Endian.hpp"
+#include <cstring>
 
 bool AppLoader::load(const char* filename, SceneGraph& wrl) {
   bool success = false;
   if(filename!=(const char*)0) {
-    // int n = (int)strlen(filename);
-    string f(filename);
-    int n = static_cast<int>(f.size());
-    int i;
-    for(i=n-1;i>=0;i--)
-      if(filename[i]=='.')
-        break;
-    if(i>=0) {
-      string ext(filename+i+1);
-      Loader* loader = _registry[ext];
-      if(loader!=(Loader*)0)
-        success = loader->load(filename,wrl);
+    // the content of the file decides the loader, since files are
+    // often mislabelled; the extension is used if it is not recognized
+    Loader* loader = _find(sniffExtension(filename));
+    if(loader==(Loader*)0)
+      loader = _findByName(filename);
+    if(loader!=(Loader*)0)
+      success = loader->load(filename,wrl);
+  }
+  return success;
+}
+
+bool AppLoader::load
+(const void* data, const size_t size, SceneGraph& wrl, const char* url) {
+  bool success = false;
+  if(data!=(const void*)0) {
+    // decompress once here, rather than once to sniff the format and
+    // again in the loader
+    vector<char> buffer;
+    if(GzFile::isCompressed(data,size)) {
+      if(GzFile::uncompress(data,size,buffer)==false)
+        return false;
+      return load(buffer.data(),buffer.size(),wrl,url);
     }
+    Loader* loader = _find(sniffExtension(data,size));
+    if(loader==(Loader*)0)
+      loader = _findByName(url);
+    if(loader!=(Loader*)0)
+      success = loader->load(data,size,wrl,url);
   }
   return success;
 }
 
+bool AppLoader::load(istream& istrm, SceneGraph& wrl, const char* url) {
+  vector<char> buffer;
+  char chunk[1<<16];
+  while(istrm.read(chunk,sizeof(chunk)) || istrm.gcount()>0)
+    buffer.insert(buffer.end(),chunk,chunk+istrm.gcount());
+  if(istrm.bad()) return false;
+  return load(buffer.data(),buffer.size(),wrl,url);
+}
+
+Loader* AppLoader::_find(const string& ext) {
+  map<string,Loader*>::iterator i = _registry.find(ext);
+  return (i!=_registry.end())?i->second:(Loader*)0;
+}
+
+Loader* AppLoader::_findByName(const char* filename) {
+  if(filename==(const char*)0) return (Loader*)0;
+  // dispatch "name.ext.gz" on ext; the file is decompressed by the
+  // loader
+  string f = GzFile::stripSuffix(filename);
+  int n = static_cast<int>(f.size());
+  int i;
+  for(i=n-1;i>=0;i--)
+    if(f[i]=='.')
+      break;
+  return (i>=0)?_find(string(f,i+1)):(Loader*)0;
+}
+
+// static
+string AppLoader::_sniffHeader(const char* header, const size_t n) {
+  string ext = "";
+  if(n>=4 && strncmp(header,"ply",3)==0 &&
+     (header[3]=='\n' || header[3]=='\r')) {
+    ext = "ply";
+  } else if(n>=5 && strncmp(header,"#VRML",5)==0) {
+    ext = "wrl";
+  } else if(n>=4 && memcmp(header,Dgpb::magic,4)==0) {
+    ext = "dgpb";
+  } else if(n>=5 && strncmp(header,"solid",5)==0) {
+    ext = "stl";
+  }
+  return ext;
+}
+
+// static
+string AppLoader::sniffExtension(const char* filename) {
+  string ext = "";
+  FILE* fp = GzFile::open(filename,"rb");
+  if(fp!=(FILE*)0) {
+    char header[8];
+    memset(header,0,8);
+    size_t n = fread(header,1,8,fp);
+    fclose(fp);
+    ext = _sniffHeader(header,n);
+    if(ext=="" && LoaderStl::hasBinarySize(filename))
+      ext = "stl";
+  }
+  return ext;
+}
+
+// static
+string AppLoader::sniffExtension(const void* data, const size_t size) {
+  string ext = "";
+  if(data!=(const void*)0) {
+    vector<char> buffer;
+    const char* header = static_cast<const char*>(data);
+    size_t      n      = size;
+    if(GzFile::isCompressed(data,size) &&
+       GzFile::uncompress(data,size,buffer)) {
+      header = buffer.data();
+      n      = buffer.size();
+    }
+    ext = _sniffHeader(header,n);
+    if(ext=="" && n>=84) {
+      // binary STL: 84 bytes plus 50 bytes per triangle
+      uint32_t nTriangles;
+      memcpy(&nTriangles,header+80,4);
+      if(Endian::isLittleEndianSystem()==false)
+        Endian::swapArray(&nTriangles,1,4);
+      if(static_cast<uint64_t>(n)==
+         84+50*static_cast<uint64_t>(nTriangles))
+        ext = "stl";
+    }
+  }
+  return ext;
+}
+
 void AppLoader::registerLoader(Loader* loader) {
   if(loader!=(Loader*)0) {
     string ext(loader->ext()); // constructed from const char*
@@ -61,3 +167,10 @@ void AppLoader::registerLoader(Loader* loader) {
     _registry.insert(ext_loader);
   }
 }
+
+void AppLoader::setProgress(const LoaderProgress::Function& function) {
+  map<string,Loader*>::iterator i;
+  for(i=_registry.begin();i!=_registry.end();i++)
+    if(i->second!=(Loader*)0)
+      i->second->setProgress(function);
+}
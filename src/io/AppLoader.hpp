@@ -49,10 +49,28 @@ public:
   ~AppLoader() {}
 
   bool load(const char* filename, SceneGraph& wrl);
+  // the extension of url is used if the format of the data is not
+  // recognized
+  bool load(const void* data, const size_t size, SceneGraph& wrl,
+            const char* url="");
+  bool load(istream& istrm, SceneGraph& wrl, const char* url="");
   void registerLoader(Loader* loader);
 
+  // extension of the format of the file judging from its first bytes,
+  // decompressed if the file is compressed; "" if not recognized
+  static string sniffExtension(const char* filename);
+  static string sniffExtension(const void* data, const size_t size);
+
+  // sets the progress function of all the registered loaders
+  void setProgress(const LoaderProgress::Function& function);
+
 private:
 
+  Loader* _find(const string& ext);
+  Loader* _findByName(const char* filename);
+
+  static string _sniffHeader(const char* header, const size_t n);
+
   map<string, Loader*> _registry;
 
 };
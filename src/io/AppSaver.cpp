@@ -33,25 +33,42 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AppSaver.hpp"
+#include "GzFile.hpp"
 
 bool AppSaver::save(const char* filename, SceneGraph& wrl) {
   bool success = false;
+  Saver* saver = _findByName(filename);
+  if(saver!=(Saver*)0)
+    success = saver->save(filename,wrl);
+  return success;
+}
+
+bool AppSaver::save(vector<char>& buffer, SceneGraph& wrl, const char* url) {
+  bool success = false;
+  Saver* saver = _findByName(url);
+  if(saver!=(Saver*)0)
+    success = saver->save(buffer,wrl,url);
+  return success;
+}
+
+Saver* AppSaver::_findByName(const char* filename) {
+  Saver* saver = (Saver*)0;
   if(filename!=(const char*)0) {
-    // int n = (int)strlen(filename);
-    string f(filename);
+    // dispatch "name.ext.gz" on ext; the file is compressed or
+    // decompressed by the saver
+    string f = GzFile::stripSuffix(filename);
     int n = static_cast<int>(f.size());
     int i;
     for(i=n-1;i>=0;i--)
-      if(filename[i]=='.')
+      if(f[i]=='.')
         break;
     if(i>=0) {
-      string ext(filename+i+1);
-      Saver* saver = _registry[ext];
-      if(saver!=(Saver*)0)
-        success = saver->save(filename,wrl);
+      map<string,Saver*>::iterator j = _registry.find(string(f,i+1));
+      if(j!=_registry.end())
+        saver = j->second;
     }
   }
-  return success;
+  return saver;
 }
 
 void AppSaver::registerSaver(Saver* saver) {
@@ -49,10 +49,14 @@ public:
   ~AppSaver() {}
 
   bool save(const char* filename, SceneGraph& wrl);
+  // the saver is chosen by the extension of url
+  bool save(vector<char>& buffer, SceneGraph& wrl, const char* url);
   void registerSaver(Saver* saver);
 
 private:
 
+  Saver* _findByName(const char* filename);
+
   map<string, Saver*> _registry;
 
 };
@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// Dgpb.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef DGPB_HPP
+#define DGPB_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+// Binary scene graph cache (".dgpb") written by SaverDgpb and read by
+// LoaderDgpb. The file starts with a 32 byte header
+//
+//   char     magic[4]    "DGPB"
+//   uint32_t version
+//   uint32_t byteOrder   0x01020304 in the byte order of the writer
+//   uint32_t reserved
+//   uint64_t fileSize
+//   uint64_t reserved
+//
+// followed by the SceneGraph record. Every node is written as a
+// record, depth first
+//
+//   uint32_t type        NodeType; NONE for a null node, with no fields
+//   string   name
+//   uint32_t show
+//   ...                  fields of the node type, in declaration order
+//   ...                  children, appearance, material, ... records
+//
+// Nodes are numbered in the order in which their records end. A node
+// shared by several parents is written once; the other parents refer
+// to it with a USE record, followed by the uint32_t number of the node.
+//
+// All the scalar fields are 4 bytes long. A string is a uint32_t
+// length followed by its characters, zero padded to a multiple of 4
+// bytes. An array of floats or ints is zero padded to an offset
+// multiple of 8, followed by a uint64_t number of values and by the
+// values themselves, so that the array data is aligned in a memory
+// mapped file and can be copied with a single memcpy().
+
+namespace Dgpb {
+
+  const char     magic[4]   = { 'D','G','P','B' };
+  const uint32_t version    = 2; // 2 : USE records
+  const uint32_t byteOrder  = 0x01020304;
+  const size_t   headerSize = 32;
+  const size_t   alignment  = 8;
+
+  enum NodeType : uint32_t {
+    NONE = 0,
+    SCENE_GRAPH,
+    GROUP,
+    TRANSFORM,
+    SHAPE,
+    APPEARANCE,
+    MATERIAL,
+    IMAGE_TEXTURE,
+    PIXEL_TEXTURE,
+    INDEXED_FACE_SET,
+    INDEXED_LINE_SET,
+    USE
+  };
+
+}
+
+#endif // DGPB_HPP
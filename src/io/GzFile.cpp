@@ -0,0 +1,301 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// GzFile.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "GzFile.hpp"
+#include <string.h>
+#include <limits.h>
+#include <map>
+#include <mutex>
+
+#ifndef _WIN32
+#include <zlib.h>
+#endif
+#ifdef __GLIBC__
+#include <stdio_ext.h>
+#endif
+
+// size of the zlib input and output buffers
+#define GZ_BUFFER_SIZE (1<<17)
+
+// level 1 keeps compressed saves close to the speed of uncompressed
+// ones; level 6 (the gzip default) makes VRML files 25% smaller, but
+// takes 4 times as long
+int GzFile::_level = 1;
+
+#ifndef _WIN32
+
+// compressed streams returned by open() which have not been closed yet
+static map<FILE*,gzFile> _gzFile;
+static mutex             _gzFileMutex;
+
+// stdio callbacks which forward the calls to the gzFile cookie
+
+static int _gzRead(void* cookie, char* buf, const size_t n) {
+  int nRead = gzread(static_cast<gzFile>(cookie),buf,
+                     static_cast<unsigned>((n<INT_MAX)?n:INT_MAX));
+  return (nRead<0)?-1:nRead;
+}
+
+static int _gzWrite(void* cookie, const char* buf, const size_t n) {
+  return gzwrite(static_cast<gzFile>(cookie),buf,
+                 static_cast<unsigned>((n<INT_MAX)?n:INT_MAX));
+}
+
+static long _gzSeek(void* cookie, const long offset, const int whence) {
+  return static_cast<long>(gzseek(static_cast<gzFile>(cookie),
+                                  static_cast<z_off_t>(offset),whence));
+}
+
+static int _gzClose(void* cookie) {
+  {
+    lock_guard<mutex> lock(_gzFileMutex);
+    for(auto i=_gzFile.begin();i!=_gzFile.end();i++)
+      if(i->second==cookie) { _gzFile.erase(i); break; }
+  }
+  return (gzclose(static_cast<gzFile>(cookie))==Z_OK)?0:EOF;
+}
+
+#if defined(__GLIBC__)
+
+static ssize_t _cookieRead(void* cookie, char* buf, size_t n) {
+  return _gzRead(cookie,buf,n);
+}
+
+static ssize_t _cookieWrite(void* cookie, const char* buf, size_t n) {
+  return _gzWrite(cookie,buf,n);
+}
+
+static int _cookieSeek(void* cookie, off64_t* offset, int whence) {
+  long pos = _gzSeek(cookie,static_cast<long>(*offset),whence);
+  if(pos<0) return -1;
+  *offset = pos;
+  return 0;
+}
+
+static FILE* _gzStream(gzFile gz, const bool writing) {
+  cookie_io_functions_t io;
+  io.read  = _cookieRead;
+  io.write = _cookieWrite;
+  io.seek  = _cookieSeek;
+  io.close = _gzClose;
+  FILE* fp = fopencookie(gz,(writing)?"w":"r",io);
+  // glibc locks cookie streams on every getc(), which triples the
+  // time spent in the tokenizer; each stream is used by one thread
+  if(fp!=nullptr) __fsetlocking(fp,FSETLOCKING_BYCALLER);
+  return fp;
+}
+
+#else /* BSD, macOS */
+
+static int _cookieRead(void* cookie, char* buf, int n) {
+  return _gzRead(cookie,buf,static_cast<size_t>(n));
+}
+
+static int _cookieWrite(void* cookie, const char* buf, int n) {
+  return _gzWrite(cookie,buf,static_cast<size_t>(n));
+}
+
+static fpos_t _cookieSeek(void* cookie, fpos_t offset, int whence) {
+  return static_cast<fpos_t>(_gzSeek(cookie,static_cast<long>(offset),whence));
+}
+
+static FILE* _gzStream(gzFile gz, const bool writing) {
+  return funopen(gz,
+                 (writing)?nullptr:_cookieRead,
+                 (writing)?_cookieWrite:nullptr,
+                 _cookieSeek,_gzClose);
+}
+
+#endif /* __GLIBC__ */
+
+#endif /* _WIN32 */
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool GzFile::isSupported() {
+#ifndef _WIN32
+  return true;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void GzFile::setCompressionLevel(const int level) {
+  _level = (level<1)?1:(level>9)?9:level;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+int GzFile::getCompressionLevel() {
+  return _level;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool GzFile::hasSuffix(const char* filename) {
+  if(filename==nullptr) return false;
+  size_t n = strlen(filename);
+  return (n>3 && strcmp(filename+n-3,".gz")==0);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+string GzFile::stripSuffix(const char* filename) {
+  if(filename==nullptr) return string();
+  string f(filename);
+  if(hasSuffix(filename)) f.resize(f.size()-3);
+  return f;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool GzFile::isCompressed(const char* filename) {
+  bool value = false;
+  FILE* fp = (filename!=nullptr)?fopen(filename,"rb"):nullptr;
+  if(fp!=nullptr) {
+    unsigned char magic[2];
+    value = (fread(magic,1,2,fp)==2 && magic[0]==0x1f && magic[1]==0x8b);
+    fclose(fp);
+  }
+  return value;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool GzFile::isCompressed(const void* data, const size_t size) {
+  const unsigned char* magic = static_cast<const unsigned char*>(data);
+  return (data!=nullptr && size>=2 && magic[0]==0x1f && magic[1]==0x8b);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool GzFile::uncompress
+(const void* data, const size_t size, vector<char>& buffer) {
+  buffer.clear();
+  if(isCompressed(data,size)==false) return false;
+#ifndef _WIN32
+  z_stream zs;
+  memset(&zs,0,sizeof(zs));
+  // 16 selects the gzip wrapper instead of the zlib one
+  if(inflateInit2(&zs,16+MAX_WBITS)!=Z_OK) return false;
+  const Bytef* in = static_cast<const Bytef*>(data);
+  size_t nIn = size;
+  buffer.resize((size<GZ_BUFFER_SIZE/4)?GZ_BUFFER_SIZE:4*size);
+  size_t nOut = 0;
+  int status = Z_OK;
+  while(status==Z_OK) {
+    if(nOut==buffer.size()) buffer.resize(2*buffer.size());
+    zs.next_in   = const_cast<Bytef*>(in);
+    zs.avail_in  = static_cast<uInt>((nIn<UINT_MAX)?nIn:UINT_MAX);
+    zs.next_out  = reinterpret_cast<Bytef*>(buffer.data()+nOut);
+    zs.avail_out = static_cast<uInt>((buffer.size()-nOut<UINT_MAX)?
+                                     buffer.size()-nOut:UINT_MAX);
+    uInt availIn  = zs.avail_in;
+    uInt availOut = zs.avail_out;
+    status = inflate(&zs,Z_NO_FLUSH);
+    in   += availIn-zs.avail_in;
+    nIn  -= availIn-zs.avail_in;
+    nOut += availOut-zs.avail_out;
+    // gzip files may hold several members, as gzread() does
+    if(status==Z_STREAM_END && isCompressed(in,nIn))
+      status = inflateReset(&zs);
+    else if(status==Z_BUF_ERROR && zs.avail_out==0)
+      status = Z_OK;
+  }
+  inflateEnd(&zs);
+  buffer.resize(nOut);
+  if(status!=Z_STREAM_END) buffer.clear();
+  return (status==Z_STREAM_END);
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+FILE* GzFile::open(const char* filename, const char* mode) {
+  if(filename==nullptr || mode==nullptr) return nullptr;
+  const bool writing = (mode[0]=='w' || mode[0]=='a');
+  const bool compressed =
+    (writing)?hasSuffix(filename):isCompressed(filename);
+  if(compressed==false)
+    return fopen(filename,mode);
+#ifndef _WIN32
+  char gzMode[4] = { 'r', 'b', '\0', '\0' };
+  if(writing) {
+    gzMode[0] = mode[0];
+    gzMode[2] = static_cast<char>('0'+_level);
+  }
+  gzFile gz = gzopen(filename,gzMode);
+  if(gz==nullptr) return nullptr;
+  gzbuffer(gz,GZ_BUFFER_SIZE);
+  FILE* fp = _gzStream(gz,writing);
+  if(fp==nullptr) {
+    gzclose(gz);
+    return nullptr;
+  }
+  lock_guard<mutex> lock(_gzFileMutex);
+  _gzFile[fp] = gz;
+  return fp;
+#else
+  return nullptr;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+size_t GzFile::tell(FILE* fp) {
+  if(fp==nullptr) return 0;
+#ifndef _WIN32
+  {
+    lock_guard<mutex> lock(_gzFileMutex);
+    auto i = _gzFile.find(fp);
+    if(i!=_gzFile.end()) {
+      z_off_t offset = gzoffset(i->second);
+      return (offset>0)?static_cast<size_t>(offset):0;
+    }
+  }
+#endif
+  long offset = ftell(fp);
+  return (offset>0)?static_cast<size_t>(offset):0;
+}
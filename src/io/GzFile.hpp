@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// GzFile.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef GZ_FILE_HPP
+#define GZ_FILE_HPP
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// fopen() replacement for the loaders and savers, which makes gzip
+// compressed files look like regular files. The returned FILE* is
+// read and written with the usual stdio functions, and closed with
+// fclose().
+//
+// Files opened for reading are decompressed on the fly if they start
+// with the gzip magic bytes, whatever their name is. Files opened for
+// writing are compressed on the fly if their name ends in ".gz".
+// Compressed streams only support forward seeks.
+
+class GzFile {
+
+public:
+
+  static FILE*  open(const char* filename, const char* mode);
+
+  // position in the file on disk; for compressed streams, the number
+  // of compressed bytes consumed or produced so far
+  static size_t tell(FILE* fp);
+
+  static bool   hasSuffix(const char* filename);
+  static string stripSuffix(const char* filename);
+  static bool   isCompressed(const char* filename);
+  static bool   isCompressed(const void* data, const size_t size);
+
+  // decompresses size bytes of gzip data into buffer; returns false if
+  // the data is not valid, or compressed files are not supported
+  static bool   uncompress(const void* data, const size_t size,
+                           vector<char>& buffer);
+
+  // true if compressed files can be opened on this platform
+  static bool   isSupported();
+
+  // zlib compression level of the files opened for writing, 1 to 9
+  static void   setCompressionLevel(const int level);
+  static int    getCompressionLevel();
+
+private:
+
+  static int    _level;
+
+};
+
+#endif /* GZ_FILE_HPP */
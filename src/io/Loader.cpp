@@ -0,0 +1,140 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:36:08 taubin>
+//------------------------------------------------------------------------
+//
+// Loader.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the Brown University nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL GABRIEL TAUBIN BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Loader.hpp"
+#include "GzFile.hpp"
+#include "MemoryFile.hpp"
+#include "StrException.hpp"
+#include <sys/stat.h>
+
+//////////////////////////////////////////////////////////////////////
+void LoaderProgress::start(const char* filename) {
+  struct stat st;
+  start((filename!=nullptr && stat(filename,&st)==0)?
+        static_cast<size_t>(st.st_size):0);
+}
+
+void LoaderProgress::start(const size_t nBytesTotal) {
+  _fp          = nullptr;
+  _nBytesTotal = nBytesTotal;
+  _nChecks     = 0;
+  report(0);
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderProgress::report() {
+  report(GzFile::tell(_fp));
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderProgress::report(const size_t nBytesRead) {
+  _nChecks = 0;
+  if(_function && _function(nBytesRead,_nBytesTotal)==false)
+    throw new StrException("load cancelled");
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderProgress::end() {
+  _fp = nullptr;
+  report(_nBytesTotal);
+}
+
+//////////////////////////////////////////////////////////////////////
+bool Loader::load(const char* filename, SceneGraph& wrl) {
+  bool success = false;
+  FILE* fp = (FILE*)0;
+  try {
+    if(filename==(char*)0) throw new StrException("filename==null");
+    fp = GzFile::open(filename,"rb");
+    if(fp==(FILE*)0) throw new StrException("unable to open file");
+    _progress.start(filename);
+    _progress.setFile(fp);
+    success = _load(fp,filename,wrl);
+    fclose(fp);
+    fp = (FILE*)0;
+    if(success) _progress.end();
+  } catch(StrException* e) {
+    if(fp!=(FILE*)0) fclose(fp);
+    fprintf(stderr,"Loader | ERROR | %s\n",e->what());
+    delete e;
+    wrl.clear();
+    wrl.setUrl("");
+    success = false;
+  }
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool Loader::load
+(const void* data, const size_t size, SceneGraph& wrl, const char* url) {
+  bool success = false;
+  FILE* fp = (FILE*)0;
+  try {
+    vector<char> buffer;
+    const void*  bytes  = data;
+    size_t       nBytes = size;
+    if(GzFile::isCompressed(data,size)) {
+      if(GzFile::uncompress(data,size,buffer)==false)
+        throw new StrException("unable to decompress data");
+      bytes  = buffer.data();
+      nBytes = buffer.size();
+    }
+    fp = MemoryFile::open(bytes,nBytes);
+    if(fp==(FILE*)0) throw new StrException("unable to open memory file");
+    _progress.start(nBytes);
+    _progress.setFile(fp);
+    success = _load(fp,(url!=(char*)0)?url:"",wrl);
+    fclose(fp);
+    fp = (FILE*)0;
+    if(success) _progress.end();
+  } catch(StrException* e) {
+    if(fp!=(FILE*)0) fclose(fp);
+    fprintf(stderr,"Loader | ERROR | %s\n",e->what());
+    delete e;
+    wrl.clear();
+    wrl.setUrl("");
+    success = false;
+  }
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool Loader::load(istream& istrm, SceneGraph& wrl, const char* url) {
+  vector<char> buffer;
+  char chunk[1<<16];
+  while(istrm.read(chunk,sizeof(chunk)) || istrm.gcount()>0)
+    buffer.insert(buffer.end(),chunk,chunk+istrm.gcount());
+  if(istrm.bad()) return false;
+  return load(buffer.data(),buffer.size(),wrl,url);
+}
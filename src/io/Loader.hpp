@@ -35,15 +35,93 @@
 #ifndef _Loader_hpp_
 #define _Loader_hpp_
 
+#include <stdio.h>
+#include <functional>
+#include <istream>
 #include <wrl/SceneGraph.hpp>
 
+using namespace std;
+
+// Reports the progress of a Loader::load() to the function set with
+// Loader::setProgress(), as the number of bytes of the file consumed
+// so far, and the size of the file. The function is called from the
+// thread running load(). If it returns false, the load is cancelled:
+// check() and report() throw a StrException, and load() returns
+// false.
+
+class LoaderProgress {
+
+public:
+
+  typedef function<bool(const size_t nBytesRead, const size_t nBytesTotal)>
+  Function;
+
+  // check() reports once every this many calls
+  static const int checkInterval = 1<<16;
+
+  LoaderProgress():
+    _function(nullptr),_fp(nullptr),_nBytesTotal(0),_nChecks(0) {
+  }
+
+  void setFunction(const Function& function) { _function = function; }
+
+  // called by load() when the file is opened
+  void start(const char* filename);
+  void start(const size_t nBytesTotal);
+  void setFile(FILE* fp) { _fp = fp; }
+
+  // called by load() for every value or record read
+  void check() {
+    if(_function && ++_nChecks>=checkInterval) report();
+  }
+
+  // reports the position of the file set with setFile()
+  void report();
+  void report(const size_t nBytesRead);
+
+  // called by load() once the file has been read
+  void end();
+
+private:
+
+  Function _function;
+  FILE*    _fp;
+  size_t   _nBytesTotal;
+  int      _nChecks;
+
+};
+
 class Loader {
 
 public:
 
-  virtual bool  load(const char* filename, SceneGraph& wrl) = 0;
+  virtual ~Loader() {}
+
+  // compressed files are decompressed while they are read
+  virtual bool  load(const char* filename, SceneGraph& wrl);
+
+  // loads size bytes held in memory, decompressing them first if
+  // compressed; the url of the scene graph is set to url
+  virtual bool  load(const void* data, const size_t size, SceneGraph& wrl,
+                     const char* url="");
+
+  // reads the stream to its end, and loads the bytes read
+  bool          load(istream& istrm, SceneGraph& wrl, const char* url="");
+
   virtual const char* ext() const = 0;
 
+  void setProgress(const LoaderProgress::Function& function) {
+    _progress.setFunction(function);
+  }
+
+protected:
+
+  // parses the file fp, open for binary reading at its start, and which
+  // may be seeked; the file is closed by the caller
+  virtual bool  _load(FILE* fp, const char* url, SceneGraph& wrl) = 0;
+
+  LoaderProgress _progress;
+
 };
 
 #endif // _Loader_hpp_
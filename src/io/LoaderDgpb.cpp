@@ -0,0 +1,484 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// LoaderDgpb.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "LoaderDgpb.hpp"
+#include "StrException.hpp"
+#include "Dgpb.hpp"
+#include "GzFile.hpp"
+#include "util/Endian.hpp"
+
+const char* LoaderDgpb::_ext = "dgpb";
+
+//////////////////////////////////////////////////////////////////////
+// returns a pointer to the next n bytes of the file
+const char* LoaderDgpb::_get(const size_t n) {
+  if(n>_size-_pos)
+    throw new StrException("unexpected end of file");
+  const char* p = _data+_pos;
+  _pos += n;
+  return p;
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_align(const size_t alignment) {
+  size_t n = _pos%alignment;
+  if(n>0) _get(alignment-n);
+}
+
+//////////////////////////////////////////////////////////////////////
+uint32_t LoaderDgpb::_getUInt() {
+  uint32_t value;
+  memcpy(&value,_get(4),4);
+  if(_swap) Endian::swapArray(&value,1,4);
+  return value;
+}
+
+//////////////////////////////////////////////////////////////////////
+uint64_t LoaderDgpb::_getULong() {
+  uint64_t value;
+  memcpy(&value,_get(8),8);
+  if(_swap) Endian::swapArray(&value,1,8);
+  return value;
+}
+
+//////////////////////////////////////////////////////////////////////
+float LoaderDgpb::_getFloat() {
+  float value;
+  memcpy(&value,_get(4),4);
+  if(_swap) Endian::swapArray(&value,1,4);
+  return value;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool LoaderDgpb::_getBool() {
+  return (_getUInt()!=0);
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_getVec3f(Vec3f& value) {
+  value.x = _getFloat();
+  value.y = _getFloat();
+  value.z = _getFloat();
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_getColor(Color& value) {
+  value.r = _getFloat();
+  value.g = _getFloat();
+  value.b = _getFloat();
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_getString(string& value) {
+  uint32_t n = _getUInt();
+  value.assign(_get(n),n);
+  _align(4);
+}
+
+//////////////////////////////////////////////////////////////////////
+// the array data is aligned to 8 bytes within the file, and the file
+// is mapped at a page boundary, so the values can be read in place
+template <class T>
+void LoaderDgpb::_getArray(vector<T>& value) {
+  _align(Dgpb::alignment);
+  uint64_t n = _getULong();
+  if(n>(_size-_pos)/sizeof(T))
+    throw new StrException("unexpected end of file");
+  const T* p = reinterpret_cast<const T*>(_get(n*sizeof(T)));
+  value.assign(p,p+n);
+  if(_swap && n>0)
+    Endian::swapArray(value.data(),n,sizeof(T));
+  _progress.report(_pos);
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadScene(SceneGraph& wrl) {
+  if(_getUInt()!=Dgpb::SCENE_GRAPH)
+    throw new StrException("first record is not a SceneGraph");
+  _loadNodeHeader(&wrl);
+  _loadGroupFields(&wrl);
+}
+
+//////////////////////////////////////////////////////////////////////
+// returns nullptr for a null record
+Node* LoaderDgpb::_loadNode() {
+  Node* node = nullptr;
+  uint32_t type = _getUInt();
+  uint32_t iNode;
+  switch(type) {
+  case Dgpb::NONE:             return nullptr;
+  case Dgpb::USE:
+    // only nodes with complete records can be shared, so that USE
+    // records cannot create cycles
+    iNode = _getUInt();
+    if(iNode>=_node.size())
+      throw new StrException("USE of an undefined node");
+    return _node[iNode];
+  case Dgpb::GROUP:            node = new (_arena) Group();          break;
+  case Dgpb::TRANSFORM:        node = new (_arena) Transform();      break;
+  case Dgpb::SHAPE:            node = new (_arena) Shape();          break;
+  case Dgpb::APPEARANCE:       node = new (_arena) Appearance();     break;
+  case Dgpb::MATERIAL:         node = new (_arena) Material();       break;
+  case Dgpb::IMAGE_TEXTURE:    node = new (_arena) ImageTexture();   break;
+  case Dgpb::PIXEL_TEXTURE:    node = new (_arena) PixelTexture();   break;
+  case Dgpb::INDEXED_FACE_SET: node = new (_arena) IndexedFaceSet(); break;
+  case Dgpb::INDEXED_LINE_SET: node = new (_arena) IndexedLineSet(); break;
+  default:
+    throw new StrException("unexpected node type");
+  }
+  try {
+    _loadNodeHeader(node);
+    switch(type) {
+    case Dgpb::GROUP:
+      _loadGroupFields((Group*)node);                  break;
+    case Dgpb::TRANSFORM:
+      _loadTransform((Transform*)node);                break;
+    case Dgpb::SHAPE:
+      _loadShape((Shape*)node);                        break;
+    case Dgpb::APPEARANCE:
+      _loadAppearance((Appearance*)node);              break;
+    case Dgpb::MATERIAL:
+      _loadMaterial((Material*)node);                  break;
+    case Dgpb::IMAGE_TEXTURE:
+      _loadImageTexture((ImageTexture*)node);          break;
+    case Dgpb::PIXEL_TEXTURE:
+      _loadPixelTexture((PixelTexture*)node);          break;
+    case Dgpb::INDEXED_FACE_SET:
+      _loadIndexedFaceSet((IndexedFaceSet*)node);      break;
+    case Dgpb::INDEXED_LINE_SET:
+      _loadIndexedLineSet((IndexedLineSet*)node);      break;
+    }
+  } catch(StrException* e) {
+    delete node;
+    throw e;
+  }
+  _node.push_back(node);
+  return node;
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadNodeHeader(Node* node) {
+  string name;
+  _getString(name);
+  node->setName(name);
+  node->setShow(_getBool());
+}
+
+//////////////////////////////////////////////////////////////////////
+// children are added as they are loaded, so that they are deleted
+// with the group if a later record fails to load
+void LoaderDgpb::_loadGroupFields(Group* group) {
+  Vec3f value;
+  _getVec3f(value);
+  group->setBBoxCenter(value);
+  _getVec3f(value);
+  group->setBBoxSize(value);
+  uint32_t nChildren = _getUInt();
+  for(uint32_t i=0;i<nChildren;i++) {
+    Node* child = _loadNode();
+    if(child!=nullptr)
+      group->addChild(child);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadTransform(Transform* transform) {
+  Vec3f    value;
+  float    angle;
+  Rotation rotation;
+  _getVec3f(value);
+  transform->setCenter(value);
+  _getVec3f(value);
+  angle = _getFloat();
+  rotation = Rotation(value,angle);
+  transform->setRotation(rotation);
+  _getVec3f(value);
+  transform->setScale(value);
+  _getVec3f(value);
+  angle = _getFloat();
+  rotation = Rotation(value,angle);
+  transform->setScaleOrientation(rotation);
+  _getVec3f(value);
+  transform->setTranslation(value);
+  _loadGroupFields(transform);
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadShape(Shape* shape) {
+  Node* appearance = _loadNode();
+  if(appearance!=nullptr)
+    shape->setAppearance(appearance);
+  Node* geometry = _loadNode();
+  if(geometry!=nullptr)
+    shape->setGeometry(geometry);
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadAppearance(Appearance* appearance) {
+  Node* material = _loadNode();
+  if(material!=nullptr)
+    appearance->setMaterial(material);
+  Node* texture = _loadNode();
+  if(texture!=nullptr)
+    appearance->setTexture(texture);
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadMaterial(Material* material) {
+  Color color;
+  material->setAmbientIntensity(_getFloat());
+  _getColor(color);
+  material->setDiffuseColor(color);
+  _getColor(color);
+  material->setEmissiveColor(color);
+  material->setShininess(_getFloat());
+  _getColor(color);
+  material->setSpecularColor(color);
+  material->setTransparency(_getFloat());
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadPixelTexture(PixelTexture* pixelTexture) {
+  pixelTexture->setRepeatS(_getBool());
+  pixelTexture->setRepeatT(_getBool());
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadImageTexture(ImageTexture* imageTexture) {
+  _loadPixelTexture(imageTexture);
+  uint32_t nUrl = _getUInt();
+  string url;
+  for(uint32_t i=0;i<nUrl;i++) {
+    _getString(url);
+    imageTexture->adToUrl(url);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadIndexedFaceSet(IndexedFaceSet* ifs) {
+  ifs->getCcw()         = _getBool();
+  ifs->getConvex()      = _getBool();
+  ifs->getCreaseangle() = _getFloat();
+  ifs->getSolid()       = _getBool();
+  ifs->setNormalPerVertex(_getBool());
+  ifs->setColorPerVertex(_getBool());
+  _getArray(ifs->getCoord());
+  _getArray(ifs->getCoordIndex());
+  _getArray(ifs->getNormal());
+  _getArray(ifs->getNormalIndex());
+  _getArray(ifs->getColor());
+  _getArray(ifs->getColorIndex());
+  _getArray(ifs->getTexCoord());
+  _getArray(ifs->getTexCoordIndex());
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_loadIndexedLineSet(IndexedLineSet* ils) {
+  ils->setColorPerVertex(_getBool());
+  _getArray(ils->getCoord());
+  _getArray(ils->getCoordIndex());
+  _getArray(ils->getColor());
+  _getArray(ils->getColorIndex());
+}
+
+//////////////////////////////////////////////////////////////////////
+void LoaderDgpb::_parse(SceneGraph& wrl) {
+  // header
+  if(_size<Dgpb::headerSize || memcmp(_data,Dgpb::magic,4)!=0)
+    throw new StrException("not a dgpb file");
+  uint32_t byteOrder;
+  memcpy(&byteOrder,_data+8,4);
+  if(byteOrder!=Dgpb::byteOrder) {
+    Endian::swapArray(&byteOrder,1,4);
+    if(byteOrder!=Dgpb::byteOrder)
+      throw new StrException("invalid byte order mark");
+    _swap = true;
+  }
+  _pos = 4;
+  uint32_t version = _getUInt();
+  if(version<1 || version>Dgpb::version)
+    throw new StrException("unsupported dgpb version");
+  _getUInt(); // byteOrder
+  _getUInt(); // reserved
+  if(_getULong()!=_size)
+    throw new StrException("file size does not match header");
+  _getULong(); // reserved
+
+  wrl.clear();
+  _arena = wrl.getArena();
+  _loadScene(wrl);
+}
+
+//////////////////////////////////////////////////////////////////////
+bool LoaderDgpb::load(const char* filename, SceneGraph& wrl) {
+  bool success = false;
+
+#ifdef _WIN32
+  vector<char> buffer;
+#else
+  int   fd  = -1;
+  void* map = MAP_FAILED;
+#endif
+  _data = nullptr;
+  _size = _pos = 0;
+  _swap = false;
+  _node.clear();
+
+  try {
+    if(filename==(char*)0) throw new StrException("filename==null");
+    if(GzFile::isCompressed(filename))
+      throw new StrException("compressed dgpb files are not supported");
+    _progress.start(filename);
+
+#ifdef _WIN32
+    // no mmap; read the whole file with a single fread()
+    FILE* fp = fopen(filename,"rb");
+    if(fp==(FILE*)0)
+      throw new StrException("unable to open file");
+    fseek(fp,0,SEEK_END);
+    long size = ftell(fp);
+    fseek(fp,0,SEEK_SET);
+    buffer.resize((size>0)?static_cast<size_t>(size):0);
+    size_t nRead = fread(buffer.data(),1,buffer.size(),fp);
+    fclose(fp);
+    if(nRead!=buffer.size())
+      throw new StrException("unable to read file");
+    _data = buffer.data();
+    _size = buffer.size();
+#else
+    fd = open(filename,O_RDONLY);
+    if(fd<0)
+      throw new StrException("unable to open file");
+    struct stat st;
+    if(fstat(fd,&st)!=0)
+      throw new StrException("unable to get file size");
+    _size = static_cast<size_t>(st.st_size);
+    if(_size<Dgpb::headerSize)
+      throw new StrException("not a dgpb file");
+    map = mmap(nullptr,_size,PROT_READ,MAP_PRIVATE,fd,0);
+    if(map==MAP_FAILED)
+      throw new StrException("unable to map file");
+    madvise(map,_size,MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(map);
+#endif
+
+    _parse(wrl);
+    wrl.setUrl(filename);
+    _progress.end();
+
+    success = true;
+
+  } catch(StrException* e) {
+
+    fprintf(stderr,"LoaderDgpb | ERROR | %s\n",e->what());
+    delete e;
+    wrl.clear();
+    wrl.setUrl("");
+
+  }
+
+#ifndef _WIN32
+  if(map!=MAP_FAILED) munmap(map,_size);
+  if(fd>=0) close(fd);
+#endif
+  _node.clear();
+  _arena = nullptr;
+  _data = nullptr;
+  _size = _pos = 0;
+
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool LoaderDgpb::load
+(const void* data, const size_t size, SceneGraph& wrl, const char* url) {
+  bool success = false;
+
+  // the data are parsed in place, as the mapped files are
+  _data = static_cast<const char*>(data);
+  _size = (data!=nullptr)?size:0;
+  _pos  = 0;
+  _swap = false;
+  _node.clear();
+
+  try {
+    _progress.start(_size);
+    _parse(wrl);
+    wrl.setUrl((url!=(char*)0)?url:"");
+    _progress.end();
+
+    success = true;
+
+  } catch(StrException* e) {
+
+    fprintf(stderr,"LoaderDgpb | ERROR | %s\n",e->what());
+    delete e;
+    wrl.clear();
+    wrl.setUrl("");
+
+  }
+
+  _node.clear();
+  _arena = nullptr;
+  _data = nullptr;
+  _size = _pos = 0;
+
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool LoaderDgpb::_load(FILE* fp, const char* url, SceneGraph& wrl) {
+  vector<char> buffer;
+  char chunk[1<<16];
+  size_t nRead;
+  while((nRead=fread(chunk,1,sizeof(chunk),fp))>0)
+    buffer.insert(buffer.end(),chunk,chunk+nRead);
+  return load(buffer.data(),buffer.size(),wrl,url);
+}
@@ -0,0 +1,124 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// LoaderDgpb.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _LOADER_DGPB_HPP_
+#define _LOADER_DGPB_HPP_
+
+#include "Loader.hpp"
+
+#include "wrl/Shape.hpp"
+#include "wrl/Appearance.hpp"
+#include "wrl/Material.hpp"
+#include "wrl/IndexedFaceSet.hpp"
+#include "wrl/IndexedLineSet.hpp"
+#include "wrl/ImageTexture.hpp"
+#include "wrl/Transform.hpp"
+
+// Loads the binary cache files written by SaverDgpb. The file is
+// memory mapped, and each array is copied into its node with a single
+// memcpy(). Files written on a host of the opposite byte order are
+// swapped after being copied. Nodes referred to by USE records are
+// shared by their parents.
+
+class LoaderDgpb : public Loader {
+
+private:
+
+  const static char* _ext;
+
+public:
+
+  LoaderDgpb()  {};
+  ~LoaderDgpb() {};
+
+  using Loader::load;
+  bool  load(const char* filename, SceneGraph& wrl);
+  bool  load(const void* data, const size_t size, SceneGraph& wrl,
+             const char* url="");
+  const char* ext() const { return _ext; }
+
+protected:
+
+  bool  _load(FILE* fp, const char* url, SceneGraph& wrl);
+
+private:
+
+  // the mapped file or memory buffer, and the offset of the next value to read
+  const char* _data = nullptr;
+  size_t      _size = 0;
+  size_t      _pos  = 0;
+  bool        _swap = false;
+
+  // nodes loaded so far, in the order in which their records end
+  vector<Node*> _node;
+
+  // where the nodes are allocated, see SceneGraph::getArena()
+  Arena*        _arena = nullptr;
+
+  const char* _get(const size_t n);
+  void        _align(const size_t alignment);
+  uint32_t    _getUInt();
+  uint64_t    _getULong();
+  float       _getFloat();
+  bool        _getBool();
+  void        _getVec3f(Vec3f& value);
+  void        _getColor(Color& value);
+  void        _getString(string& value);
+  template <class T>
+  void        _getArray(vector<T>& value);
+
+  void        _parse(SceneGraph& wrl);
+  void        _loadScene(SceneGraph& wrl);
+  Node*       _loadNode();
+  void        _loadNodeHeader(Node* node);
+  void        _loadGroupFields(Group* group);
+  void        _loadTransform(Transform* transform);
+  void        _loadShape(Shape* shape);
+  void        _loadAppearance(Appearance* appearance);
+  void        _loadMaterial(Material* material);
+  void        _loadPixelTexture(PixelTexture* pixelTexture);
+  void        _loadImageTexture(ImageTexture* imageTexture);
+  void        _loadIndexedFaceSet(IndexedFaceSet* ifs);
+  void        _loadIndexedLineSet(IndexedLineSet* ils);
+
+};
+
+#endif /* _LOADER_DGPB_HPP_ */
@@ -45,6 +45,7 @@
 using namespace std;
 
 #include "LoaderPly.hpp"
+#include "GzFile.hpp"
 #include "TokenizerFile.hpp"
 #include "TokenizerString.hpp"
 #include "StrException.hpp"
@@ -427,7 +428,8 @@ size_t LoaderPly::readHeader(FILE* fp, Ply& ply, const string indent) {
 
 //////////////////////////////////////////////////////////////////////
 // static
-size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
+size_t LoaderPly::readBinaryData
+(FILE* fp, Ply& ply, const string indent, LoaderProgress* progress) {
 
   (void)indent;
 
@@ -507,6 +509,7 @@ size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
 
       k0 = 0;
       for(iRecord=0;iRecord<nRecords;iRecord++) {
+        if(progress) progress->check();
         nBytesRecord = 0;
         for(iProperty=0;iProperty<nProperties;iProperty++) {
 
@@ -657,7 +660,8 @@ size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
 
 //////////////////////////////////////////////////////////////////////
 // static
-size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
+size_t LoaderPly::readAsciiData
+(FILE* fp, Ply& ply, const string indent, LoaderProgress* progress) {
 
   (void)indent;
 
@@ -703,6 +707,7 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
 
        k0 = 0;
        for(iRecord=0;iRecord<nRecords;iRecord++) {
+          if(progress) progress->check();
 
           // one record per line
           if(ftkn.getline()==false) {
@@ -790,24 +795,57 @@ size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
 
 //////////////////////////////////////////////////////////////////////
 // static
-bool LoaderPly::load(const char* filename, Ply & ply, const string indent) {
+bool LoaderPly::load
+(const char* filename, Ply & ply, const string indent,
+ LoaderProgress* progress) {
 
   bool success = false;
 
-  // APP->log(QString("%1LoaderPly::load() {").arg(indent.c_str()));
-  // APP->log(QString("%1  filename = ").arg(indent.c_str()));
-  // APP->log(QString("%1  \""+QString(filename)+"\"").arg(indent.c_str()));
-
   FILE* fp  = nullptr;
   ply.clear();
   try {
 
-    // open the file for ascii reading
     if(filename==nullptr)
       throw new StrException("no filename");
-    fp = fopen(filename,"r");
+    fp = GzFile::open(filename,"rb");
     if(fp==nullptr)
-      throw new StrException("unable to open file for ascii reading");
+      throw new StrException("unable to open file for reading");
+    if(progress) {
+      progress->start(filename);
+      progress->setFile(fp);
+    }
+
+    success = load(fp,ply,indent,progress);
+
+    fclose(fp);
+    fp = nullptr;
+    if(success && progress) progress->end();
+
+  } catch(StrException* e) { 
+
+    ply.clear();
+    if(fp) fclose(fp);
+    delete e;
+    success = false;
+  }
+
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool LoaderPly::load
+(FILE* fp, Ply & ply, const string indent, LoaderProgress* progress) {
+
+  bool success = false;
+
+  // APP->log(QString("%1LoaderPly::load() {").arg(indent.c_str()));
+
+  ply.clear();
+  try {
+
+    if(fp==nullptr)
+      throw new StrException("no file");
 
     size_t nBytesHeader = readHeader(fp,ply,indent+"  ");
 
@@ -819,46 +857,38 @@ bool LoaderPly::load(const char* filename, Ply & ply, const string indent) {
 
     if(ply.getDataType()==Ply::DataType::ASCII) {
       // continue reading ascii data from the same FileInputStream
-      nBytesData = readAsciiData(fp,ply,indent+"  ");
+      nBytesData = readAsciiData(fp,ply,indent+"  ",progress);
 
       // APP->log(QString("%1  nBytesData(ASCII) = %2")
       //          .arg(indent.c_str())
       //          .arg(nBytesData));
 
-      fclose(fp);
     } else /* if(ply.getDataType()==Ply::DataType::BINARY_LITTLE_ENDIAN ::
                  ply.getDataType()==Ply::DataType::BINARY_BIG_ENDIAN) */ {
 
-      fclose(fp);
-      fp = fopen(filename,"rb");
-      if(fp==nullptr)
-        throw new StrException("unable to open file to read binary data");
-
       // skip header
       if(fseek(fp,static_cast<long>(nBytesHeader),SEEK_SET)!=0)
         throw new StrException("failed to skip header to read binary data");
 
-      nBytesData = readBinaryData(fp,ply,indent+"  ");
+      nBytesData = readBinaryData(fp,ply,indent+"  ",progress);
 
       // APP->log(QString("%1  nBytesData(BINARY) = %2")
       //          .arg(indent.c_str())
       //          .arg(nBytesData));
 
-      fclose(fp);
     }
     
     // APP->log(QString("%1  nBytesRead = %2")
     //          .arg(indent.c_str())
     //          .arg(nBytesHeader+nBytesData));
 
-    ply.logInfo(std::cout,indent+"  ");
+    if(Ply::getDebug()) ply.logInfo(std::cout,indent+"  ");
 
     success = true;
 
   } catch(StrException* e) { 
 
     ply.clear();
-    if(fp) fclose(fp);
     // APP->log(QString("%1  %2").arg(indent.c_str()).arg(e->what()));
     delete e;
   }
@@ -869,9 +899,9 @@ bool LoaderPly::load(const char* filename, Ply & ply, const string indent) {
 }
 
 //////////////////////////////////////////////////////////////////////
-bool LoaderPly::load
-(const char* filename, SceneGraph& wrl) {
-  (void) wrl;
+bool LoaderPly::_load
+(FILE* fp, const char* url, SceneGraph& wrl) {
+  (void) url;
 
   const string indent = "";
 
@@ -884,30 +914,32 @@ bool LoaderPly::load
 
     ply = new Ply();
 
-    if(load(filename,*ply,"  ")==false)
-      throw new StrException("load(const char*,Ply&)==false");
+    if(load(fp,*ply,"  ",&_progress)==false)
+      throw new StrException("load(FILE*,Ply&)==false");
 
     // insert into scene graph
 
-    Shape* s = new Shape();
+    Arena* arena = wrl.getArena();
+
+    Shape* s = new (arena) Shape();
     s->setName("POINTS");
 
-    Appearance* a = new Appearance();
+    Appearance* a = new (arena) Appearance();
     // a->setName(name);
     if(ply->getTextureFile()!="") {
-      ImageTexture* it = new ImageTexture();
+      ImageTexture* it = new (arena) ImageTexture();
       // it->setName(name);
       // TODO : set ImageTexture properties from _ply
       a->setTexture(it);
     } else {
-      Material* m = new Material();
+      Material* m = new (arena) Material();
       // m->setName(name);
       // TODO : set material properties from _ply
       a->setMaterial(m);
     }
     s->setAppearance(a);
 
-    IndexedFaceSetPly* ifsPly = new IndexedFaceSetPly(ply,"  ");
+    IndexedFaceSetPly* ifsPly = new (arena) IndexedFaceSetPly(ply,"  ");
     s->setGeometry(ifsPly);
 
     wrl.addChild(s);
@@ -58,10 +58,18 @@ public:
   LoaderPly()  {};
   ~LoaderPly() {};
 
-  bool  load(const char* filename, SceneGraph & wrl);
+  using Loader::load;
   const char* ext() const { return _ext; }
 
-  static bool load(const char* filename, Ply & ply, const string indent="");
+  static bool load(const char* filename, Ply & ply, const string indent="",
+                   LoaderProgress* progress=nullptr);
+  // fp is open for binary reading at the start of the file
+  static bool load(FILE* fp, Ply & ply, const string indent="",
+                   LoaderProgress* progress=nullptr);
+
+protected:
+
+  bool  _load(FILE* fp, const char* url, SceneGraph & wrl);
 
 private:
 
@@ -80,8 +88,10 @@ private:
    void* value);
   
   static size_t readHeader(FILE* fp, Ply& ply, const string indent="");
-  static size_t readBinaryData(FILE* fp, Ply& ply, const string indent="");
-  static size_t readAsciiData(FILE* fp, Ply& ply, const string indent="");
+  static size_t readBinaryData(FILE* fp, Ply& ply, const string indent="",
+                               LoaderProgress* progress=nullptr);
+  static size_t readAsciiData(FILE* fp, Ply& ply, const string indent="",
+                              LoaderProgress* progress=nullptr);
 
 };
 
@@ -44,8 +44,10 @@
 #include <cstdio>
 #include <cstring>
 #include "TokenizerFile.hpp"
+#include "GzFile.hpp"
 #include "LoaderStl.hpp"
 #include "StrException.hpp"
+#include "util/Endian.hpp"
 
 #include "wrl/Shape.hpp"
 #include "wrl/Appearance.hpp"
@@ -62,20 +64,21 @@ IndexedFaceSet* LoaderStl::_initializeSceneGraph
   // 0) clear the container
   wrl.clear();
   wrl.setUrl(filename);
+  Arena* arena = wrl.getArena();
   // 1) the SceneGraph should have a single Shape node a child
-  Shape* shape = new Shape();
+  Shape* shape = new (arena) Shape();
   wrl.addChild(shape);
   // 2) the Shape node should have an Appearance node in its appearance field
-  Appearance* appearance = new Appearance();
+  Appearance* appearance = new (arena) Appearance();
   shape->setAppearance(appearance);
   shape->setName("SURFACE");
   // 3) the Appearance node should have a Material node in its material field
-  Material* material = new Material();
+  Material* material = new (arena) Material();
   Color c(1.0,0.0,0.0); // RED
   material->setDiffuseColor(c);
   appearance->setMaterial(material);
   // 4) the Shape node should have an IndexedFaceSet node in its geometry node
-  IndexedFaceSet* ifs = new IndexedFaceSet();
+  IndexedFaceSet* ifs = new (arena) IndexedFaceSet();
   shape->setGeometry(ifs);
   // return the IndexedFaceSet pointer
   return ifs;
@@ -136,24 +139,51 @@ bool LoaderStl::_loadFacetBinary
   return true;
 }
 
-bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
+// static
+bool LoaderStl::hasBinarySize(const char* filename) {
+  // the size of a compressed file is not known without decompressing it
+  if(filename==nullptr || GzFile::isCompressed(filename)) return false;
+  bool value = false;
+  FILE* fp = fopen(filename,"rb");
+  if(fp!=nullptr) {
+    value = hasBinarySize(fp);
+    fclose(fp);
+  }
+  return value;
+}
+
+// static
+bool LoaderStl::hasBinarySize(FILE* fp) {
+  // seeking to the end fails on compressed streams; the position of fp
+  // is restored
+  bool value = false;
+  long pos = ftell(fp);
+  uint32_t nTriangles = 0;
+  if(pos>=0 && fseek(fp,80,SEEK_SET)==0 && fread(&nTriangles,1,4,fp)==4 &&
+     fseek(fp,0,SEEK_END)==0) {
+    if(Endian::isLittleEndianSystem()==false)
+      Endian::swapArray(&nTriangles,1,4);
+    long size = ftell(fp);
+    value = (size>0 &&
+             static_cast<uint64_t>(size)==84+50*static_cast<uint64_t>(nTriangles));
+  }
+  if(pos>=0 && fseek(fp,pos,SEEK_SET)!=0)
+    value = false;
+  return value;
+}
+
+bool LoaderStl::_load(FILE* fp, const char* url, SceneGraph& wrl) {
   bool success = false;
 
-  FILE* fp = (FILE*)0;
   try {
-    // open the file
-    if(filename==(char*)0) throw new StrException("filename==null");
-
     // allocate binary header and initialize to zero
     char header[80];
     memset(header,0x00,80);
     // determine if file is ascii or binary
-    fp = fopen(filename,"rb");
-    if(fp==(FILE*)0)
-      throw new StrException("unable to open file for binary read");
     if(fread(header,1,5,fp)<5)
       throw new StrException("unable to read first characters of file");
-    bool binary = (strncmp(header,"solid",5)!=0);
+    bool binary =
+      (strncmp(header,"solid",5)!=0 || hasBinarySize(fp));
     if(binary) {
       // read the rest of the header
       if(fread(header+5,1,75,fp)<75)
@@ -163,9 +193,12 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       if(fread(&nTriangles,1,4,fp)<4)
         throw new StrException("unable to read number of triangles");
 
-      IndexedFaceSet* ifs = _initializeSceneGraph(filename,wrl);
-      // get references to the coordIndex, coord, and normal arrays
-      vector<int>& coordIndex = ifs->getCoordIndex();
+      IndexedFaceSet* ifs = _initializeSceneGraph(url,wrl);
+      // get references to the coordIndex, coord, and normal arrays;
+      // the faces go straight into triangleIndex, without the -1's
+      const bool triangles = IndexedFaceSet::getDefaultTriangleIndex();
+      vector<int>& coordIndex =
+        (triangles)?ifs->getTriangleIndex():ifs->getCoordIndex();
       vector<float>& coord    = ifs->getCoord();
       vector<float>& normal   = ifs->getNormal();
       // 6) set the normalPerVertex variable to false (i.e., normals per face)  
@@ -176,6 +209,7 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       uint16_t abc; // attribute byte count
         for(iT=0;iT<nTriangles;iT++) {
         _loadFacetBinary(fp,n,v1,v2,v3,&abc);
+        _progress.check();
         normal.push_back(n[0]);
         normal.push_back(n[1]);
         normal.push_back(n[2]);
@@ -194,18 +228,15 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
         coordIndex.push_back(iV0);
         coordIndex.push_back(iV1);
         coordIndex.push_back(iV2);
-        coordIndex.push_back(-1);
+        if(triangles==false)
+          coordIndex.push_back(-1);
       }
-      
-      success = true;
 
-      fclose(fp);
+      success = true;
     } else /* if(ascii) */ {
-      // close the binary file and reopen it
-      fclose(fp);
-      fp = fopen(filename,"r");
-      if(fp==(FILE*)0)
-        throw new StrException("unable to open ASCII STL file");
+      // go back to the start of the file
+      if(fseek(fp,0,SEEK_SET)!=0)
+        throw new StrException("unable to rewind ASCII STL file");
         
       // use the io/TokenizerFile class to parse the input ascii file
       TokenizerFile tkn(fp);
@@ -218,9 +249,12 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       string stlName = tkn; // second token should be the solid name
 
       // create the scene graph structure :
-      IndexedFaceSet* ifs = _initializeSceneGraph(filename,wrl);
-      // get references to the coordIndex, coord, and normal arrays
-      vector<int>& coordIndex = ifs->getCoordIndex();
+      IndexedFaceSet* ifs = _initializeSceneGraph(url,wrl);
+      // get references to the coordIndex, coord, and normal arrays;
+      // the faces go straight into triangleIndex, without the -1's
+      const bool triangles = IndexedFaceSet::getDefaultTriangleIndex();
+      vector<int>& coordIndex =
+        (triangles)?ifs->getTriangleIndex():ifs->getCoordIndex();
       vector<float>& coord    = ifs->getCoord();
       vector<float>& normal   = ifs->getNormal();
       // set the normalPerVertex variable to false (i.e., normals per face)  
@@ -229,6 +263,7 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
       int   iV0,iV1,iV2;
       Vec3f n,v1,v2,v3;
       while(_loadFacetAscii(tkn,n,v1,v2,v3)) {
+        _progress.check();
         normal.push_back(n[0]);
         normal.push_back(n[1]);
         normal.push_back(n[2]);
@@ -247,18 +282,15 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
         coordIndex.push_back(iV0);
         coordIndex.push_back(iV1);
         coordIndex.push_back(iV2);
-        coordIndex.push_back(-1);
+        if(triangles==false)
+          coordIndex.push_back(-1);
       }
 
       success = true;
-
-      // close the file (this statement may not be reached)
-      fclose(fp);
     }
  
   } catch(StrException* e) { 
 
-    if(fp!=(FILE*)0) fclose(fp);
     fprintf(stderr,"LoaderStl | ERROR | %s\n",e->what());
     delete e;
     wrl.clear();
@@ -54,9 +54,18 @@ public:
   LoaderStl()  {};
   ~LoaderStl() {};
 
-  bool  load(const char* filename, SceneGraph& wrl);
   const char* ext() const { return _ext; }
 
+  // true if the size of the file is 84 bytes plus 50 bytes per
+  // triangle, for the triangle count stored at offset 80; binary files
+  // may start with "solid" as well as ascii files
+  static bool hasBinarySize(const char* filename);
+  static bool hasBinarySize(FILE* fp);
+
+protected:
+
+  bool  _load(FILE* fp, const char* url, SceneGraph& wrl);
+
 private:
 
   IndexedFaceSet* _initializeSceneGraph(const char* filename, SceneGraph& wrl);
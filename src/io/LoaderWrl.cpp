@@ -41,6 +41,23 @@
 
 const char* LoaderWrl::_ext = "wrl";
 
+// binds the name of the node, if any, to the node; a later DEF with
+// the same name replaces it
+void LoaderWrl::defNode(Node* node) {
+  const string& name = node->getName();
+  if(name!="") _defNode[name] = node;
+}
+
+// returns the node last defined with the name following USE; the node
+// is shared, rather than copied, by the parent it is added to
+Node* LoaderWrl::useNode(TokenizerFile& tkn) {
+  tkn.get("missing token after USE");
+  map<string,Node*>::iterator i = _defNode.find(tkn);
+  if(i==_defNode.end())
+    throw new StrException("USE of an undefined node name");
+  return i->second;
+}
+
 bool LoaderWrl::loadSceneGraph(TokenizerFile& tkn, SceneGraph& wrl) {
 
   string name    = "";
@@ -50,23 +67,31 @@ bool LoaderWrl::loadSceneGraph(TokenizerFile& tkn, SceneGraph& wrl) {
       tkn.get("missing token after DEF");
       name = tkn;
     } else if(tkn.equals("Group")) {
-      Group* g = new Group();
+      Group* g = new (_arena) Group();
       wrl.addChild(g);
       loadGroup(tkn,*g);
       g->setName(name);
+      defNode(g);
       name = "";
     } else if(tkn.equals("Transform")) {
-      Transform* t = new Transform();
+      Transform* t = new (_arena) Transform();
       wrl.addChild(t);
       loadTransform(tkn,*t);
       t->setName(name);
+      defNode(t);
       name = "";
     } else if(tkn.equals("Shape")) {
-      Shape* s = new Shape();
+      Shape* s = new (_arena) Shape();
       wrl.addChild(s);
       loadShape(tkn,*s);
       s->setName(name);
+      defNode(s);
       name = "";
+    } else if(tkn.equals("USE")) {
+      Node* node = useNode(tkn);
+      if(node->isGroup()==false && node->isShape()==false)
+        throw new StrException("USE of a node which is not a child node");
+      wrl.addChild(node);
     } else if(tkn.equals("")) {
       break;
     } else {
@@ -183,23 +208,31 @@ bool LoaderWrl::loadChildren(TokenizerFile& tkn, Group& group) {
       tkn.get("missing token after DEF");
       name = tkn;
     } else if(tkn.equals("Group")) {
-      Group* g = new Group();
+      Group* g = new (_arena) Group();
       group.addChild(g);
       loadGroup(tkn,*g);
       g->setName(name);
+      defNode(g);
       name = "";
     } else if(tkn.equals("Transform")) {
-      Transform* t = new Transform();
+      Transform* t = new (_arena) Transform();
       group.addChild(t);
       loadTransform(tkn,*t); 
       t->setName(name);
+      defNode(t);
       name = "";
    } else if(tkn.equals("Shape")) {
-      Shape* s = new Shape();
+      Shape* s = new (_arena) Shape();
       group.addChild(s);
       loadShape(tkn,*s);
       s->setName(name);
+      defNode(s);
       name = "";
+    } else if(tkn.equals("USE")) {
+      Node* node = useNode(tkn);
+      if(node->isGroup()==false && node->isShape()==false)
+        throw new StrException("USE of a node which is not a child node");
+      group.addChild(node);
     } else if(tkn.equals("]")) {
       success = true;
     } else {
@@ -216,15 +249,19 @@ bool LoaderWrl::loadShape(TokenizerFile& tkn, Shape& shape) {
   //   SFNode geometry   NULL
   // }
 
-  // TODO Mon Nov 12 10:22:28 2012
-  // implement DEF name for appearance and geometry nodes
-
   string name    = "";
   bool   success = false;
   if(tkn.expecting("{")==false) throw new StrException("expecting \"{\"");
   while(success==false && tkn.get()) {
     if(tkn.equals("appearance")) {
       tkn.get("expecting appearance node");
+      if(tkn.equals("USE")) {
+        Node* node = useNode(tkn);
+        if(node->isAppearance()==false)
+          throw new StrException("USE of a node which is not an Appearance");
+        shape.setAppearance(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
@@ -232,30 +269,40 @@ bool LoaderWrl::loadShape(TokenizerFile& tkn, Shape& shape) {
       }
       if(tkn.equals("Appearance")==false)
         throw new StrException("expecting Appearance");
-      Appearance* a = new Appearance();
+      Appearance* a = new (_arena) Appearance();
       a->setName(name);
       name = "";
       shape.setAppearance(a);
       loadAppearance(tkn,*a);
+      defNode(a);
     } else if(tkn.equals("geometry")) {
       tkn.get("expecting geometry node");
+      if(tkn.equals("USE")) {
+        Node* node = useNode(tkn);
+        if(node->isIndexedFaceSet()==false && node->isIndexedLineSet()==false)
+          throw new StrException("USE of a node which is not a geometry node");
+        shape.setGeometry(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
         tkn.get("missing Appearance token");
       }
       if(tkn.equals("IndexedFaceSet")) {
-        IndexedFaceSet* ifs = new IndexedFaceSet();
+        IndexedFaceSet* ifs = new (_arena) IndexedFaceSet();
         ifs->setName(name);
         name = "";
         shape.setGeometry(ifs);
         loadIndexedFaceSet(tkn,*ifs);
+        defNode(ifs);
       } else if(tkn.equals("IndexedLineSet")) {
-        IndexedLineSet* ils = new IndexedLineSet();
+        IndexedLineSet* ils = new (_arena) IndexedLineSet();
         ils->setName(name);
         name = "";
         shape.setGeometry(ils);
         loadIndexedLineSet(tkn,*ils);
+        defNode(ils);
       } else {
         throw new StrException("found unexpected geometry node");
       }
@@ -276,15 +323,19 @@ bool LoaderWrl::loadAppearance(TokenizerFile& tkn, Appearance& appearance) {
   //   // SFNode textureTransform NULL
   // }
 
-  // TODO Mon Nov 12 10:22:28 2012
-  // implement DEF name for matrial and texture nodes
-
   string name    = "";
   bool   success = false;
   if(tkn.expecting("{")==false) throw new StrException("expecting \"[\"");
   while(success==false && tkn.get()) {
     if(tkn.equals("material")) {
       tkn.get("expecting material node");
+      if(tkn.equals("USE")) {
+        Node* node = useNode(tkn);
+        if(node->isMaterial()==false)
+          throw new StrException("USE of a node which is not a Material");
+        appearance.setMaterial(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
@@ -292,24 +343,33 @@ bool LoaderWrl::loadAppearance(TokenizerFile& tkn, Appearance& appearance) {
       }
       if(tkn.equals("Material")==false)
         throw new StrException("expecting Material");
-      Material* m = new Material();
+      Material* m = new (_arena) Material();
       m->setName(name);
       name = "";
       appearance.setMaterial(m);
       loadMaterial(tkn,*m);
+      defNode(m);
     } else if(tkn.equals("texture")) {
       tkn.get("expecting Texture node");
+      if(tkn.equals("USE")) {
+        Node* node = useNode(tkn);
+        if(node->isPixelTexture()==false)
+          throw new StrException("USE of a node which is not a texture");
+        appearance.setTexture(node);
+        continue;
+      }
       if(tkn.equals("DEF")) {
         tkn.get("missing token after DEF");
         name = tkn;
         tkn.get("missing Appearance token");
       }
       if(tkn.equals("ImageTexture")) {
-        ImageTexture* it = new ImageTexture();
+        ImageTexture* it = new (_arena) ImageTexture();
         it->setName(name);
         name = "";
         appearance.setTexture(it);
         loadImageTexture(tkn,*it);
+        defNode(it);
    // } else if(tkn.equals("PixelTexture")) {
    //   ...
    // } else if(tkn.equals("MovieTexture")) {
@@ -643,6 +703,7 @@ bool LoaderWrl::loadVecFloat(TokenizerFile&tkn,vector<float>& vec) {
       success = true; // done
     } else if(sscanf(tkn.c_str(),"%f",&value)==1) {
       vec.push_back(value);
+      _progress.check();
     } else {
       throw new StrException("expecting int value");
     }
@@ -660,6 +721,7 @@ bool LoaderWrl::loadVecInt(TokenizerFile&tkn,vector<int>& vec) {
       success = true; // done
     } else if(sscanf(tkn.c_str(),"%d",&value)==1) {
       vec.push_back(value);
+      _progress.check();
     } else {
       throw new StrException("expecting int value");
     }
@@ -688,20 +750,16 @@ bool LoaderWrl::loadVecString(TokenizerFile&tkn,vector<string>& vec) {
   return success;
 }
 
-bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
+bool LoaderWrl::_load(FILE* fp, const char* url, SceneGraph& wrl) {
   bool success = false;
 
-  FILE* fp = (FILE*)0;
   try {
 
-    // open the file
-    if(filename==(char*)0) throw new StrException("filename==null");
-    fp = fopen(filename,"r");
-    if(fp==(FILE*)0) throw new StrException("fp==(FILE*)0");
-
     // clear the container
     wrl.clear();
-    wrl.setUrl(filename);
+    wrl.setUrl(url);
+    _defNode.clear();
+    _arena = wrl.getArena();
 
     // read and check header line
     char header[16];
@@ -718,14 +776,16 @@ bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
     // wrl.updateBBox();
     
     // if we have reached this point we have succeeded
-    fclose(fp);
     success = true;
+    _defNode.clear();
+    _arena = (Arena*)0;
 
   } catch(StrException* e) { 
 
-    if(fp!=(FILE*)0) fclose(fp);
     fprintf(stderr,"ERROR | %s\n",e->what());
     delete e;
+    _defNode.clear();
+    _arena = (Arena*)0;
     wrl.clear();
     wrl.setUrl("");
 
@@ -37,6 +37,7 @@
 
 #include "Loader.hpp"
 #include "TokenizerFile.hpp"
+#include <map>
 #include <wrl/Transform.hpp>
 #include <wrl/Shape.hpp>
 #include <wrl/Appearance.hpp>
@@ -51,16 +52,28 @@ private:
 
   const static char* _ext;
 
+  // nodes named with DEF in the file being loaded
+  map<string,Node*> _defNode;
+
+  // where the nodes are allocated, see SceneGraph::getArena()
+  Arena*            _arena;
+
 public:
 
-  LoaderWrl()  {};
+  LoaderWrl(): _arena((Arena*)0) {};
   ~LoaderWrl() {};
 
-  bool  load(const char* filename, SceneGraph& wrl);
   const char* ext() const { return _ext; }
 
+protected:
+
+  bool  _load(FILE* fp, const char* url, SceneGraph& wrl);
+
 private:
 
+  void  defNode(Node* node);
+  Node* useNode(TokenizerFile& tkn);
+
   bool loadSceneGraph(TokenizerFile& tkn, SceneGraph& wrl);
   bool loadGroup(TokenizerFile& tkn, Group& group);
   bool loadTransform(TokenizerFile& tkn, Transform& transform);
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// MemoryFile.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "MemoryFile.hpp"
+#include <string.h>
+
+#ifdef __GLIBC__
+#include <stdio_ext.h>
+#endif
+
+#ifndef _WIN32
+
+// the buffer written by a stream returned by open(vector<char>&), and
+// the position of the stream in it
+struct _MemoryFileBuffer {
+  vector<char>* data;
+  size_t        pos;
+};
+
+static int _memWrite(void* cookie, const char* buf, const size_t n) {
+  _MemoryFileBuffer* mb = static_cast<_MemoryFileBuffer*>(cookie);
+  vector<char>& data = *(mb->data);
+  if(mb->pos+n>data.size()) data.resize(mb->pos+n);
+  memcpy(data.data()+mb->pos,buf,n);
+  mb->pos += n;
+  return static_cast<int>(n);
+}
+
+static long _memSeek(void* cookie, const long offset, const int whence) {
+  _MemoryFileBuffer* mb = static_cast<_MemoryFileBuffer*>(cookie);
+  long pos =
+    (whence==SEEK_SET)?offset:
+    (whence==SEEK_CUR)?static_cast<long>(mb->pos)+offset:
+    (whence==SEEK_END)?static_cast<long>(mb->data->size())+offset:-1;
+  if(pos<0) return -1;
+  mb->pos = static_cast<size_t>(pos);
+  return pos;
+}
+
+static int _memClose(void* cookie) {
+  delete static_cast<_MemoryFileBuffer*>(cookie);
+  return 0;
+}
+
+#if defined(__GLIBC__)
+
+static ssize_t _cookieWrite(void* cookie, const char* buf, size_t n) {
+  return _memWrite(cookie,buf,n);
+}
+
+static int _cookieSeek(void* cookie, off64_t* offset, int whence) {
+  long pos = _memSeek(cookie,static_cast<long>(*offset),whence);
+  if(pos<0) return -1;
+  *offset = static_cast<off64_t>(pos);
+  return 0;
+}
+
+static FILE* _memStream(_MemoryFileBuffer* mb) {
+  cookie_io_functions_t io;
+  io.read  = nullptr;
+  io.write = _cookieWrite;
+  io.seek  = _cookieSeek;
+  io.close = _memClose;
+  return fopencookie(mb,"w",io);
+}
+
+#else /* BSD, macOS */
+
+static int _cookieWrite(void* cookie, const char* buf, int n) {
+  return _memWrite(cookie,buf,static_cast<size_t>(n));
+}
+
+static fpos_t _cookieSeek(void* cookie, fpos_t offset, int whence) {
+  return static_cast<fpos_t>(_memSeek(cookie,static_cast<long>(offset),whence));
+}
+
+static FILE* _memStream(_MemoryFileBuffer* mb) {
+  return funopen(mb,nullptr,_cookieWrite,_cookieSeek,_memClose);
+}
+
+#endif /* __GLIBC__ */
+
+#endif /* _WIN32 */
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool MemoryFile::isSupported() {
+#ifndef _WIN32
+  return true;
+#else
+  return false;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+FILE* MemoryFile::open(const void* data, const size_t size) {
+  // fmemopen() fails on empty buffers
+  if(data==nullptr || size==0) return nullptr;
+#ifndef _WIN32
+  FILE* fp = fmemopen(const_cast<void*>(data),size,"rb");
+#ifdef __GLIBC__
+  // as for compressed streams, skip the lock taken on every getc()
+  if(fp!=nullptr) __fsetlocking(fp,FSETLOCKING_BYCALLER);
+#endif
+  return fp;
+#else
+  return nullptr;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+FILE* MemoryFile::open(vector<char>& buffer) {
+  buffer.clear();
+#ifndef _WIN32
+  _MemoryFileBuffer* mb = new _MemoryFileBuffer();
+  mb->data = &buffer;
+  mb->pos  = 0;
+  FILE* fp = _memStream(mb);
+  if(fp==nullptr) {
+    delete mb;
+    return nullptr;
+  }
+#ifdef __GLIBC__
+  __fsetlocking(fp,FSETLOCKING_BYCALLER);
+#endif
+  return fp;
+#else
+  return nullptr;
+#endif
+}
@@ -0,0 +1,255 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// OutputBuffer.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "OutputBuffer.hpp"
+#include <util/Endian.hpp>
+#include <util/ThreadPool.hpp>
+#include <charconv>
+#include <thread>
+#include <stdarg.h>
+
+// longest "%f" of a double, plus sign and decimal point
+#define MAX_FIXED_DIGITS 312
+
+// putParallel() formats arrays shorter than this in the calling thread
+#define MIN_PARALLEL_ITEMS (1<<14)
+
+int OutputBuffer::_nThreads = 0;
+
+ThreadPool* OutputBuffer::_pool = (ThreadPool*)0;
+mutex       OutputBuffer::_poolMutex;
+
+//////////////////////////////////////////////////////////////////////
+OutputBuffer::OutputBuffer(FILE* fp, const size_t capacity):
+  _fp(fp),
+  _buffer((capacity>0)?capacity:defaultCapacity),
+  _size(0),
+  _bytesWritten(0),
+  _failed(false) {
+}
+
+//////////////////////////////////////////////////////////////////////
+OutputBuffer::~OutputBuffer() {
+  flush();
+}
+
+//////////////////////////////////////////////////////////////////////
+bool OutputBuffer::flush() {
+  if(_size>0 && _fp!=nullptr) {
+    if(_failed==false && fwrite(_buffer.data(),1,_size,_fp)!=_size)
+      _failed = true;
+    _bytesWritten += _size;
+    _size = 0;
+  }
+  return (_failed==false);
+}
+
+//////////////////////////////////////////////////////////////////////
+// called by reserve() when n bytes do not fit after the pending ones
+void OutputBuffer::_grow(const size_t n) {
+  if(_fp!=nullptr) {
+    flush();
+    // a single record larger than the whole buffer
+    if(n>_buffer.size()) _buffer.resize(n);
+  } else {
+    // memory buffer
+    size_t capacity = 2*_buffer.size();
+    if(capacity<_size+n) capacity = _size+n;
+    _buffer.resize(capacity);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void OutputBuffer::_write(const void* data, const size_t n) {
+  flush();
+  if(_failed==false && fwrite(data,1,n,_fp)!=n)
+    _failed = true;
+  _bytesWritten += n;
+}
+
+//////////////////////////////////////////////////////////////////////
+// right justifies the n characters at p in a field of width characters
+void OutputBuffer::_pad(char* p, const size_t n, const int width) {
+  size_t w = static_cast<size_t>(width);
+  if(n<w) {
+    memmove(p+w-n,p,n);
+    memset(p,' ',w-n);
+    _size += w;
+  } else {
+    _size += n;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void OutputBuffer::putInt(const int value, const int width) {
+  const size_t maxLength = 12;
+  char* p = reserve(maxLength+static_cast<size_t>((width>0)?width:0));
+  char* q = std::to_chars(p,p+maxLength,value).ptr;
+  _pad(p,static_cast<size_t>(q-p),width);
+}
+
+//////////////////////////////////////////////////////////////////////
+void OutputBuffer::putFloat
+(const float value, const int precision, const int width) {
+  if(precision>=0) {
+    putDouble(static_cast<double>(value),precision,width);
+  } else {
+    const size_t maxLength = 64;
+    char* p = reserve(maxLength+static_cast<size_t>((width>0)?width:0));
+    char* q = std::to_chars(p,p+maxLength,value).ptr;
+    _pad(p,static_cast<size_t>(q-p),width);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void OutputBuffer::putDouble
+(const double value, const int precision, const int width) {
+  if(precision>=0) {
+    const size_t maxLength = MAX_FIXED_DIGITS+static_cast<size_t>(precision);
+    char* p = reserve(maxLength+static_cast<size_t>((width>0)?width:0));
+    char* q = std::to_chars
+      (p,p+maxLength,value,std::chars_format::fixed,precision).ptr;
+    _pad(p,static_cast<size_t>(q-p),width);
+  } else {
+    const size_t maxLength = 64;
+    char* p = reserve(maxLength+static_cast<size_t>((width>0)?width:0));
+    char* q = std::to_chars(p,p+maxLength,value).ptr;
+    _pad(p,static_cast<size_t>(q-p),width);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void OutputBuffer::printf(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap,fmt);
+  int n = vsnprintf(nullptr,0,fmt,ap);
+  va_end(ap);
+  if(n>0) {
+    char* p = reserve(static_cast<size_t>(n)+1);
+    va_start(ap,fmt);
+    vsnprintf(p,static_cast<size_t>(n)+1,fmt,ap);
+    va_end(ap);
+    _size += static_cast<size_t>(n);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void OutputBuffer::setNumberOfThreads(const int nThreads) {
+  _nThreads = (nThreads>0)?nThreads:0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+int OutputBuffer::getNumberOfThreads() {
+  int nThreads = _nThreads;
+  if(nThreads==0) nThreads = static_cast<int>(thread::hardware_concurrency());
+  return (nThreads>0)?nThreads:1;
+}
+
+//////////////////////////////////////////////////////////////////////
+void OutputBuffer::putParallel
+(const int nItems,
+ const function<void(OutputBuffer& ob, const int i0, const int i1)>& format,
+ const function<void(const int i1)>& progress) {
+
+  if(nItems<=0) return;
+
+  int nThreads = getNumberOfThreads();
+  if(nThreads>1 && nItems<MIN_PARALLEL_ITEMS) nThreads = 1;
+
+  unique_lock<mutex> lock(_poolMutex,defer_lock);
+  if(nThreads>1 && lock.try_lock()==false) nThreads = 1;
+
+  // about four rounds of nThreads chunks each, to bound the memory
+  // used by the chunk buffers, and to report progress
+  int chunkSize = (nItems+4*nThreads-1)/(4*nThreads);
+  if(chunkSize<MIN_PARALLEL_ITEMS/4) chunkSize = MIN_PARALLEL_ITEMS/4;
+
+  int i0,i1;
+
+  if(nThreads==1) {
+    for(i0=0;i0<nItems;i0=i1) {
+      i1 = (nItems-i0>chunkSize)?i0+chunkSize:nItems;
+      format(*this,i0,i1);
+      if(progress) progress(i1);
+    }
+    return;
+  }
+
+  if(_pool!=(ThreadPool*)0 && _pool->getNumberOfThreads()!=nThreads) {
+    delete _pool;
+    _pool = (ThreadPool*)0;
+  }
+  if(_pool==(ThreadPool*)0) _pool = new ThreadPool(nThreads);
+
+  vector<OutputBuffer> chunk(static_cast<size_t>(nThreads));
+  for(i0=0;i0<nItems;i0=i1) {
+
+    const int j0 = i0;
+    const int nChunks =
+      static_cast<int>((nItems-i0+(long long)chunkSize-1)/chunkSize);
+    const int nRound = (nChunks<nThreads)?nChunks:nThreads;
+    i1 = (nItems-i0>(long long)nRound*chunkSize)?i0+nRound*chunkSize:nItems;
+
+    _pool->run(nRound,[&format,&chunk,j0,i1,chunkSize](int iChunk) {
+        const int k0 = j0+iChunk*chunkSize;
+        const int k1 = (i1-k0>chunkSize)?k0+chunkSize:i1;
+        OutputBuffer& ob = chunk[static_cast<size_t>(iChunk)];
+        ob.clear();
+        format(ob,k0,k1);
+      });
+
+    for(int iChunk=0;iChunk<nRound;iChunk++) {
+      const OutputBuffer& ob = chunk[static_cast<size_t>(iChunk)];
+      putBytes(ob.getData(),ob.getSize());
+    }
+
+    if(progress) progress(i1);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void OutputBuffer::_swap
+(char* p, const size_t nValues, const size_t valueSize) {
+  Endian::swapArray(p,nValues,static_cast<int>(valueSize));
+}
@@ -0,0 +1,184 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// OutputBuffer.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef OUTPUT_BUFFER_HPP
+#define OUTPUT_BUFFER_HPP
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+
+using namespace std;
+
+class ThreadPool;
+
+// Accumulates output bytes in a large memory buffer, and writes them
+// to the file with a single fwrite() call every time the buffer fills
+// up. Records are assembled directly in the buffer: reserve() returns
+// a pointer to n contiguous free bytes, which are appended to the
+// pending output by advance().
+//
+// Numbers are formatted directly into the buffer with std::to_chars.
+// putInt(i,w) writes the same characters as printf("%*d",w,i), and
+// putFloat(f,p,w) the same as printf("%*.*f",w,p,f). A negative
+// precision writes the shortest string which reads back as the same
+// float.
+//
+// An OutputBuffer constructed without a file keeps all the output in
+// memory. putParallel() uses such buffers to format consecutive
+// chunks of a large array on a shared ThreadPool, and then appends
+// them in order, so the output does not depend on the number of
+// threads.
+
+class OutputBuffer {
+
+public:
+
+  static const size_t defaultCapacity = 1<<20;
+
+  OutputBuffer(FILE* fp=nullptr, const size_t capacity=defaultCapacity);
+  ~OutputBuffer();
+
+  bool   flush();
+  void   clear() { _size = 0; }
+
+  const char* getData() const { return _buffer.data(); }
+  size_t      getSize() const { return _size; }
+
+  bool   failed() const { return _failed; }
+  size_t getBytesWritten() const { return _bytesWritten+_size; }
+
+  char*  reserve(const size_t n) {
+    if(_size+n>_buffer.size()) _grow(n);
+    return _buffer.data()+_size;
+  }
+
+  void   advance(const size_t n) {
+    _size += n;
+  }
+
+  // blocks at least as large as the buffer are written to the file
+  // directly, without being copied
+  void   putBytes(const void* data, const size_t n) {
+    if(_fp!=nullptr && n>=_buffer.size()) { _write(data,n); return; }
+    memcpy(reserve(n),data,n);
+    _size += n;
+  }
+
+  void   putChar(const char c) {
+    *reserve(1) = c;
+    _size += 1;
+  }
+
+  void   putString(const char* s) {
+    putBytes(s,strlen(s));
+  }
+
+  void   putString(const string& s) {
+    putBytes(s.data(),s.size());
+  }
+
+  void   putInt(const int value, const int width=0);
+  void   putFloat(const float value, const int precision=6, const int width=0);
+  void   putDouble(const double value, const int precision=6, const int width=0);
+
+  // same as fprintf(), for the short lines between the number arrays
+  void   printf(const char* fmt, ...);
+
+  // Appends the output of format(ob,i0,i1) for consecutive ranges
+  // [i0,i1) covering [0,nItems). The ranges are formatted in parallel
+  // into per thread buffers; format() must write the same characters
+  // for any partition of [0,nItems), and must not throw. If not null,
+  // progress(i1) is called from the calling thread every time the
+  // output up to item i1 has been appended.
+  void   putParallel
+  (const int nItems,
+   const function<void(OutputBuffer& ob, const int i0, const int i1)>& format,
+   const function<void(const int i1)>& progress=nullptr);
+
+  // 0 means one thread per hardware thread
+  static void setNumberOfThreads(const int nThreads);
+  static int  getNumberOfThreads();
+
+  // appends nValues binary values of sizeof(T) bytes each,
+  // swapping the bytes of each value if requested
+  template <class T>
+  void   putBinary(const T* values, const size_t nValues,
+                   const bool swapBytes) {
+    const size_t n = nValues*sizeof(T);
+    char* p = reserve(n);
+    memcpy(p,values,n);
+    if(swapBytes && sizeof(T)>1) _swap(p,nValues,sizeof(T));
+    _size += n;
+  }
+
+  template <class T>
+  void   putBinary(const T value, const bool swapBytes) {
+    putBinary(&value,1,swapBytes);
+  }
+
+private:
+
+  void   _grow(const size_t n);
+  void   _write(const void* data, const size_t n);
+  void   _pad(char* p, const size_t n, const int width);
+  static void _swap(char* p, const size_t nValues, const size_t valueSize);
+
+  static int   _nThreads;
+
+  // putParallel() runs on a pool shared by all the buffers, created on
+  // first use and again when the number of threads changes; a call
+  // made while another one holds the pool formats in the calling thread
+  static ThreadPool* _pool;
+  static mutex       _poolMutex;
+
+  FILE*        _fp;
+  vector<char> _buffer;
+  size_t       _size;
+  size_t       _bytesWritten;
+  bool         _failed;
+
+};
+
+#endif // OUTPUT_BUFFER_HPP
@@ -0,0 +1,64 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// Saver.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the Brown University nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL GABRIEL TAUBIN BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Saver.hpp"
+#include "GzFile.hpp"
+#include "MemoryFile.hpp"
+
+//////////////////////////////////////////////////////////////////////
+bool Saver::save(const char* filename, SceneGraph& wrl) const {
+  bool success = false;
+  if(filename!=(char*)0) {
+    FILE* fp = GzFile::open(filename,"wb");
+    if(fp!=(FILE*)0) {
+      success = _save(fp,filename,wrl);
+      if(fclose(fp)!=0) success = false;
+      if(success==false) remove(filename);
+    }
+  }
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool Saver::save
+(vector<char>& buffer, SceneGraph& wrl, const char* url) const {
+  bool success = false;
+  FILE* fp = MemoryFile::open(buffer);
+  if(fp!=(FILE*)0) {
+    success = _save(fp,(url!=(char*)0)?url:"",wrl);
+    if(fclose(fp)!=0) success = false;
+  }
+  if(success==false) buffer.clear();
+  return success;
+}
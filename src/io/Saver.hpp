@@ -35,15 +35,34 @@
 #ifndef _Saver_h_
 #define _Saver_h_
 
+#include <stdio.h>
+#include <vector>
 #include <wrl/SceneGraph.hpp>
 
 class Saver {
 
 public:
 
-  virtual bool  save(const char* filename, SceneGraph& wrl) const = 0;
+  virtual ~Saver() {}
+
+  // the file is compressed if filename ends in .gz; nothing is left on
+  // disk if the file cannot be written
+  virtual bool  save(const char* filename, SceneGraph& wrl) const;
+
+  // saves into buffer, which is resized to the number of bytes written;
+  // url takes the place of the filename in the formats which store it;
+  // the buffer is not compressed
+  virtual bool  save(vector<char>& buffer, SceneGraph& wrl,
+                     const char* url="") const;
+
   virtual const char* ext() const = 0;
 
+protected:
+
+  // writes the file to fp, open for binary writing; the file is closed
+  // by the caller
+  virtual bool  _save(FILE* fp, const char* url, SceneGraph& wrl) const = 0;
+
 };
 
 #endif /* _Saver_h_ */
@@ -0,0 +1,304 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// SaverDgpb.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "SaverDgpb.hpp"
+#include "Dgpb.hpp"
+#include "GzFile.hpp"
+
+const char* SaverDgpb::_ext = "dgpb";
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverDgpb::putUInt(OutputBuffer& ob, const uint32_t value) {
+  ob.putBinary(value,false);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverDgpb::putFloat(OutputBuffer& ob, const float value) {
+  ob.putBinary(value,false);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverDgpb::putVec3f(OutputBuffer& ob, const Vec3f& value) {
+  putFloat(ob,value.x);
+  putFloat(ob,value.y);
+  putFloat(ob,value.z);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverDgpb::putColor(OutputBuffer& ob, const Color& value) {
+  putFloat(ob,value.r);
+  putFloat(ob,value.g);
+  putFloat(ob,value.b);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverDgpb::putString(OutputBuffer& ob, const string& value) {
+  putUInt(ob,static_cast<uint32_t>(value.size()));
+  ob.putString(value);
+  putPadding(ob,4);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// zero pads the output to an offset multiple of alignment
+void SaverDgpb::putPadding(OutputBuffer& ob, const size_t alignment) {
+  size_t n = ob.getBytesWritten()%alignment;
+  if(n>0) {
+    n = alignment-n;
+    memset(ob.reserve(n),0x00,n);
+    ob.advance(n);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+template <class T>
+void SaverDgpb::putArray(OutputBuffer& ob, const vector<T>& value) {
+  putPadding(ob,Dgpb::alignment);
+  ob.putBinary(static_cast<uint64_t>(value.size()),false);
+  ob.putBytes(value.data(),value.size()*sizeof(T));
+}
+
+//////////////////////////////////////////////////////////////////////
+// writes a null record for node==nullptr, and for node types which
+// cannot be saved
+void SaverDgpb::saveNode(OutputBuffer& ob, Node* node) const {
+  if(node==nullptr) {
+    putUInt(ob,Dgpb::NONE);
+    return;
+  }
+  map<const Node*,uint32_t>::iterator i = _useIndex.find(node);
+  if(i!=_useIndex.end()) {
+    putUInt(ob,Dgpb::USE);
+    putUInt(ob,i->second);
+    return;
+  }
+  switch(node->getNodeType()) {
+  case Node::TRANSFORM:
+    saveTransform(ob,(Transform*)node);
+    break;
+  case Node::GROUP:
+  case Node::SCENE_GRAPH:
+    saveGroup(ob,(Group*)node);
+    break;
+  case Node::SHAPE:
+    saveShape(ob,(Shape*)node);
+    break;
+  case Node::APPEARANCE:
+    saveAppearance(ob,(Appearance*)node);
+    break;
+  case Node::MATERIAL:
+    saveMaterial(ob,(Material*)node);
+    break;
+  case Node::IMAGE_TEXTURE:
+    saveImageTexture(ob,(ImageTexture*)node);
+    break;
+  case Node::PIXEL_TEXTURE:
+    savePixelTexture(ob,(PixelTexture*)node);
+    break;
+  case Node::INDEXED_FACE_SET:
+    saveIndexedFaceSet(ob,(IndexedFaceSet*)node);
+    break;
+  case Node::INDEXED_LINE_SET:
+    saveIndexedLineSet(ob,(IndexedLineSet*)node);
+    break;
+  default:
+    putUInt(ob,Dgpb::NONE);
+    return;
+  }
+  if(node->getRefCount()>1)
+    _useIndex[node] = _nNodes;
+  _nNodes++;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverDgpb::putNodeHeader
+(OutputBuffer& ob, const uint32_t type, Node* node) {
+  putUInt(ob,type);
+  putString(ob,node->getName());
+  putUInt(ob,(node->getShow())?1:0);
+}
+
+//////////////////////////////////////////////////////////////////////
+// bounding box and children, shared by SceneGraph, Group and Transform
+void SaverDgpb::saveGroupFields(OutputBuffer& ob, Group* group) const {
+  putVec3f(ob,group->getBBoxCenter());
+  putVec3f(ob,group->getBBoxSize());
+  int nChildren = group->getNumberOfChildren();
+  putUInt(ob,static_cast<uint32_t>(nChildren));
+  for(int i=0;i<nChildren;i++)
+    saveNode(ob,(*group)[i]);
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveGroup(OutputBuffer& ob, Group* group) const {
+  uint32_t type = (group->isSceneGraph())?Dgpb::SCENE_GRAPH:Dgpb::GROUP;
+  putNodeHeader(ob,type,group);
+  saveGroupFields(ob,group);
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveTransform(OutputBuffer& ob, Transform* transform) const {
+  putNodeHeader(ob,Dgpb::TRANSFORM,transform);
+  putVec3f(ob,transform->getCenter());
+  putVec3f(ob,transform->getRotation().getAxis());
+  putFloat(ob,transform->getRotation().getAngle());
+  putVec3f(ob,transform->getScale());
+  putVec3f(ob,transform->getScaleOrientation().getAxis());
+  putFloat(ob,transform->getScaleOrientation().getAngle());
+  putVec3f(ob,transform->getTranslation());
+  saveGroupFields(ob,transform);
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveShape(OutputBuffer& ob, Shape* shape) const {
+  putNodeHeader(ob,Dgpb::SHAPE,shape);
+  saveNode(ob,shape->getAppearance());
+  saveNode(ob,shape->getGeometry());
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveAppearance
+(OutputBuffer& ob, Appearance* appearance) const {
+  putNodeHeader(ob,Dgpb::APPEARANCE,appearance);
+  saveNode(ob,appearance->getMaterial());
+  saveNode(ob,appearance->getTexture());
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveMaterial(OutputBuffer& ob, Material* material) const {
+  putNodeHeader(ob,Dgpb::MATERIAL,material);
+  putFloat(ob,material->getAmbientIntensity());
+  putColor(ob,material->getDiffuseColor());
+  putColor(ob,material->getEmissiveColor());
+  putFloat(ob,material->getShininess());
+  putColor(ob,material->getSpecularColor());
+  putFloat(ob,material->getTransparency());
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::savePixelTexture
+(OutputBuffer& ob, PixelTexture* pixelTexture) const {
+  putNodeHeader(ob,Dgpb::PIXEL_TEXTURE,pixelTexture);
+  putUInt(ob,(pixelTexture->getRepeatS())?1:0);
+  putUInt(ob,(pixelTexture->getRepeatT())?1:0);
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveImageTexture
+(OutputBuffer& ob, ImageTexture* imageTexture) const {
+  putNodeHeader(ob,Dgpb::IMAGE_TEXTURE,imageTexture);
+  putUInt(ob,(imageTexture->getRepeatS())?1:0);
+  putUInt(ob,(imageTexture->getRepeatT())?1:0);
+  vector<string>& url = imageTexture->getUrl();
+  putUInt(ob,static_cast<uint32_t>(url.size()));
+  for(const string& str : url)
+    putString(ob,str);
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveIndexedFaceSet
+(OutputBuffer& ob, IndexedFaceSet* ifs) const {
+  putNodeHeader(ob,Dgpb::INDEXED_FACE_SET,ifs);
+  putUInt(ob,(ifs->getCcw())?1:0);
+  putUInt(ob,(ifs->getConvex())?1:0);
+  putFloat(ob,ifs->getCreaseangle());
+  putUInt(ob,(ifs->getSolid())?1:0);
+  putUInt(ob,(ifs->getNormalPerVertex())?1:0);
+  putUInt(ob,(ifs->getColorPerVertex())?1:0);
+  vector<float> buffer;
+  putArray(ob,ifs->readCoord(buffer));
+  putArray(ob,ifs->getCoordIndex());
+  putArray(ob,ifs->readNormal(buffer));
+  putArray(ob,ifs->getNormalIndex());
+  putArray(ob,ifs->readColor(buffer));
+  putArray(ob,ifs->getColorIndex());
+  putArray(ob,ifs->getTexCoord());
+  putArray(ob,ifs->getTexCoordIndex());
+}
+
+//////////////////////////////////////////////////////////////////////
+void SaverDgpb::saveIndexedLineSet
+(OutputBuffer& ob, IndexedLineSet* ils) const {
+  putNodeHeader(ob,Dgpb::INDEXED_LINE_SET,ils);
+  putUInt(ob,(ils->getColorPerVertex())?1:0);
+  putArray(ob,ils->getCoord());
+  putArray(ob,ils->getCoordIndex());
+  putArray(ob,ils->getColor());
+  putArray(ob,ils->getColorIndex());
+}
+
+//////////////////////////////////////////////////////////////////////
+bool SaverDgpb::save(const char* filename, SceneGraph& wrl) const {
+  // the file size is patched into the header at the end, which cannot
+  // be done on a compressed stream
+  if(filename==(char*)0 || GzFile::hasSuffix(filename)) return false;
+  return Saver::save(filename,wrl);
+}
+
+//////////////////////////////////////////////////////////////////////
+bool SaverDgpb::_save(FILE* fp, const char* url, SceneGraph& wrl) const {
+  (void) url;
+  OutputBuffer ob(fp);
+  _useIndex.clear();
+  _nNodes = 0;
+  ob.putBytes(Dgpb::magic,4);
+  putUInt(ob,Dgpb::version);
+  putUInt(ob,Dgpb::byteOrder);
+  putUInt(ob,0);
+  // the file size is written once known
+  ob.putBinary(static_cast<uint64_t>(0),false);
+  ob.putBinary(static_cast<uint64_t>(0),false);
+  saveGroup(ob,&wrl);
+  bool success = ob.flush();
+  uint64_t fileSize = static_cast<uint64_t>(ob.getBytesWritten());
+  if(success &&
+     (fseek(fp,16,SEEK_SET)!=0 || fwrite(&fileSize,1,8,fp)!=8))
+    success = false;
+  _useIndex.clear();
+  return success;
+}
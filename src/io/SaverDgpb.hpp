@@ -0,0 +1,111 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:36:10 taubin>
+//------------------------------------------------------------------------
+//
+// SaverDgpb.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _SAVER_DGPB_HPP_
+#define _SAVER_DGPB_HPP_
+
+#include "Saver.hpp"
+#include "OutputBuffer.hpp"
+#include <map>
+#include <wrl/Shape.hpp>
+#include <wrl/Appearance.hpp>
+#include <wrl/Material.hpp>
+#include <wrl/IndexedFaceSet.hpp>
+#include <wrl/IndexedLineSet.hpp>
+#include <wrl/ImageTexture.hpp>
+#include <wrl/Transform.hpp>
+
+// Writes the scene graph as a binary cache file, in the format
+// described in Dgpb.hpp. IndexedFaceSetPly nodes are saved as
+// IndexedFaceSet nodes, and shared nodes are saved once.
+
+class SaverDgpb : public Saver {
+
+private:
+
+  const static char* _ext;
+
+  // numbers of the shared nodes written so far, and number of nodes
+  // written, while a file is being saved
+  mutable map<const Node*,uint32_t> _useIndex;
+  mutable uint32_t                  _nNodes = 0;
+
+public:
+
+  SaverDgpb()  {};
+  ~SaverDgpb() {};
+
+  using Saver::save;
+  bool  save(const char* filename, SceneGraph& wrl) const;
+  const char* ext() const { return _ext; }
+
+protected:
+
+  bool  _save(FILE* fp, const char* url, SceneGraph& wrl) const;
+
+private:
+
+  static void putUInt(OutputBuffer& ob, const uint32_t value);
+  static void putFloat(OutputBuffer& ob, const float value);
+  static void putVec3f(OutputBuffer& ob, const Vec3f& value);
+  static void putColor(OutputBuffer& ob, const Color& value);
+  static void putString(OutputBuffer& ob, const string& value);
+  static void putPadding(OutputBuffer& ob, const size_t alignment);
+  template <class T>
+  static void putArray(OutputBuffer& ob, const vector<T>& value);
+  static void putNodeHeader
+  (OutputBuffer& ob, const uint32_t type, Node* node);
+
+  void saveNode(OutputBuffer& ob, Node* node) const;
+  void saveGroupFields(OutputBuffer& ob, Group* group) const;
+  void saveGroup(OutputBuffer& ob, Group* group) const;
+  void saveTransform(OutputBuffer& ob, Transform* transform) const;
+  void saveShape(OutputBuffer& ob, Shape* shape) const;
+  void saveAppearance(OutputBuffer& ob, Appearance* appearance) const;
+  void saveMaterial(OutputBuffer& ob, Material* material) const;
+  void savePixelTexture(OutputBuffer& ob, PixelTexture* pixelTexture) const;
+  void saveImageTexture(OutputBuffer& ob, ImageTexture* imageTexture) const;
+  void saveIndexedFaceSet(OutputBuffer& ob, IndexedFaceSet* ifs) const;
+  void saveIndexedLineSet(OutputBuffer& ob, IndexedLineSet* ils) const;
+
+};
+
+#endif /* _SAVER_DGPB_HPP_ */
@@ -46,6 +46,7 @@
 #include <wrl/IndexedFaceSet.hpp>
 #include <wrl/IndexedFaceSetPly.hpp>
 #include <io/StrException.hpp>
+#include <io/GzFile.hpp>
 #include <util/Endian.hpp>
 #include <util/CastMacros.hpp>
 
@@ -55,6 +56,7 @@ using namespace std;
 const char*   SaverPly::_ext = "ply";
 Ply::DataType SaverPly::_defaultDataType = Ply::DataType::BINARY_LITTLE_ENDIAN;
 bool SaverPly::_skipAlpha = true;
+int  SaverPly::_floatPrecision = 6;
 ostream* SaverPly::_ostrm = nullptr;
 string SaverPly::_indent = "";
 
@@ -85,6 +87,18 @@ void SaverPly::setSkipAlpha(const bool value) {
   _skipAlpha = value;
 }
 
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverPly::setFloatPrecision(const int precision) {
+  _floatPrecision = precision;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+int SaverPly::getFloatPrecision() {
+  return _floatPrecision;
+}
+
 //////////////////////////////////////////////////////////////////////
 // static
 void SaverPly::setOstream(ostream* ostrm) {
@@ -115,251 +129,362 @@ bool SaverPly::sameAsSystemEndian(Ply::DataType fileEndian) {
 //////////////////////////////////////////////////////////////////////
 // static
 bool SaverPly::writeBinaryValue
-(FILE * fp, const Ply::Element::Property::Type listType,
+(OutputBuffer& ob, const Ply::Element::Property::Type listType,
  const bool swapBytes, int nList) {
-  bool success = false;
-  if(fp!=nullptr) {
-    Endian::SingleValueBuffer svb;
-    switch(listType) {
-    case Ply::Element::Property::Type::CHAR:
-    case Ply::Element::Property::Type::INT8:
-      svb.c[0] = static_cast<char>(nList);
-      success = (fwrite(&(svb.c[0]),1,1,fp)==1);
-      break;
-    case Ply::Element::Property::Type::UCHAR:
-    case Ply::Element::Property::Type::UINT8:
-      svb.uc[0] = static_cast<uchar>(nList);
-      success = (fwrite(&(svb.uc[0]),1,1,fp)==1);
-      break;
-    case Ply::Element::Property::Type::SHORT:
-    case Ply::Element::Property::Type::INT16:
-      svb.s[0] = static_cast<short>(nList);
-      if(swapBytes) Endian::swapShort(svb);
-      success = (fwrite(&(svb.s[0]),1,2,fp)==2);
-      break;
-    case Ply::Element::Property::Type::USHORT:
-    case Ply::Element::Property::Type::UINT16:
-      svb.us[0] = static_cast<ushort>(nList);
-      if(swapBytes) Endian::swapUShort(svb);
-      success = (fwrite(&(svb.us[0]),1,2,fp)==2);
-      break;
-    case Ply::Element::Property::Type::INT:
-    case Ply::Element::Property::Type::INT32:
-      svb.i[0] = static_cast<int>(nList);
-      if(swapBytes) Endian::swapInt(svb);
-      success = (fwrite(&(svb.i[0]),1,4,fp)==4);
-      break;
-    case Ply::Element::Property::Type::UINT:
-    case Ply::Element::Property::Type::UINT32:
-      svb.ui[0] = static_cast<uint>(nList);
-      if(swapBytes) Endian::swapUInt(svb);
-      success = (fwrite(&(svb.ui[0]),1,4,fp)==4);
-      break;
-    default:
-      break;
-    }
+  bool success = true;
+  switch(listType) {
+  case Ply::Element::Property::Type::CHAR:
+  case Ply::Element::Property::Type::INT8:
+    ob.putBinary(static_cast<char>(nList),swapBytes);
+    break;
+  case Ply::Element::Property::Type::UCHAR:
+  case Ply::Element::Property::Type::UINT8:
+    ob.putBinary(static_cast<uchar>(nList),swapBytes);
+    break;
+  case Ply::Element::Property::Type::SHORT:
+  case Ply::Element::Property::Type::INT16:
+    ob.putBinary(static_cast<short>(nList),swapBytes);
+    break;
+  case Ply::Element::Property::Type::USHORT:
+  case Ply::Element::Property::Type::UINT16:
+    ob.putBinary(static_cast<ushort>(nList),swapBytes);
+    break;
+  case Ply::Element::Property::Type::INT:
+  case Ply::Element::Property::Type::INT32:
+    ob.putBinary(static_cast<int>(nList),swapBytes);
+    break;
+  case Ply::Element::Property::Type::UINT:
+  case Ply::Element::Property::Type::UINT32:
+    ob.putBinary(static_cast<uint>(nList),swapBytes);
+    break;
+  default:
+    success = false;
+    break;
   }
   return success;
 }
 
 //////////////////////////////////////////////////////////////////////
 // static
+// writes nValues consecutive values starting at index, swapping the
+// bytes of all of them at once if needed
 bool SaverPly::writeBinaryValue
-(FILE * fp, const Ply::Element::Property::Type propertyType,
- const bool swapBytes, void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    Endian::SingleValueBuffer svb;
-    switch(propertyType) {
-    case Ply::Element::Property::Type::CHAR:
-    case Ply::Element::Property::Type::INT8:
-      {
-        svb.c[0] = (*static_cast<vector<char>*>(value))[UL(index)];
-        success = (fwrite(&(svb.c[0]),1,1,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::UCHAR:
-    case Ply::Element::Property::Type::UINT8:
-      {
-        svb.uc[0] = (*static_cast<vector<uchar>*>(value))[UL(index)];
-        success = (fwrite(&(svb.uc[0]),1,1,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::SHORT:
-    case Ply::Element::Property::Type::INT16:
-      {
-        svb.s[0] = (*static_cast<vector<short>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapShort(svb);
-        success = (fwrite(&(svb.s[0]),1,2,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::USHORT:
-    case Ply::Element::Property::Type::UINT16:
-      {
-        svb.us[0] = (*static_cast<vector<ushort>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapUShort(svb);
-        success = (fwrite(&(svb.us[0]),1,2,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::INT:
-    case Ply::Element::Property::Type::INT32:
-      {
-        svb.i[0] = (*static_cast<vector<int>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapInt(svb);
-        success = (fwrite(&(svb.i[0]),1,4,fp)==4);
-      }
-      break;
-    case Ply::Element::Property::Type::UINT:
-    case Ply::Element::Property::Type::UINT32:
-      {
-        svb.ui[0] = (*static_cast<vector<uint>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapUInt(svb);
-        success = (fwrite(&(svb.ui[0]),1,4,fp)==4);
+(OutputBuffer& ob, const Ply::Element::Property::Type propertyType,
+ const bool swapBytes, void* value, int index, int nValues) {
+  bool success = true;
+  switch(propertyType) {
+  case Ply::Element::Property::Type::CHAR:
+  case Ply::Element::Property::Type::INT8:
+    ob.putBinary
+      ((*static_cast<vector<char>*>(value)).data()+index,UL(nValues),swapBytes);
+    break;
+  case Ply::Element::Property::Type::UCHAR:
+  case Ply::Element::Property::Type::UINT8:
+    ob.putBinary
+      ((*static_cast<vector<uchar>*>(value)).data()+index,UL(nValues),swapBytes);
+    break;
+  case Ply::Element::Property::Type::SHORT:
+  case Ply::Element::Property::Type::INT16:
+    ob.putBinary
+      ((*static_cast<vector<short>*>(value)).data()+index,UL(nValues),swapBytes);
+    break;
+  case Ply::Element::Property::Type::USHORT:
+  case Ply::Element::Property::Type::UINT16:
+    ob.putBinary
+      ((*static_cast<vector<ushort>*>(value)).data()+index,UL(nValues),swapBytes);
+    break;
+  case Ply::Element::Property::Type::INT:
+  case Ply::Element::Property::Type::INT32:
+    ob.putBinary
+      ((*static_cast<vector<int>*>(value)).data()+index,UL(nValues),swapBytes);
+    break;
+  case Ply::Element::Property::Type::UINT:
+  case Ply::Element::Property::Type::UINT32:
+    ob.putBinary
+      ((*static_cast<vector<uint>*>(value)).data()+index,UL(nValues),swapBytes);
+    break;
+  case Ply::Element::Property::Type::FLOAT:
+  case Ply::Element::Property::Type::FLOAT32:
+  case Ply::Element::Property::Type::FLOAT32_2:
+  case Ply::Element::Property::Type::FLOAT32_3:
+    {
+      int n =
+        (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+        (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+      ob.putBinary
+        ((*static_cast<vector<float>*>(value)).data()+n*index,
+         UL(n*nValues),swapBytes);
+    }
+    break;
+  case Ply::Element::Property::Type::DOUBLE:
+  case Ply::Element::Property::Type::FLOAT64:
+    ob.putBinary
+      ((*static_cast<vector<double>*>(value)).data()+index,UL(nValues),swapBytes);
+    break; 
+  default:
+    success = false;
+    break;
+  }
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool SaverPly::getBinaryField
+(Ply::Element::Property* property, BinaryField& field) {
+  bool success = true;
+  void* value = property->getValue();
+  field.nComponents = 1;
+  field.valueSize   = property->getPropertyTypeSize();
+  field.color       = BinaryField::Color::NONE;
+  switch(property->getPropertyType()) {
+  case Ply::Element::Property::Type::CHAR:
+  case Ply::Element::Property::Type::INT8:
+    field.data = (*static_cast<vector<char>*>(value)).data();
+    break;
+  case Ply::Element::Property::Type::UCHAR:
+  case Ply::Element::Property::Type::UINT8:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<uchar>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::SHORT:
+  case Ply::Element::Property::Type::INT16:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<short>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::USHORT:
+  case Ply::Element::Property::Type::UINT16:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<ushort>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::INT:
+  case Ply::Element::Property::Type::INT32:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<int>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::UINT:
+  case Ply::Element::Property::Type::UINT32:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<uint>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::FLOAT32_3:
+    field.nComponents = 3;
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<float>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::FLOAT32_2:
+    field.nComponents = 2;
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<float>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::FLOAT:
+  case Ply::Element::Property::Type::FLOAT32:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<float>*>(value)).data());
+    break;
+  case Ply::Element::Property::Type::DOUBLE:
+  case Ply::Element::Property::Type::FLOAT64:
+    field.data = reinterpret_cast<const char*>
+      ((*static_cast<vector<double>*>(value)).data());
+    break;
+  default:
+    success = false;
+    break;
+  }
+  field.valueSize /= field.nComponents;
+  if(property->getName()=="color") {
+    field.color = BinaryField::Color::UCHAR_DOUBLE;
+  }
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// Writes nRecords fixed size records, assembled in blocks of records
+// directly in the output buffer. If the file endianness is not the
+// system endianness, the bytes of each field are swapped in bulk, one
+// strided pass per field component over the whole block.
+void SaverPly::writeBinaryRecords
+(OutputBuffer& ob, const vector<BinaryField>& field, const int nRecords,
+ const bool swapBytes) {
+
+  size_t recordSize = 0;
+  for(const BinaryField& f : field)
+    recordSize +=
+      (f.color!=BinaryField::Color::NONE)?3:UL(f.nComponents*f.valueSize);
+  if(recordSize==0 || nRecords<=0) return;
+
+  int blockRecords = I(OutputBuffer::defaultCapacity/recordSize);
+  if(blockRecords<1) blockRecords = 1;
+
+  int iRecord,iRecord0,iRecord1,nBlock,j,k0,k1;
+  for(k0=iRecord0=0;iRecord0<nRecords;iRecord0=iRecord1) {
+
+    iRecord1 = iRecord0+blockRecords;
+    if(iRecord1>nRecords) iRecord1 = nRecords;
+    nBlock   = iRecord1-iRecord0;
+
+    char* block = ob.reserve(UL(nBlock)*recordSize);
+    char* p     = block;
+    for(iRecord=iRecord0;iRecord<iRecord1;iRecord++) {
+      for(const BinaryField& f : field) {
+        if(f.color==BinaryField::Color::NONE) {
+          size_t n = UL(f.nComponents*f.valueSize);
+          memcpy(p,f.data+n*UL(iRecord),n);
+          p += n;
+        } else {
+          const float* c =
+            reinterpret_cast<const float*>(f.data)+3*UL(iRecord);
+          for(j=0;j<3;j++)
+            *p++ = static_cast<char>
+              ((f.color==BinaryField::Color::UCHAR_DOUBLE)?
+               static_cast<uchar>(255.0*D(c[j])):UC(c[j]*255.0f));
+        }
       }
-      break;
-    case Ply::Element::Property::Type::FLOAT:
-    case Ply::Element::Property::Type::FLOAT32:
-    case Ply::Element::Property::Type::FLOAT32_2:
-    case Ply::Element::Property::Type::FLOAT32_3:
-      {
-        int n =
-          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-        for(int i=0;i<n;i++) {
-          svb.f[0] = (*static_cast<vector<float>*>(value))[n*UL(index)+i];
-          if(swapBytes) Endian::swapFloat(svb);
-          success = (fwrite(&(svb.f[0]),1,4,fp)==4);
-          if(success==false) break;
+
+      // report progress
+      k1 = (10*(iRecord+1))/nRecords;
+      if(k1>k0) {
+        if(_ostrm!=nullptr) {
+          *_ostrm << (10*k1) << "% ";
         }
+        k0 = k1;
       }
-      break;
-    case Ply::Element::Property::Type::DOUBLE:
-    case Ply::Element::Property::Type::FLOAT64:
-      {
-        svb.d[0] = (*static_cast<vector<double>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapDouble(svb);
-        success = (fwrite(&(svb.d[0]),1,8,fp)==8);
+    }
+
+    if(swapBytes) {
+      size_t offset = 0;
+      for(const BinaryField& f : field) {
+        if(f.color!=BinaryField::Color::NONE) { offset += 3; continue; }
+        for(j=0;j<f.nComponents;j++,offset+=UL(f.valueSize))
+          if(f.valueSize>1)
+            Endian::swapArray(block+offset,UL(nBlock),f.valueSize,recordSize);
       }
-      break; 
-    default:
-      break;
     }
+
+    ob.advance(UL(nBlock)*recordSize);
   }
-  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
 // static
-  
-bool SaverPly::writeBinaryColorValue
-(FILE * fp, const bool swapBytes, void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    Endian::SingleValueBuffer svb;
-    for(int i=0;i<3;i++) {
-      float& f = (*static_cast<vector<float>*>(value))[3*UL(index)+i]; 
-      svb.uc[0] = static_cast<uchar>(255.0*f); 
-      success = (fwrite(&(svb.uc[0]),1,1,fp)==1);
-      if(success==false) break;
+void SaverPly::writeBinaryColorValue
+(OutputBuffer& ob, void* value, int index) {
+  const float* f = (*static_cast<vector<float>*>(value)).data()+3*UL(index);
+  char* p = ob.reserve(3);
+  for(int i=0;i<3;i++)
+    p[i] = static_cast<char>(static_cast<uchar>(255.0*D(f[i])));
+  ob.advance(3);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// prints the percentage of nDone out of nTotal, in 10% steps
+void SaverPly::reportProgress(const int nDone, const int nTotal, int& k0) {
+  int k1 = (10*nDone)/nTotal;
+  if(k1>k0) {
+    if(_ostrm!=nullptr) {
+      *_ostrm << (10*k1) << "% ";
     }
+    k0 = k1;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// faceFirst[iF] is the first corner of face iF in the -1 separated
+// coordIndex array, and faceFirst[nFaces] is past the last separator
+void SaverPly::getFaceFirst
+(const vector<int>& coordIndex, vector<int>& faceFirst) {
+  faceFirst.clear();
+  faceFirst.push_back(0);
+  for(int i=0;i<I(coordIndex.size());i++)
+    if(coordIndex[UI(i)]<0) faceFirst.push_back(i+1);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverPly::reportThroughput
+(OutputBuffer& ob, const chrono::steady_clock::time_point& t0,
+ const string& indent) {
+  if(_ostrm!=nullptr) {
+    double seconds =
+      chrono::duration<double>(chrono::steady_clock::now()-t0).count();
+    double mBytes  = D(ob.getBytesWritten())/(1024.0*1024.0);
+    *_ostrm << indent << "  nBytes = " << ob.getBytesWritten() << endl;
+    if(seconds>0.0)
+      *_ostrm << indent << "  MB/s   = " << (mBytes/seconds) << endl;
   }
-  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
 // static
 bool SaverPly::writeAsciiValue
-(FILE * fp, const Ply::Element::Property::Type propertyType,
+(OutputBuffer& ob, const Ply::Element::Property::Type propertyType,
  void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    switch(propertyType) {
-    case Ply::Element::Property::Type::CHAR:
-    case Ply::Element::Property::Type::INT8:
-      {
-        char & c = (*static_cast<vector<char>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",c)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::UCHAR:
-    case Ply::Element::Property::Type::UINT8:
-      {
-        uchar & uc = (*static_cast<vector<uchar>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",uc)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::SHORT:
-    case Ply::Element::Property::Type::INT16:
-      {
-        short & s = (*static_cast<vector<short>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",s)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::USHORT:
-    case Ply::Element::Property::Type::UINT16:
-      {
-        ushort & us = (*static_cast<vector<ushort>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",us)>0);
+  bool success = true;
+  switch(propertyType) {
+  case Ply::Element::Property::Type::CHAR:
+  case Ply::Element::Property::Type::INT8:
+    ob.putInt((*static_cast<vector<char>*>(value))[UL(index)]);
+    break;
+  case Ply::Element::Property::Type::UCHAR:
+  case Ply::Element::Property::Type::UINT8:
+    ob.putInt((*static_cast<vector<uchar>*>(value))[UL(index)]);
+    break;
+  case Ply::Element::Property::Type::SHORT:
+  case Ply::Element::Property::Type::INT16:
+    ob.putInt((*static_cast<vector<short>*>(value))[UL(index)]);
+    break;
+  case Ply::Element::Property::Type::USHORT:
+  case Ply::Element::Property::Type::UINT16:
+    ob.putInt((*static_cast<vector<ushort>*>(value))[UL(index)]);
+    break;
+  case Ply::Element::Property::Type::INT:
+  case Ply::Element::Property::Type::INT32:
+    ob.putInt((*static_cast<vector<int>*>(value))[UL(index)]);
+    break;
+  case Ply::Element::Property::Type::UINT:
+  case Ply::Element::Property::Type::UINT32:
+    ob.putInt(I((*static_cast<vector<uint>*>(value))[UL(index)]));
+    break;
+  case Ply::Element::Property::Type::FLOAT:
+  case Ply::Element::Property::Type::FLOAT32:
+  case Ply::Element::Property::Type::FLOAT32_2:
+  case Ply::Element::Property::Type::FLOAT32_3:
+    {
+      int n =
+        (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+        (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+      const float* f =
+        (*static_cast<vector<float>*>(value)).data()+n*UL(index);
+      for(int i=0;i<n;i++) {
+        ob.putFloat(f[i],_floatPrecision);
+        ob.putChar(' ');
       }
-      break;
-    case Ply::Element::Property::Type::INT:
-    case Ply::Element::Property::Type::INT32:
-      {
-        int & i = (*static_cast<vector<int>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",i)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::UINT:
-    case Ply::Element::Property::Type::UINT32:
-      {
-        uint & ui = (*static_cast<vector<uint>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",ui)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::FLOAT:
-    case Ply::Element::Property::Type::FLOAT32:
-    case Ply::Element::Property::Type::FLOAT32_2:
-    case Ply::Element::Property::Type::FLOAT32_3:
-      {
-        int n =
-          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-        for(int i=0;i<n;i++) {
-          float & f = (*static_cast<vector<float>*>(value))[i+n*UL(index)];
-          success = (fprintf(fp,"%f ",D(f))>0);
-          if(success==false) break;
-        }
-      }
-      break;
-    case Ply::Element::Property::Type::DOUBLE:
-    case Ply::Element::Property::Type::FLOAT64:
-      {
-        double & d = (*static_cast<vector<double>*>(value))[UL(index)];
-        success = (fprintf(fp,"%f",d)>0);
-      }
-      break; 
-    default:
-      break;
     }
+    break;
+  case Ply::Element::Property::Type::DOUBLE:
+  case Ply::Element::Property::Type::FLOAT64:
+    ob.putDouble((*static_cast<vector<double>*>(value))[UL(index)],
+                 _floatPrecision);
+    break; 
+  default:
+    success = false;
+    break;
   }
   return success;
 }
 
 //////////////////////////////////////////////////////////////////////
 // static
-  
-bool SaverPly::writeAsciiColorValue
-(FILE * fp, void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    for(int i=0;i<3;i++) {
-      float& f = (*static_cast<vector<float>*>(value))[3*UL(index)+i]; 
-      uchar uc = static_cast<uchar>(255.0*f); 
-      success = (fprintf(fp,"%3d ",uc)>0);
-      if(success==false) break;
-    }
+void SaverPly::writeAsciiColorValue
+(OutputBuffer& ob, void* value, int index) {
+  const float* f = (*static_cast<vector<float>*>(value)).data()+3*UL(index);
+  for(int i=0;i<3;i++) {
+    ob.putInt(static_cast<uchar>(255.0*D(f[i])),3);
+    ob.putChar(' ');
   }
-  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -574,15 +699,21 @@ SaverPly::writeBinaryData
 
   try {
 
+    if(fp==nullptr) throw new StrException("fp==nullptr");
+
     bool swapBytes = (sameAsSystemEndian(dataType)==false);
 
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    OutputBuffer ob(fp);
+
     Ply::Element* element;
     Ply::Element::Property* property;
     Ply::Element::Property::Type listType;
     Ply::Element::Property::Type propertyType;
     void* propertyValue;
-    int iElement,iList0,iList1,iList,nList,k0,k1;
+    int iElement,iList0,iList1,nList,k0,k1;
     int iProperty,iRecord,nElements,nProperties,nRecords;
+    bool hasList;
     string name,propertyName;
 
     nElements = ply.getNumberOfElements();
@@ -597,8 +728,16 @@ SaverPly::writeBinaryData
         *_ostrm << indent << "    name " << name << endl;
       }
 
-      nProperties = element->getNumberOfProperties();
-      if(_skipAlpha && element->hasProperty("alpha")) nProperties--;
+      // properties written to the file, in order
+      vector<Ply::Element::Property*> writeProperty;
+      hasList = false;
+      for(iProperty=0;iProperty<element->getNumberOfProperties();iProperty++) {
+        property = element->getProperty(iProperty);
+        if(_skipAlpha && property->getName()=="alpha") continue;
+        if(property->isList()) hasList = true;
+        writeProperty.push_back(property);
+      }
+      nProperties = I(writeProperty.size());
       if(_ostrm!=nullptr) {
         *_ostrm << indent << "      nProperties = " << nProperties<< endl;
       }
@@ -609,58 +748,85 @@ SaverPly::writeBinaryData
         *_ostrm << indent << "        ";
       }
 
-      for(k0=iRecord=0;iRecord<nRecords;iRecord++) {
-
-        for(iProperty=0;iProperty<nProperties;iProperty++) {
-          property      = element->getProperty(iProperty);
-          propertyName  = property->getName();
-          if(_skipAlpha && propertyName=="alpha") continue;
-          propertyType  = property->getPropertyType();
-          propertyValue = property->getValue();
-
-          if(property->isList()) {
-            listType = property->getListType();
-            iList0   = property->getListFirst(iRecord );
-            nList    = property->getListFirst(iRecord+1)-iList0;
-            if(propertyName=="coordIndex") nList--; // don't write -1 separator
-            iList1   = iList0+nList;
-            
-            if(writeBinaryValue(fp,listType,swapBytes,nList)==false)
-              throw new StrException("unable to write list binary count");
-            for(iList=iList0;iList<iList1;iList++) {
-              if(writeBinaryValue
-                 (fp,propertyType,swapBytes,propertyValue,iList)==false)
+      if(hasList==false) {
+
+        // fixed size records
+        vector<BinaryField> field(UL(nProperties));
+        for(iProperty=0;iProperty<nProperties;iProperty++)
+          if(getBinaryField(writeProperty[UL(iProperty)],
+                            field[UL(iProperty)])==false)
+            throw new StrException("unexpected property type");
+
+        writeBinaryRecords(ob,field,nRecords,swapBytes);
+
+      } else {
+
+        // next face of the -1 separated coordIndex array
+        vector<int> coordIndexFirst(UL(nProperties),0);
+
+        for(k0=iRecord=0;iRecord<nRecords;iRecord++) {
+
+          for(iProperty=0;iProperty<nProperties;iProperty++) {
+            property      = writeProperty[UL(iProperty)];
+            propertyName  = property->getName();
+            propertyType  = property->getPropertyType();
+            propertyValue = property->getValue();
+
+            if(property->isList()) {
+              if(propertyName=="coordIndex") {
+                vector<int>& coordIndex =
+                  *static_cast<vector<int>*>(propertyValue);
+                iList0 = coordIndexFirst[UL(iProperty)];
+                for(iList1=iList0;iList1<I(coordIndex.size());iList1++)
+                  if(coordIndex[UL(iList1)]<0) break;
+                coordIndexFirst[UL(iProperty)] = iList1+1;
+                nList    = iList1-iList0; // don't write -1 separator
+                listType = Ply::Element::Property::Type::UCHAR;
+              } else {
+                iList0   = property->getListFirst(iRecord );
+                nList    = property->getListFirst(iRecord+1)-iList0;
+                listType = property->getListType();
+              }
+
+              if(writeBinaryValue(ob,listType,swapBytes,nList)==false)
+                throw new StrException("unable to write list binary count");
+              if(nList>0 &&
+                 writeBinaryValue
+                 (ob,propertyType,swapBytes,propertyValue,iList0,nList)==false)
                 throw new StrException("unable to write list binary value");
-            }
-          } else {
-            if(propertyName=="color") {
-              if(writeBinaryColorValue(fp,swapBytes,propertyValue,iRecord)==false)
-                throw new StrException("unable to write binary value");
+            } else if(propertyName=="color") {
+              writeBinaryColorValue(ob,propertyValue,iRecord);
             } else {
               if(writeBinaryValue
-                 (fp,propertyType,swapBytes,propertyValue,iRecord)==false)
+                 (ob,propertyType,swapBytes,propertyValue,iRecord)==false)
                 throw new StrException("unable to write binary value");
             }
-          }
           
-        } // for(iProperty ...
+          } // for(iProperty ...
 
-        // report progress
-        k1 = (10*(iRecord+1))/nRecords;
-        if(k1>k0) {
-          if(_ostrm!=nullptr) {
-            *_ostrm << (10*k1) << "% ";
+          // report progress
+          k1 = (10*(iRecord+1))/nRecords;
+          if(k1>k0) {
+            if(_ostrm!=nullptr) {
+              *_ostrm << (10*k1) << "% ";
+            }
+            k0 = k1;
           }
-          k0 = k1;
-        }
           
-      } // for(iRecord ...
+        } // for(iRecord ...
+
+      }
       
       if(_ostrm!=nullptr) {
         *_ostrm << endl;
       }
         
     }
+
+    if(ob.flush()==false)
+      throw new StrException("unable to write binary data");
+
+    reportThroughput(ob,t0,indent);
       
     success = true;
       
@@ -694,15 +860,16 @@ SaverPly::writeAsciiData
 
     if(dataType!=Ply::DataType::ASCII)
         throw new StrException("  incorrect data type");
+    if(fp==nullptr)
+        throw new StrException("fp==nullptr");
+
+    chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+    OutputBuffer ob(fp);
 
     Ply::Element* element;
     Ply::Element::Property* property;
-    // Ply::Element::Property::Type listType;
-    Ply::Element::Property::Type propertyType;
-    void* propertyValue;
-    int iElement,iList0,iList1,iList,nList,iProperty;
-    int iRecord,nElements,nProperties,nRecords,k0,k1;
-    string name,propertyName;
+    int iElement,iProperty,nElements,nProperties,nRecords,k0;
+    string name;
 
     nElements = ply.getNumberOfElements();
     if(_ostrm!=nullptr) {
@@ -716,8 +883,14 @@ SaverPly::writeAsciiData
         *_ostrm << indent << "  name = " << name << endl;
       }
 
-      nProperties = element->getNumberOfProperties();
-      if(_skipAlpha && element->hasProperty("alpha")) nProperties--;
+      // properties written to the file, in order
+      vector<Ply::Element::Property*> writeProperty;
+      for(iProperty=0;iProperty<element->getNumberOfProperties();iProperty++) {
+        property = element->getProperty(iProperty);
+        if(_skipAlpha && property->getName()=="alpha") continue;
+        writeProperty.push_back(property);
+      }
+      nProperties = I(writeProperty.size());
       if(_ostrm!=nullptr) {
         *_ostrm << indent << "      nProperties = " << nProperties << endl;
       }
@@ -728,57 +901,82 @@ SaverPly::writeAsciiData
         *_ostrm << indent << "        ";
       }
 
-      for(k0=iRecord=0;iRecord<nRecords;iRecord++) {
-
-        for(iProperty=0;iProperty<nProperties;iProperty++) {
-          property      = element->getProperty(iProperty);
-          propertyName  = property->getName();
-          if(_skipAlpha && propertyName=="alpha") continue;
-          propertyType  = property->getPropertyType();
-          propertyValue = property->getValue();
-
-          if(property->isList()) {
-            // listType = property->getListType();
-            iList0   = property->getListFirst(iRecord );
-            nList    = property->getListFirst(iRecord+1)-iList0;
-            if(propertyName=="coordIndex") nList--; // don't write -1 separator 
-            iList1   = iList0+nList;
-
-            fprintf(fp,"%d ",nList);
-            for(iList=iList0;iList<iList1;) {
-              if(writeAsciiValue(fp,propertyType,propertyValue,iList)==false)
-                throw new StrException("unable to write list ascii value");
-              if(++iList<iList1) fprintf(fp," ");
-            }
-
-          } else /* if(property->isList()==false) */ {
-            if(propertyName=="color") {
-              if(writeAsciiColorValue(fp,propertyValue,iRecord)==false)
-                throw new StrException("unable to write ascii color value");
-            } else {
-              if(writeAsciiValue(fp,propertyType,propertyValue,iRecord)==false)
-                throw new StrException("unable to write ascii value");
+      // first corner of each face of the -1 separated coordIndex array
+      vector<int> faceFirst;
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        property = writeProperty[UL(iProperty)];
+        if(property->getPropertyType()==Ply::Element::Property::Type::NONE)
+          throw new StrException("unexpected property type");
+        if(property->isList() && property->getName()=="coordIndex")
+          getFaceFirst(*static_cast<vector<int>*>(property->getValue()),
+                       faceFirst);
+      }
+      if(faceFirst.size()>0 && I(faceFirst.size())-1<nRecords)
+        throw new StrException("coordIndex has too few faces");
+
+      k0 = 0;
+      ob.putParallel
+        (nRecords,
+         [&](OutputBuffer& ob, const int iRecord0, const int iRecord1) {
+          Ply::Element::Property* property;
+          Ply::Element::Property::Type propertyType;
+          void* propertyValue;
+          int iRecord,iProperty,iList0,iList1,iList,nList;
+          for(iRecord=iRecord0;iRecord<iRecord1;iRecord++) {
+
+            for(iProperty=0;iProperty<nProperties;iProperty++) {
+              property      = writeProperty[UL(iProperty)];
+              propertyType  = property->getPropertyType();
+              propertyValue = property->getValue();
+
+              if(property->isList()) {
+                if(property->getName()=="coordIndex") {
+                  iList0 = faceFirst[UL(iRecord)];
+                  iList1 = faceFirst[UL(iRecord+1)]-1; // don't write -1
+                  nList  = iList1-iList0;
+                } else {
+                  iList0 = property->getListFirst(iRecord );
+                  nList  = property->getListFirst(iRecord+1)-iList0;
+                  iList1 = iList0+nList;
+                }
+
+                ob.putInt(nList);
+                ob.putChar(' ');
+                for(iList=iList0;iList<iList1;) {
+                  writeAsciiValue(ob,propertyType,propertyValue,iList);
+                  if(++iList<iList1) ob.putChar(' ');
+                }
+
+              } else /* if(property->isList()==false) */ {
+                if(property->getName()=="color") {
+                  writeAsciiColorValue(ob,propertyValue,iRecord);
+                } else {
+                  writeAsciiValue(ob,propertyType,propertyValue,iRecord);
+                }
+
+                ob.putChar(' ');
+              }
             }
-
-            fprintf(fp," ");
+            ob.putChar('\n'); // end of record
           }
-        }
-        fprintf(fp,"\n"); // end of record
+        },
+         [&k0,nRecords](const int iRecord1) {
+          reportProgress(iRecord1,nRecords,k0);
+        });
 
-        k1 = (10*(iRecord+1))/nRecords;
-        if(k1>k0) {
-          if(_ostrm!=nullptr) {
-            *_ostrm << (10*k1) << "% ";
-          }
-          k0 = k1;
-        }
-      }
       if(_ostrm!=nullptr) {
         *_ostrm << endl;
       }
 
     }
 
+    if(ob.flush()==false)
+      throw new StrException("unable to write ascii data");
+
+    reportThroughput(ob,t0,indent);
+
+    success = true;
+
   } catch (StrException* e) {
     if(_ostrm!=nullptr) {
       *_ostrm << indent << "  " << e->what() << endl;
@@ -796,23 +994,33 @@ SaverPly::writeAsciiData
 //////////////////////////////////////////////////////////////////////
 // static
 bool SaverPly::save
-(const char* filename, Ply & ply, const string indent, Ply::DataType dataType) {
+(const char* filename, Ply & ply, const string indent,
+ Ply::DataType dataType) {
+
+  bool success = false;
+
+  FILE* fp = (filename!=nullptr)?GzFile::open(filename,"wb"):nullptr;
+  if(fp!=nullptr) {
+    success = save(fp,ply,indent,dataType);
+    if(fclose(fp)!=0) success = false;
+  }
+
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool SaverPly::save
+(FILE* fp, Ply & ply, const string indent, Ply::DataType dataType) {
 
   bool success = false;
 
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "SaverPly::save(Ply &) {" << endl;
-    *_ostrm << indent << "  filename = " << endl;
-    *_ostrm << indent << "  \"" << filename << "\"" << endl;
   }
 
-  FILE* fp  = nullptr;
-      
   try {
         
-    if(filename==nullptr) throw new StrException("filename==nullptr");
-
-    fp = fopen(filename,"w");
     if(fp==nullptr) throw new StrException("fp==nullptr");
 
 
@@ -825,20 +1033,14 @@ bool SaverPly::save
       if(writeAsciiData(fp,ply,indent+"  ")==false)
         throw new StrException("unable to write ASCII data");
     } else /* if(dataType==Ply::DataType::BINARY) */ {
-      // close file;
-      fflush(fp);
-      fclose(fp);
-      // reopen file for binary append
-      fp = fopen(filename,"ab");
+      // the file is open for binary writing
       if(writeBinaryData(fp,ply,indent+"  ",dataType)==false)
         throw new StrException("unable to write BINARY data");
     }
 
-    fclose(fp);
     success = true;
 
   } catch(StrException* e) { 
-    if(fp) { fclose(fp); fp = nullptr; }
     if(_ostrm!=nullptr) {
       *_ostrm << indent << "  " << e->what() << endl;
     }
@@ -962,7 +1164,7 @@ bool SaverPly::writeHeader
       }
           
       // color -> UCHAR red,green,blue
-      if(ifs.hasColorPerVertex()) {
+      if(ifs.hasColorPerFace()) {
         fprintf(fp,"property uchar red\n");
         fprintf(fp,"property uchar green\n");
         fprintf(fp,"property uchar blue\n");            
@@ -1018,13 +1220,18 @@ SaverPly::writeBinaryData
 
   bool swapBytes = (sameAsSystemEndian(dataType)==false);
 
-  int i,i0,i1,iF,nList,iV,iN,iC,j,k0,k1;
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  OutputBuffer ob(fp);
+
+  int i0,i1,iF,nList,iN,iC,j,k0,k1;
 
-  vector<float>& coord         = ifs.getCoord();
+  // compact encodings are decoded into temporary buffers
+  vector<float>  coordBuffer,normalBuffer,colorBuffer;
+  const vector<float>& coord   = ifs.readCoord(coordBuffer);
   vector<int>&   coordIndex    = ifs.getCoordIndex();
-  vector<float>& normal        = ifs.getNormal();
+  const vector<float>& normal  = ifs.readNormal(normalBuffer);
   vector<int>&   normalIndex   = ifs.getNormalIndex();
-  vector<float>& color         = ifs.getColor();
+  const vector<float>& color   = ifs.readColor(colorBuffer);
   vector<int>&   colorIndex    = ifs.getColorIndex();
   vector<float>& texCoord      = ifs.getTexCoord();
   // vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
@@ -1032,56 +1239,27 @@ SaverPly::writeBinaryData
   int nVertices = ifs.getNumberOfVertices();
   int nFaces    = ifs.getNumberOfFaces();
 
-  Endian::SingleValueBuffer svb;
-
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "  name = vertex" << endl;
     *_ostrm << indent << "    ";
   }
 
-  for(k0=iV=0;iV<nVertices;iV++) {
+  vector<BinaryField> field;
+  if(true /* ifs.hasCoordPerVertex() */)
+    field.push_back(BinaryField(coord.data(),4,3));
+  if(ifs.hasNormalPerVertex())
+    field.push_back(BinaryField(normal.data(),4,3));
+  if(ifs.hasColorPerVertex())
+    field.push_back(BinaryField(color.data(),4,3,BinaryField::Color::UCHAR));
+  if(ifs.hasTexCoordPerVertex())
+    field.push_back(BinaryField(texCoord.data(),4,2));
 
-    if(true /* ifs.hasCoordPerVertex() */) {
-      for(j=0;j<3;j++) {
-        svb.f[0] = coord[UI(3*iV+j)];
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.f[0]),1,4,fp); // ==4
-      }
-    }
-    if(ifs.hasNormalPerVertex()) {
-      for(j=0;j<3;j++) {
-        svb.f[0] = normal[UI(3*iV+j)];
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.f[0]),1,4,fp); // ==4
-      }
-    }
-    if(ifs.hasColorPerVertex()) {
-      for(j=0;j<3;j++) {
-        svb.uc[0] = UC(color[UI(3*iV+j)]*255.0f);
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.uc[0]),1,1,fp); // ==1
-      }
-    }
-    if(ifs.hasTexCoordPerVertex()) {
-      for(j=0;j<2;j++) {
-        svb.f[0] = texCoord[UI(2*iV+j)];
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.f[0]),1,4,fp); // ==4
-      }
-    }
+  writeBinaryRecords(ob,field,nVertices,swapBytes);
 
-    k1 = (10*(iV+1))/nVertices;
-    if(k1>k0) {
-      if(_ostrm!=nullptr) {
-        *_ostrm << (10*k1) << "% ";
-      }
-      k0 = k1;
-    }
-  }
   if(_ostrm!=nullptr) {
     *_ostrm << endl;
   }
-
+
   if(nFaces>0) {
     if(_ostrm!=nullptr) {
       *_ostrm << indent << "  name = face" << endl;
@@ -1096,31 +1274,20 @@ SaverPly::writeBinaryData
       if(coordIndex[UI(i1)]<0) {
         nList = i1-i0;
 
-        svb.uc[0] = UC(nList);
-        fwrite(&(svb.uc[0]),1,1,fp); // ==1
-
-        for(i=i0;i<i1;i++) {
-          svb.i[0] = coordIndex[UI(i)];
-          if(swapBytes) Endian::swapInt(svb);
-          fwrite(&(svb.i[0]),1,4,fp); // ==4
-        }
+        ob.putBinary(UC(nList),false);
+        ob.putBinary(coordIndex.data()+i0,UL(nList),swapBytes);
 
         if(ifsHasNormalPerFace) {
           iN = (normalIndex.size()>0)?normalIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++) {
-            svb.f[0] = normal[UI(3*iN+j)];
-            if(swapBytes) Endian::swapFloat(svb);
-            fwrite(&(svb.f[0]),1,4,fp); // ==4
-          }
+          ob.putBinary(normal.data()+3*iN,3,swapBytes);
         }
 
         if(ifsHasColorPerFace) {
           iC = (colorIndex.size()>0)?colorIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++) {
-            svb.uc[0] = UC(color[UI(3*iC+j)]*255.0f);
-            if(swapBytes) Endian::swapFloat(svb);
-            fwrite(&(svb.uc[0]),1,1,fp); // ==1
-          }
+          char* p = ob.reserve(3);
+          for(j=0;j<3;j++)
+            p[j] = static_cast<char>(UC(color[UI(3*iC+j)]*255.0f));
+          ob.advance(3);
         }
 
         k1 = (10*(iF+1))/nFaces;
@@ -1141,11 +1308,15 @@ SaverPly::writeBinaryData
     
   } // if(nFaces>0)
 
+  bool success = ob.flush();
+  if(success) reportThroughput(ob,t0,indent);
+
   if(_ostrm!=nullptr) {
+    if(success==false) *_ostrm << indent << "  ERROR" << endl;
     *_ostrm << indent << "} SaverPly::writeBinaryData(IndexedFaceSet &)" << endl;
   }
 
-  return true;
+  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1171,14 +1342,18 @@ SaverPly::writeAsciiData
     return false;
   }
 
-  int i,i0,i1,iF,iV,iN,iC,j,k0,k1;
-  uint nList;
+  chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+  OutputBuffer ob(fp);
 
-  vector<float>& coord         = ifs.getCoord();
+  int k0;
+
+  // compact encodings are decoded into temporary buffers
+  vector<float>  coordBuffer,normalBuffer,colorBuffer;
+  const vector<float>& coord   = ifs.readCoord(coordBuffer);
   vector<int>&   coordIndex    = ifs.getCoordIndex();
-  vector<float>& normal        = ifs.getNormal();
+  const vector<float>& normal  = ifs.readNormal(normalBuffer);
   vector<int>&   normalIndex   = ifs.getNormalIndex();
-  vector<float>& color         = ifs.getColor();
+  const vector<float>& color   = ifs.readColor(colorBuffer);
   vector<int>&   colorIndex    = ifs.getColorIndex();
   vector<float>& texCoord      = ifs.getTexCoord();
   // vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
@@ -1186,39 +1361,54 @@ SaverPly::writeAsciiData
   int nVertices = ifs.getNumberOfVertices();
   int nFaces    = ifs.getNumberOfFaces();
 
+  bool ifsHasNormalPerVertex   = ifs.hasNormalPerVertex();
+  bool ifsHasColorPerVertex    = ifs.hasColorPerVertex();
+  bool ifsHasTexCoordPerVertex = ifs.hasTexCoordPerVertex();
+
+  const int floatPrecision = _floatPrecision;
+
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "  name = vertex" << endl;
     *_ostrm << indent << "    ";
   }
 
-  for(k0=iV=0;iV<nVertices;iV++) {
-
-    if(true /* ifs.hasCoordPerVertex() */) {
-      for(j=0;j<3;j++)
-        fprintf(fp,"%f ",D(coord[UI(3*iV+j)]));
-    }
-    if(ifs.hasNormalPerVertex()) {
-      for(j=0;j<3;j++)
-        fprintf(fp,"%f ",D(normal[UI(3*iV+j)]));
-    }
-    if(ifs.hasColorPerVertex()) {
-      for(j=0;j<3;j++)
-        fprintf(fp,"%d ",UC(color[UI(3*iV+j)]*255.0f));
-    }
-    if(ifs.hasTexCoordPerVertex()) {
-      for(j=0;j<2;j++)
-        fprintf(fp,"%f ",D(texCoord[UI(2*iV+j)]));
-    }
-    fprintf(fp,"\n");
-
-    k1 = (10*(iV+1))/nVertices;
-    if(k1>k0) {
-      if(_ostrm!=nullptr) {
-        *_ostrm << (10*k1) << "% ";
+  k0 = 0;
+  ob.putParallel
+    (nVertices,
+     [&,floatPrecision](OutputBuffer& ob, const int iV0, const int iV1) {
+      int iV,j;
+      for(iV=iV0;iV<iV1;iV++) {
+        if(true /* ifs.hasCoordPerVertex() */) {
+          for(j=0;j<3;j++) {
+            ob.putFloat(coord[UI(3*iV+j)],floatPrecision);
+            ob.putChar(' ');
+          }
+        }
+        if(ifsHasNormalPerVertex) {
+          for(j=0;j<3;j++) {
+            ob.putFloat(normal[UI(3*iV+j)],floatPrecision);
+            ob.putChar(' ');
+          }
+        }
+        if(ifsHasColorPerVertex) {
+          for(j=0;j<3;j++) {
+            ob.putInt(UC(color[UI(3*iV+j)]*255.0f));
+            ob.putChar(' ');
+          }
+        }
+        if(ifsHasTexCoordPerVertex) {
+          for(j=0;j<2;j++) {
+            ob.putFloat(texCoord[UI(2*iV+j)],floatPrecision);
+            ob.putChar(' ');
+          }
+        }
+        ob.putChar('\n');
       }
-      k0 = k1;
-    }
-  }
+    },
+     [&k0,nVertices](const int iV1) {
+      reportProgress(iV1,nVertices,k0);
+    });
+
   if(_ostrm!=nullptr) {
     *_ostrm << endl;
   }
@@ -1232,73 +1422,97 @@ SaverPly::writeAsciiData
     bool ifsHasNormalPerFace = ifs.hasNormalPerFace();
     bool ifsHasColorPerFace  = ifs.hasColorPerFace();
 
-    for(k0=iF=i0=i1=0;i1<I(coordIndex.size());i1++) {
-      if(coordIndex[UI(i1)]<0) {
-        nList = UC(i1-i0);
-
-        fprintf(fp,"%d ",nList);
-        for(i=i0;i<i1;i++)
-          fprintf(fp,"%d ",coordIndex[UI(i)]);
+    vector<int> faceFirst;
+    getFaceFirst(coordIndex,faceFirst);
+    nFaces = I(faceFirst.size())-1;
+
+    k0 = 0;
+    ob.putParallel
+      (nFaces,
+       [&,floatPrecision](OutputBuffer& ob, const int iF0, const int iF1) {
+        int i,i0,i1,iF,iN,iC,j;
+        for(iF=iF0;iF<iF1;iF++) {
+          i0 = faceFirst[UI(iF)];
+          i1 = faceFirst[UI(iF+1)]-1; // -1 separator
+
+          ob.putInt(UC(i1-i0));
+          ob.putChar(' ');
+          for(i=i0;i<i1;i++) {
+            ob.putInt(coordIndex[UI(i)]);
+            ob.putChar(' ');
+          }
         
-        if(ifsHasNormalPerFace) {
-          iN = (normalIndex.size()>0)?normalIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++)
-            fprintf(fp,"%f ",D(normal[UI(iN)]));
-        }
-
-        if(ifsHasColorPerFace) {
-          iC = (colorIndex.size()>0)?colorIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++)
-            fprintf(fp,"%f ",D(color[UC(iC)]));
-        }
-
-        fprintf(fp,"\n");
+          if(ifsHasNormalPerFace) {
+            iN = (normalIndex.size()>0)?normalIndex[UI(iF)]:iF;
+            for(j=0;j<3;j++) {
+              ob.putFloat(normal[UI(3*iN+j)],floatPrecision);
+              ob.putChar(' ');
+            }
+          }
 
-        k1 = (10*(iF+1))/nFaces;
-        if(k1>k0) {
-          if(_ostrm!=nullptr) {
-            *_ostrm << (10*k1) << "% ";
+          if(ifsHasColorPerFace) {
+            iC = (colorIndex.size()>0)?colorIndex[UI(iF)]:iF;
+            for(j=0;j<3;j++) {
+              ob.putInt(UC(color[UI(3*iC+j)]*255.0f));
+              ob.putChar(' ');
+            }
           }
-          k0 = k1;
+
+          ob.putChar('\n');
         }
+      },
+       [&k0,nFaces](const int iF1) {
+        reportProgress(iF1,nFaces,k0);
+      });
 
-        i0=i1+1; iF++;
-      }
-    }
     if(_ostrm!=nullptr) {
       *_ostrm << endl;
     }
   } // if(nFaces>0)
 
+  bool success = ob.flush();
+  if(success) reportThroughput(ob,t0,indent);
+
   if(_ostrm!=nullptr) {
+    if(success==false) *_ostrm << indent << "  ERROR" << endl;
     *_ostrm << indent << "} SaverPly::writeAsciiData(IndexedFaceSet &)" << endl;
   }
-  return true;
+  return success;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+bool SaverPly::save
+(const char* filename, IndexedFaceSet & ifs, const string indent,
+ Ply::DataType dataType) {
+
+  bool success = false;
+
+  FILE* fp = (filename!=nullptr)?GzFile::open(filename,"wb"):nullptr;
+  if(fp!=nullptr) {
+    success = save(fp,ifs,indent,dataType);
+    if(fclose(fp)!=0) success = false;
+  }
+
+  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
 // static
 bool
 SaverPly::save
-(const char* filename, IndexedFaceSet & ifs, const string indent,
+(FILE* fp, IndexedFaceSet & ifs, const string indent,
  Ply::DataType dataType) {
 
   bool success = false;
 
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "SaverPly::save(IndexedFaceSet &) {" << endl;
-    *_ostrm << indent << "  filename =" << endl;
-    *_ostrm << indent << "  \"" << filename << "\"" << endl;
   }
 
 
-  FILE* fp  = nullptr;
-      
   try {
         
-    if(filename==nullptr) throw new StrException("filename==nullptr");
-
-    fp = fopen(filename,"w");
     if(fp==nullptr) throw new StrException("fp==nullptr");
 
     if(writeHeader(fp,ifs,indent+"  ",dataType)==false)
@@ -1310,20 +1524,14 @@ SaverPly::save
       if(writeAsciiData(fp,ifs,indent+"  ",dataType)==false)
         throw new StrException("unable to write ASCII data");
     } else /* if(dataType==Ply::DataType::BINARY) */ {
-      // close file;
-      fflush(fp);
-      fclose(fp);
-      // reopen file for binary append
-      fp = fopen(filename,"ab");
+      // the file is open for binary writing
       if(writeBinaryData(fp,ifs,indent+"  ",dataType)==false)
         throw new StrException("unable to write BINARY data");
     }
 
-    fclose(fp);
     success = true;
 
   } catch(StrException* e) { 
-    if(fp) { fclose(fp); fp = nullptr; }
     if(_ostrm!=nullptr) {
       *_ostrm << indent << "  " << e->what() << endl;
     }
@@ -1340,7 +1548,8 @@ SaverPly::save
 //////////////////////////////////////////////////////////////////////
 // virtual
 bool
-SaverPly::save(const char* filename, SceneGraph& wrl) const {
+SaverPly::_save(FILE* fp, const char* url, SceneGraph& wrl) const {
+  (void) url;
 
   const string indent = _indent;
   
@@ -1351,20 +1560,20 @@ SaverPly::save(const char* filename, SceneGraph& wrl) const {
   }
 
   try {
-    if(filename==nullptr)  throw new StrException("filename==nullptr");
-
     if(wrl.getNumberOfChildren()!=1)
       throw new StrException("wrl.getNumberOfChildren()!=1");
 
     Node* node = wrl[0];
-    Shape* shape = dynamic_cast<Shape*>(node);
-    if(shape==nullptr) throw new StrException("shape==nullptr");
+    if(node->isShape()==false) throw new StrException("shape==nullptr");
+    Shape* shape = (Shape*)node;
     node = shape->getAppearance();
-    Appearance* appearance = dynamic_cast<Appearance*>(node);
-    if(appearance==nullptr) throw new StrException("appearance==nullptr");
+    if(node==nullptr || node->isAppearance()==false)
+      throw new StrException("appearance==nullptr");
+    Appearance* appearance = (Appearance*)node;
     node = appearance->getMaterial();
-    Material* material = dynamic_cast<Material*>(node);
-    if(material==nullptr) throw new StrException("material==nullptr");
+    if(node==nullptr || node->isMaterial()==false)
+      throw new StrException("material==nullptr");
+    Material* material = (Material*)node;
     const Color& diffuseColor = material->getDiffuseColor();
 
     // TODO Fri Feb 17 19:35:17 2023
@@ -1376,14 +1585,15 @@ SaverPly::save(const char* filename, SceneGraph& wrl) const {
       Ply* ply = ifsPly->getPly();
       if(ply==nullptr) throw new StrException("ply==nullptr");
 
-      if(save(filename,*ply,indent+"  ",_dataType)==false)
+      if(save(fp,*ply,indent+"  ",_dataType)==false)
         throw new StrException("save(fp,Ply&)==false");
     
       success = true;
 
-    } else if(IndexedFaceSet* ifs = dynamic_cast<IndexedFaceSet*>(node)) {
+    } else if(node!=nullptr && node->isIndexedFaceSet()) {
 
-      if(save(filename,*ifs,indent+"  ",_dataType)==false)
+      IndexedFaceSet* ifs = (IndexedFaceSet*)node;
+      if(save(fp,*ifs,indent+"  ",_dataType)==false)
         throw new StrException("save(fp,IndexedFaceSet&)==false");
     
       success = true;
@@ -43,11 +43,13 @@
 #define SAVER_PLY_HPP
 
 #include <iostream>
+#include <chrono>
 #include <util/Endian.hpp>
 #include <wrl/SceneGraph.hpp>
 #include <wrl/IndexedFaceSet.hpp>
 #include <wrl/IndexedFaceSetPly.hpp>
 #include "Saver.hpp"
+#include "OutputBuffer.hpp"
 
 class SaverPly : public Saver {
 
@@ -58,8 +60,7 @@ public:
 
   virtual const char* ext() const;
 
-  virtual bool
-  save(const char* filename, SceneGraph& wrl) const;
+  using Saver::save;
 
   static  bool
   save(const char* filename, Ply & ply, const string indent="",
@@ -68,11 +69,25 @@ public:
   save(const char* filename, IndexedFaceSet & ifs, const string indent="",
        Ply::DataType dataType=Ply::DataType::ASCII);
 
+  // fp is open for binary writing
+  static  bool
+  save(FILE* fp, Ply & ply, const string indent="",
+       Ply::DataType dataType=Ply::DataType::ASCII);
+  static  bool
+  save(FILE* fp, IndexedFaceSet & ifs, const string indent="",
+       Ply::DataType dataType=Ply::DataType::ASCII);
+
          void setDataType(const Ply::DataType dataType);
   static void setDefaultDataType(const Ply::DataType dataType);
 
   static void setSkipAlpha(const bool value);
 
+  // number of decimals of float values in ASCII files; 6 by default,
+  // as "%f", and negative for the shortest string which reads back
+  // as the same float
+  static void setFloatPrecision(const int precision);
+  static int  getFloatPrecision();
+
   static void setOstream(ostream* ostrm);
   static void setIndent(const string s="");
 
@@ -81,23 +96,58 @@ public:
   static Ply::DataType systemEndian();
   static bool          sameAsSystemEndian(Ply::DataType fileEndian);
 
+  // a fixed size field of a binary record: nComponents values of
+  // valueSize bytes each, or three float colors written as uchars
+  class BinaryField {
+  public:
+    enum class Color { NONE, UCHAR, UCHAR_DOUBLE };
+    const char* data;
+    int         valueSize;
+    int         nComponents;
+    Color       color;
+    BinaryField(const void* d=nullptr, const int size=0, const int n=1,
+                const Color c=Color::NONE):
+      data(static_cast<const char*>(d)),
+      valueSize(size),
+      nComponents(n),
+      color(c) {
+    }
+  };
+
+  static bool getBinaryField
+  (Ply::Element::Property* property, BinaryField& field);
+
+  static void writeBinaryRecords
+  (OutputBuffer& ob, const vector<BinaryField>& field, const int nRecords,
+   const bool swapBytes);
+
   static bool writeBinaryValue
-  (FILE * fp, const Ply::Element::Property::Type listType,
+  (OutputBuffer& ob, const Ply::Element::Property::Type listType,
    const bool swapBytes, int nList);
 
   static bool writeBinaryValue
-  (FILE * fp, const Ply::Element::Property::Type propertyType,
-   const bool swapBytes, void* value, int i);
+  (OutputBuffer& ob, const Ply::Element::Property::Type propertyType,
+   const bool swapBytes, void* value, int i, int nValues=1);
   
-  static bool writeBinaryColorValue
-  (FILE * fp, const bool swapBytes, void* value, int i);
+  static void writeBinaryColorValue
+  (OutputBuffer& ob, void* value, int i);
+
+  static void reportProgress
+  (const int nDone, const int nTotal, int& k0);
+
+  static void getFaceFirst
+  (const vector<int>& coordIndex, vector<int>& faceFirst);
+
+  static void reportThroughput
+  (OutputBuffer& ob, const chrono::steady_clock::time_point& t0,
+   const string& indent);
 
   static bool writeAsciiValue
-  (FILE * fp, const Ply::Element::Property::Type propertyType,
+  (OutputBuffer& ob, const Ply::Element::Property::Type propertyType,
    void* value, int i);
   
-  static bool writeAsciiColorValue
-  (FILE * fp, void* value, int i);
+  static void writeAsciiColorValue
+  (OutputBuffer& ob, void* value, int i);
   
   static bool
   writeHeader(FILE * fp, Ply& ply, const string indent="",
@@ -119,6 +169,11 @@ public:
   writeAsciiData(FILE * fp, IndexedFaceSet& ifs, const string indent="",
                  Ply::DataType dataType=Ply::DataType::ASCII);
 
+protected:
+
+  virtual bool
+  _save(FILE* fp, const char* url, SceneGraph& wrl) const;
+
 private:
 
   const static char* _ext;
@@ -128,6 +183,7 @@ private:
 
   static Ply::DataType _defaultDataType;
   static bool _skipAlpha;
+  static int  _floatPrecision;
 
   Ply::DataType _dataType;
 };
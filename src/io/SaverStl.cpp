@@ -35,15 +35,19 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <cstring>
+#include <cmath>
 
 #include "SaverStl.hpp"
 #include "StrException.hpp"
+#include "OutputBuffer.hpp"
+#include "GzFile.hpp"
+#include "util/Endian.hpp"
 
 #include "wrl/Shape.hpp"
 // #include "wrl/Appearance.hpp"
 // #include "wrl/Material.hpp"
 #include "core/Faces.hpp"
-#include <filesystem>;
+#include <filesystem>
 
 const char* SaverStl::_ext = "stl";
 SaverStl::FileType SaverStl::_fileType = SaverStl::FileType::ASCII;
@@ -59,173 +63,153 @@ bool SaverStl::_saveAscii
 (FILE* fp, const char* solidname, IndexedFaceSet& ifs) const {
 
   int nF = ifs.getNumberOfFaces();
-  vector<float>& coord       = ifs.getCoord();
+  vector<float>  coordBuffer,normalBuffer;
+  const vector<float>& coord  = ifs.readCoord(coordBuffer);
   vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normal      = ifs.getNormal();
+  const vector<float>& normal = ifs.readNormal(normalBuffer);
   vector<int>&   normalIndex = ifs.getNormalIndex();
   // already checked that ifs.getNormalPerVertex()==false
   bool           npf_indexed = (static_cast<int>(normalIndex.size())==nF);
 
   Faces faces = Faces(ifs.getNumberOfCoord(), coordIndex);
-  fprintf(fp,"solid %s\n",solidname);
-  int iF;
-  for(iF=0;iF<nF;iF++) { // for each face ...
-      fprintf(fp, "facet normal ");
-      //3 coordinates x y z for normal
-      for (int i = 0; i < 3; ++i) {
-          fprintf(fp,"%f ",normal[iF*3+i]);
-      }
-      fprintf(fp,"\n  outer loop\n");
-      for (int i = 0; i < faces.getFaceSize(iF); ++i) {
-          fprintf(fp,"    vertex ");
+  OutputBuffer ob(fp);
+  ob.printf("solid %s\n",solidname);
+  ob.putParallel
+    (nF,[&](OutputBuffer& ob, const int iF0, const int iF1) {
+      for(int iF=iF0;iF<iF1;iF++) { // for each face ...
+        int iN = (npf_indexed)?normalIndex[iF]:iF;
+        ob.putString("facet normal ");
+        //3 coordinates x y z for normal
+        for (int i = 0; i < 3; ++i) {
+          ob.putFloat(normal[iN*3+i]);
+          ob.putChar(' ');
+        }
+        ob.putString("\n  outer loop\n");
+        for (int i = 0; i < faces.getFaceSize(iF); ++i) {
+          ob.putString("    vertex ");
           int corner = faces.getFaceVertex(iF,i);
           //3 coordinates x y z for vertex
           for (int j = 0; j < 3; ++j) {
-              fprintf(fp,"%f ",coord[corner*3+j]);
+            ob.putFloat(coord[corner*3+j]);
+            ob.putChar(' ');
           }
-          fprintf(fp,"\n");
+          ob.putChar('\n');
+        }
+        ob.putString("  endloop\n");
+        ob.putString("endfacet\n");
       }
-      fprintf(fp,"  endloop\n");
-      fprintf(fp,"endfacet\n");
-
-  }
+    });
 
-  fprintf(fp,"endsolid %s",solidname);
+  ob.printf("endsolid %s",solidname);
 
-  return true;
+  return ob.flush();
 }
 
 //////////////////////////////////////////////////////////////////////
 bool SaverStl::_saveBinary
 (FILE* fp, const char* solidname, IndexedFaceSet& ifs) const {
 
-  int nF = ifs.getNumberOfFaces();
-  vector<float>& coord       = ifs.getCoord();
+  vector<float>  coordBuffer,normalBuffer;
+  const vector<float>& coord  = ifs.readCoord(coordBuffer);
   vector<int>&   coordIndex  = ifs.getCoordIndex();
-  vector<float>& normal      = ifs.getNormal();
+  const vector<float>& normal = ifs.readNormal(normalBuffer);
   vector<int>&   normalIndex = ifs.getNormalIndex();
-  // already checked that ifs.getNormalPerVertex()==false
-  bool           npf_indexed = (static_cast<int>(normalIndex.size())==nF);
-
-  size_t written = 0;
-
-  // allocate header and initialize to zero
-  char header[80];
-  memset(header,0x00,80);
-  snprintf(header,80,"BINARY STL %s Exported by DGP2025",solidname);
-
-  written = fwrite(header,1,80,fp);
-  if(written!=80)
-    throw new StrException("unable to write binary STL header");
-
-  uint32_t nTriangles = static_cast<uint32_t>(nF);
-  written = fwrite((void*)&nTriangles,1,4,fp);
-  if(written<4)
-    throw new StrException("unable to write number of triangles");
-
-  uint16_t abc = 0x0000; // attribute byte count
-
-  int iF,iV0,iV1,iV2,iN;
-  float n[3],v[3];
-  for(iF=0;iF<nF;iF++) {
-
-    iN   = (npf_indexed)?normalIndex[iF]:iF;
-    n[0] = normal[3*iN  ];
-    n[1] = normal[3*iN+1];
-    n[2] = normal[3*iN+2];
-    written = fwrite(n,1,12,fp);
-    if(written!=12)
-      throw new StrException("unable to write normal vector");
-
-    iV0  = coordIndex[4*iF+0];
-    v[0] = coord[3*iV0  ];
-    v[1] = coord[3*iV0+1];
-    v[2] = coord[3*iV0+2];
-    written = fwrite(v,1,12,fp);
-    if(written!=12)
-      throw new StrException("unable to write vertex 0");
 
-    iV1  = coordIndex[4*iF+1];
-    v[0] = coord[3*iV1  ];
-    v[1] = coord[3*iV1+1];
-    v[2] = coord[3*iV1+2];
-    written = fwrite(v,1,12,fp);
-    if(written!=12)
-      throw new StrException("unable to write vertex 1");
+  // per face normals are used when present; otherwise the normal of
+  // each triangle is computed here, without a computeNormalPerFace pass
+  IndexedFaceSet::Binding nb = ifs.getNormalBinding();
+  bool npf_non_indexed = (nb==IndexedFaceSet::Binding::PB_PER_FACE);
+  bool npf_indexed     = (nb==IndexedFaceSet::Binding::PB_PER_FACE_INDEXED);
+
+  // faces with more than three vertices are triangulated as fans
+  // (v0,v1,v2),(v0,v2,v3),... ; faces with less than three are skipped
+  int nCorners = static_cast<int>(coordIndex.size());
+  uint32_t nTriangles = 0;
+  int i0,i1,nFs;
+  for(i0=i1=0;i1<nCorners;i1++) {
+    if(coordIndex[i1]>=0) continue;
+    nFs = i1-i0;
+    if(nFs>2) nTriangles += static_cast<uint32_t>(nFs-2);
+    i0 = i1+1;
+  }
 
-    iV2  = coordIndex[4*iF+2];
-    v[0] = coord[3*iV2  ];
-    v[1] = coord[3*iV2+1];
-    v[2] = coord[3*iV2+2];
-    written = fwrite(v,1,12,fp);
-    if(written!=12)
-      throw new StrException("unable to write vertex 2");
+  // STL is little endian
+  bool swapBytes = (Endian::isLittleEndianSystem()==false);
 
-    written = fwrite(&abc,1,2,fp);
-    if(written<2)
-      throw new StrException("unable to write atribute byte count");
+  OutputBuffer ob(fp);
 
+  // header initialized to zero
+  char* header = ob.reserve(80);
+  memset(header,0x00,80);
+  snprintf(header,80,"BINARY STL %s Exported by DGP2025",solidname);
+  ob.advance(80);
+  ob.putBinary(nTriangles,swapBytes);
+
+  int iF,iN,iC,iV0,iV1,iV2;
+  float n[3],e1[3],e2[3],len;
+  char* record;
+  for(iF=i0=i1=0;i1<nCorners;i1++) {
+    if(coordIndex[i1]>=0) continue;
+    if(i1-i0>2) {
+      if(npf_non_indexed || npf_indexed) {
+        iN   = (npf_indexed)?normalIndex[iF]:iF;
+        n[0] = normal[3*iN  ];
+        n[1] = normal[3*iN+1];
+        n[2] = normal[3*iN+2];
+      }
+      iV0 = coordIndex[i0];
+      for(iC=i0+1;iC+1<i1;iC++) {
+        iV1 = coordIndex[iC];
+        iV2 = coordIndex[iC+1];
+        if(npf_non_indexed==false && npf_indexed==false) {
+          e1[0] = coord[3*iV1  ]-coord[3*iV0  ];
+          e1[1] = coord[3*iV1+1]-coord[3*iV0+1];
+          e1[2] = coord[3*iV1+2]-coord[3*iV0+2];
+          e2[0] = coord[3*iV2  ]-coord[3*iV0  ];
+          e2[1] = coord[3*iV2+1]-coord[3*iV0+1];
+          e2[2] = coord[3*iV2+2]-coord[3*iV0+2];
+          n[0]  = e1[1]*e2[2]-e1[2]*e2[1];
+          n[1]  = e1[2]*e2[0]-e1[0]*e2[2];
+          n[2]  = e1[0]*e2[1]-e1[1]*e2[0];
+          len   = sqrtf(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+          if(len>0.0f) { n[0]/=len; n[1]/=len; n[2]/=len; }
+        }
+        // 50 bytes per triangle : normal, 3 vertices, attribute byte count
+        record = ob.reserve(50);
+        memcpy(record   ,n            ,12);
+        memcpy(record+12,&coord[3*iV0],12);
+        memcpy(record+24,&coord[3*iV1],12);
+        memcpy(record+36,&coord[3*iV2],12);
+        memset(record+48,0x00,2);
+        if(swapBytes) Endian::swapArray(record,12,4);
+        ob.advance(50);
+      }
+    }
+    iF++;
+    i0 = i1+1;
   }
 
-  return true;
+  return ob.flush();
 }
 
 //////////////////////////////////////////////////////////////////////
-bool SaverStl::save(const char* filename, SceneGraph& wrl) const {
+bool SaverStl::_save(FILE* fp, const char* url, SceneGraph& wrl) const {
   bool success = false;
-  FILE* fp = (FILE*)0;
   try {
     // Check these conditions
-    if(filename==(char*)0)
-      throw new StrException("empty filename");
     // 1) the SceneGraph should have a single child
     if(wrl.getNumberOfChildren()!=1)
       throw new StrException("number of SceneGraph children != 1");
     // 2) the child should be a Shape node
     Node* child_0 = wrl[0];
-    Shape* shape = dynamic_cast<Shape*>(child_0);
-    if(shape==(Shape*)0)
+    if(child_0->isShape()==false)
       throw new StrException("first SceneGraph child not a Shape node");
+    Shape* shape = (Shape*)child_0;
     // 3) the geometry of the Shape node should be an IndexedFaceSet node
     Node* geometry = shape->getGeometry();
-    IndexedFaceSet* ifs = dynamic_cast<IndexedFaceSet*>(geometry);
-    if(ifs==(IndexedFaceSet*)0)
+    if(geometry==(Node*)0 || geometry->isIndexedFaceSet()==false)
       throw new StrException("Shape geometry not an IndexedFaceSet");
-    // - construct an instance of the Faces class from the IndexedFaceSet
-    // int nV = ifs->getNumberOfCoord();
-    // vector<float>& coord      = ifs->getCoord();
-    vector<int>&   coordIndex = ifs->getCoordIndex();
-
-    // 4) the IndexedFaceSet should be a triangle mesh
-    // - use the Faces class, or directly the coordIndex array to
-    //   verify that all the faces are triangles
-    // - if you find a face with more than thre vertices
-    //   throw an exception
-
-    // Faces faces(nV,coordIndex);
-    // int nF = faces.getNumberOfFaces();
-    // if(nF<1)
-    //   throw new StrException("has no faces");
-    // for(int iF=0;iF<nF;iF++) {
-    //   if(faces.getFaceSize(iF)!=3)
-    //     throw new StrException("is not a triangle mesh");
-    // }
-
-    int i0,i1,nFs;
-    for(i0=i1=0;i0<static_cast<int>(coordIndex.size());i1++) {
-      if(coordIndex[i1]>=0) continue;
-      nFs = i1-i0; // size of face
-      if(nFs!=3)
-        throw new StrException("is not a triangle mesh");
-      i0=i1+1;
-    }
-
-    // 5) verify that the IndexedFaceSet has normals per face
-    IndexedFaceSet::Binding nb = ifs->getNormalBinding();
-    bool npf_non_indexed = (nb==IndexedFaceSet::Binding::PB_PER_FACE);
-    bool npf_indexed     = (nb==IndexedFaceSet::Binding::PB_PER_FACE_INDEXED);
-    if(npf_non_indexed==false && npf_indexed==false)
-        throw new StrException("does not have normals per face");
+    IndexedFaceSet* ifs = (IndexedFaceSet*)geometry;
 
     // default solid name
     char solidname[256] = "solidname";
@@ -234,42 +218,65 @@ bool SaverStl::save(const char* filename, SceneGraph& wrl) const {
       snprintf(solidname,256,"%s",ifs_name.c_str());
     } else {
       // otherwise use filename, but first remove directory and extension
-        filesystem::path filePath = filesystem::path(filename);
+        filesystem::path filePath = filesystem::path(GzFile::stripSuffix(url));
         string name = filePath.stem().string();
         snprintf(solidname,256,"%s",name.c_str());
     }
 
     if(_fileType==SaverStl::FileType::ASCII) { ///////////////////////
 
-      // if (all the conditions are satisfied) try to open the file
-      fp = fopen(filename,"w");
-      if( fp==(FILE*)0)
-        throw new StrException("unable to open ASCII STL outputfile");
+      // the binary writer triangulates polygonal faces and computes
+      // missing face normals; the ASCII writer requires both
+      // - construct an instance of the Faces class from the IndexedFaceSet
+      // int nV = ifs->getNumberOfCoord();
+      // vector<float>& coord      = ifs->getCoord();
+      vector<int>&   coordIndex = ifs->getCoordIndex();
+
+      // 4) the IndexedFaceSet should be a triangle mesh
+      // - use the Faces class, or directly the coordIndex array to
+      //   verify that all the faces are triangles
+      // - if you find a face with more than thre vertices
+      //   throw an exception
+
+      // Faces faces(nV,coordIndex);
+      // int nF = faces.getNumberOfFaces();
+      // if(nF<1)
+      //   throw new StrException("has no faces");
+      // for(int iF=0;iF<nF;iF++) {
+      //   if(faces.getFaceSize(iF)!=3)
+      //     throw new StrException("is not a triangle mesh");
+      // }
+
+      int i0,i1,nFs;
+      for(i0=i1=0;i0<static_cast<int>(coordIndex.size());i1++) {
+        if(coordIndex[i1]>=0) continue;
+        nFs = i1-i0; // size of face
+        if(nFs!=3)
+          throw new StrException("is not a triangle mesh");
+        i0=i1+1;
+      }
+
+      // 5) verify that the IndexedFaceSet has normals per face
+      IndexedFaceSet::Binding nb = ifs->getNormalBinding();
+      bool npf_non_indexed = (nb==IndexedFaceSet::Binding::PB_PER_FACE);
+      bool npf_indexed     = (nb==IndexedFaceSet::Binding::PB_PER_FACE_INDEXED);
+      if(npf_non_indexed==false && npf_indexed==false)
+          throw new StrException("does not have normals per face");
 
       if(_saveAscii(fp,solidname,*ifs)==false)
         throw new StrException("unable to save ASCII STL outputfile");
-    
-      fclose(fp);
 
     } else /* if(_fileType==FileType::BINARY) */ { ///////////////////
 
-      // if (all the conditions are satisfied) try to open the file
-      fp = fopen(filename,"wb");
-      if( fp==(FILE*)0)
-        throw new StrException("unable to open BINARY STL outputfile");
-
       if(_saveBinary(fp,solidname,*ifs)==false)
         throw new StrException("unable to save BINARY STL outputfile");
 
-      fclose(fp);
-
     } ////////////////////////////////////////////////////////////////
     
     success = true;
     
   } catch(StrException* e) { 
     
-    if(fp!=(FILE*)0) fclose(fp);
     fprintf(stderr,"SaverStl | ERROR | %s\n",e->what());
     delete e;
   }
@@ -57,11 +57,14 @@ public:
   SaverStl()  {};
   ~SaverStl() {};
 
-  bool  save(const char* filename, SceneGraph& wrl) const;
   const char* ext() const { return _ext; }
 
   static void setFileType(const FileType ft);
   
+protected:
+
+  bool  _save(FILE* fp, const char* url, SceneGraph& wrl) const;
+
 private:
 
   static FileType _fileType; // default : ASCII
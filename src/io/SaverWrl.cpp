@@ -35,10 +35,96 @@
 #include "SaverWrl.hpp"
 
 const char* SaverWrl::_ext = "wrl";
+int         SaverWrl::_floatPrecision = 4;
+
+//////////////////////////////////////////////////////////////////////
+// static
+void SaverWrl::setFloatPrecision(const int precision) {
+  _floatPrecision = precision;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+int SaverWrl::getFloatPrecision() {
+  return _floatPrecision;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// "%8.4f" by default; shortest round trip values are not padded
+void SaverWrl::putFloat(OutputBuffer& ob, const float value) {
+  if(_floatPrecision>=0)
+    ob.putFloat(value,_floatPrecision,8);
+  else
+    ob.putFloat(value,-1);
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// one indented value per item, with n values per line
+void SaverWrl::putFloatArray
+(OutputBuffer& ob, const string& indent, const vector<float>& value,
+ const int n) {
+  ob.putParallel
+    (static_cast<int>(value.size()),
+     [&indent,&value,n](OutputBuffer& ob, const int i0, const int i1) {
+      for(int i=i0;i<i1;i++) {
+        ob.putString(indent);
+        putFloat(ob,value[i]);
+        ob.putChar(' ');
+        if(i%n==n-1) { ob.putString(indent); ob.putChar('\n'); }
+      }
+    });
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+// one indented index per item, with a line break after each -1
+void SaverWrl::putIndexArray
+(OutputBuffer& ob, const string& indent, const vector<int>& index,
+ const int width) {
+  ob.putParallel
+    (static_cast<int>(index.size()),
+     [&indent,&index,width](OutputBuffer& ob, const int i0, const int i1) {
+      for(int i=i0;i<i1;i++) {
+        ob.putString(indent);
+        ob.putInt(index[i],width);
+        ob.putChar(' ');
+        if(index[i]<0) { ob.putString(indent); ob.putChar('\n'); }
+      }
+    });
+}
+
+//////////////////////////////////////////////////////////////////////
+// Writes "DEF name type {" for named nodes, and "type {" for the
+// others. A node shared by several parents is written in full the
+// first time, with a generated DEF name if it has none, and as "USE
+// name" afterwards; returns false in that case.
+bool SaverWrl::putNodeHeader
+(OutputBuffer& ob, const char* str, Node* node, const char* type) const {
+  map<const Node*,string>::iterator i = _useName.find(node);
+  if(i!=_useName.end() && _defNode[i->second]==node) {
+    ob.printf("%sUSE %s\n",str,i->second.c_str());
+    return false;
+  }
+  string name = node->getName();
+  if(node->getRefCount()>1) {
+    if(name=="")
+      name = string(type)+"_"+to_string(_useName.size());
+    _useName[node] = name;
+  }
+  if(name=="") {
+    ob.printf("%s%s {\n",str,type);
+  } else {
+    ob.printf("%sDEF %s %s {\n",str,name.c_str(),type);
+    _defNode[name] = node;
+  }
+  return true;
+}
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveMaterial
-(FILE* fp, string indent, Material* material) const {
+(OutputBuffer& ob, string indent, Material* material) const {
   if(material==(Material*)0) return;
 
   const char* str = indent.c_str();
@@ -52,45 +138,41 @@ void SaverWrl::saveMaterial
   //   SFFloat transparency     0
   // }
 
-  const string& name = material->getName();
-  if(name=="")
-    fprintf(fp,"%sMaterial {\n",str);
-  else
-    fprintf(fp,"%sDEF %s Material {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,material,"Material")==false) return;
 
   float  ambientIntensity = material->getAmbientIntensity();
   if(ambientIntensity!=0.2f)
-    fprintf(fp,"%s ambientIntensity %8.4f\n",str,ambientIntensity);
+    ob.printf("%s ambientIntensity %8.4f\n",str,ambientIntensity);
 
   Color& diffuseColor     = material->getDiffuseColor();
   if(diffuseColor.r!=0.8f||diffuseColor.g!=0.8f||diffuseColor.b!=0.8f)
-    fprintf(fp,"%s diffuseColor %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s diffuseColor %8.4f %8.4f %8.4f\n",str,
             diffuseColor.r,diffuseColor.g,diffuseColor.b);
 
   Color& emissiveColor    = material->getEmissiveColor();
   if(emissiveColor.r!=0.0f||emissiveColor.g!=0.0f||emissiveColor.b!=0.0f)
-    fprintf(fp,"%s emissiveColor %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s emissiveColor %8.4f %8.4f %8.4f\n",str,
             emissiveColor.r,emissiveColor.g,emissiveColor.b);
 
   float  shininess        = material->getShininess();
   if(shininess!=0.2f)
-    fprintf(fp,"%s shininess %8.4f\n",str,shininess);
+    ob.printf("%s shininess %8.4f\n",str,shininess);
 
   Color  specularColor    = material->getSpecularColor();
   if(specularColor.r!=0.0f||specularColor.g!=0.0f||specularColor.b!=0.0f)
-    fprintf(fp,"%s specularColor %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s specularColor %8.4f %8.4f %8.4f\n",str,
             specularColor.r,specularColor.g,specularColor.b);
 
   float  transparency     = material->getTransparency();
   if(transparency!=0.2f)
-    fprintf(fp,"%s transparency %8.4f\n",str,transparency);
+    ob.printf("%s transparency %8.4f\n",str,transparency);
 
-  fprintf(fp,"%s}\n",str);
+  ob.printf("%s}\n",str);
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveImageTexture
-(FILE* fp, string indent, ImageTexture* imageTexture) const {
+(OutputBuffer& ob, string indent, ImageTexture* imageTexture) const {
   if(imageTexture==(ImageTexture*)0) return;
 
   const char* str = indent.c_str();
@@ -101,36 +183,32 @@ void SaverWrl::saveImageTexture
   //   SFBool repeatT TRUE
   // }
 
-  const string& name = imageTexture->getName();
-  if(name=="")
-    fprintf(fp,"%sImageTexture {\n",str);
-  else
-    fprintf(fp,"%sDEF %s ImageTexture {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,imageTexture,"ImageTexture")==false) return;
 
   vector<string>& url = imageTexture->getUrl();
   if(url.size()) {
-    fprintf(fp,"%s url %s\n",str,url[0].c_str());
+    ob.printf("%s url %s\n",str,url[0].c_str());
   } else if(url.size()>1) {
-    fprintf(fp,"%s url [\n",str);
+    ob.printf("%s url [\n",str);
     for(int i=0;i<(int)url.size();i++)
-      fprintf(fp,"%s  %s\n",str,url[i].c_str());
-    fprintf(fp,"%s ]\n",str);
+      ob.printf("%s  %s\n",str,url[i].c_str());
+    ob.printf("%s ]\n",str);
   }
 
   bool repeatS = imageTexture->getRepeatS();
   if(repeatS!=true)
-    fprintf(fp,"%s repeatS FALSE\n",str);
+    ob.printf("%s repeatS FALSE\n",str);
 
   bool repeatT = imageTexture->getRepeatT();
   if(repeatT!=true)
-    fprintf(fp,"%s repeatT FALSE\n",str);
+    ob.printf("%s repeatT FALSE\n",str);
 
-  fprintf(fp,"%s}\n",str);
+  ob.printf("%s}\n",str);
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveAppearance
-(FILE* fp, string indent, Appearance* appearance) const {
+(OutputBuffer& ob, string indent, Appearance* appearance) const {
   if(appearance==(Appearance*)0) return;
 
   const char* str = indent.c_str();
@@ -143,33 +221,29 @@ void SaverWrl::saveAppearance
 
   Node* node;
 
-  const string& name = appearance->getName();
-  if(name=="")
-    fprintf(fp,"%sAppearance {\n",str);
-  else
-    fprintf(fp,"%sDEF %s Appearance {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,appearance,"Appearance")==false) return;
 
   node = appearance->getMaterial();
   if(node!=(Node*)0) {
     Material* material = (Material*)node;
-    fprintf(fp,"%s material\n",str);
-    saveMaterial(fp,indent+"  ",material);
+    ob.printf("%s material\n",str);
+    saveMaterial(ob,indent+"  ",material);
   }
   node = appearance->getTexture();
   if(node!=(Node*)0) {
     if(node->isImageTexture()) {
       ImageTexture* imageTexture = (ImageTexture*)node;
-      fprintf(fp,"%s texture\n",str);
-      saveImageTexture(fp,indent+"  ",imageTexture);
+      ob.printf("%s texture\n",str);
+      saveImageTexture(ob,indent+"  ",imageTexture);
     }
   }
 
-  fprintf(fp,"%s}\n",str);
+  ob.printf("%s}\n",str);
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveIndexedFaceSet
-(FILE* fp, string indent, IndexedFaceSet* indexedFaceSet) const {
+(OutputBuffer& ob, string indent, IndexedFaceSet* indexedFaceSet) const {
   if(indexedFaceSet==(IndexedFaceSet*)0) return;
 
   const char* str = indent.c_str();
@@ -191,11 +265,7 @@ void SaverWrl::saveIndexedFaceSet
   //   MFInt32 texCoordIndex     []        # [-1,)
   // }
 
-  const string& name = indexedFaceSet->getName();
-  if(name=="")
-    fprintf(fp,"%sIndexedFaceSet {\n",str);
-  else
-    fprintf(fp,"%sDEF %s IndexedFaceSet {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,indexedFaceSet,"IndexedFaceSet")==false) return;
 
   IndexedFaceSet& ifs = *indexedFaceSet;
 
@@ -205,46 +275,40 @@ void SaverWrl::saveIndexedFaceSet
   bool&          solid           = ifs.getSolid();
   bool&          normalPerVertex = ifs.getNormalPerVertex();
   bool&          colorPerVertex  = ifs.getColorPerVertex();
-  vector<float>& coord           = ifs.getCoord();
+  // compact encodings are decoded into temporary buffers
+  vector<float>  coordBuffer,normalBuffer,colorBuffer;
+  const vector<float>& coord     = ifs.readCoord(coordBuffer);
   vector<int>&   coordIndex      = ifs.getCoordIndex();
-  vector<float>& normal          = ifs.getNormal();
+  const vector<float>& normal    = ifs.readNormal(normalBuffer);
   vector<int>&   normalIndex     = ifs.getNormalIndex();
-  vector<float>& color           = ifs.getColor();
+  const vector<float>& color     = ifs.readColor(colorBuffer);
   vector<int>&   colorIndex      = ifs.getColorIndex();
   vector<float>& texCoord        = ifs.getTexCoord();
   vector<int>&   texCoordIndex   = ifs.getTexCoordIndex();
 
 
   // default ccw TRUE
-  if(ccw   ==false)   fprintf(fp,"%s ccw FALSE\n",str);
+  if(ccw   ==false)   ob.printf("%s ccw FALSE\n",str);
   // default convex TRUE
-  if(convex==false)   fprintf(fp,"%s convex FALSE\n",str);
+  if(convex==false)   ob.printf("%s convex FALSE\n",str);
   // default solid TRUE
-  if(solid ==false)   fprintf(fp,"%s solid FALSE\n",str);
+  if(solid ==false)   ob.printf("%s solid FALSE\n",str);
   // default creaseAngle 0.0
-  if(creaseAngle>0.0) fprintf(fp,"%s creaseAngle %8.4f\n",str,creaseAngle);
+  if(creaseAngle>0.0) ob.printf("%s creaseAngle %8.4f\n",str,creaseAngle);
 
   if(coordIndex.size()>0) {
-    int i;
-    fprintf(fp,"%s coordIndex [\n",str);
-    for(i=0;i<(int)coordIndex.size();i++) {
-      fprintf(fp,"%s%6d ",str,coordIndex[i]);
-      if(coordIndex[i]<0) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s ]\n",str);
+    ob.printf("%s coordIndex [\n",str);
+    putIndexArray(ob,indent,coordIndex,6);
+    ob.printf("%s ]\n",str);
   }
 
   // COORD_PER_VERTEX
   if(coord.size()>0) {
-    int i;
-    fprintf(fp,"%s coord Coordinate {\n",str);
-    fprintf(fp,"%s  point [\n",str);
-    for(i=0;i<(int)coord.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,coord[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    ob.printf("%s coord Coordinate {\n",str);
+    ob.printf("%s  point [\n",str);
+    putFloatArray(ob,indent,coord,3);
+    ob.printf("%s  ]\n",str);
+    ob.printf("%s }\n",str);
   }
 
   // if(normal.size()==0)
@@ -265,26 +329,19 @@ void SaverWrl::saveIndexedFaceSet
   //     normal.size()/3==coord.size()/3
 
   if(normal.size()>0) {
-    int i;
-    fprintf(fp,"%s normalPerVertex %s\n",str,
+    ob.printf("%s normalPerVertex %s\n",str,
             (normalPerVertex==true)?"TRUE":"FALSE");
 
-    fprintf(fp,"%s normal Normal {\n",str);
-    fprintf(fp,"%s  vector [\n",str);
-    for(i=0;i<(int)normal.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,normal[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    ob.printf("%s normal Normal {\n",str);
+    ob.printf("%s  vector [\n",str);
+    putFloatArray(ob,indent,normal,3);
+    ob.printf("%s  ]\n",str);
+    ob.printf("%s }\n",str);
 
     if(normalIndex.size()>0) {
-      fprintf(fp,"%s normalIndex [\n",str);
-      for(i=0;i<(int)normalIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,normalIndex[i]);
-        if(normalIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      ob.printf("%s normalIndex [\n",str);
+      putIndexArray(ob,indent,normalIndex,0);
+      ob.printf("%s ]\n",str);
     }
   }
 
@@ -306,26 +363,19 @@ void SaverWrl::saveIndexedFaceSet
   //     color.size()/3==coord.size()/3
 
   if(color.size()>0) {
-    int i;
-    fprintf(fp,"%s colorPerVertex %s\n",str,
+    ob.printf("%s colorPerVertex %s\n",str,
             (colorPerVertex==true)?"TRUE":"FALSE");
 
-    fprintf(fp,"%s color Color {\n",str);
-    fprintf(fp,"%s  color [\n",str);
-    for(i=0;i<(int)color.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,color[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    ob.printf("%s color Color {\n",str);
+    ob.printf("%s  color [\n",str);
+    putFloatArray(ob,indent,color,3);
+    ob.printf("%s  ]\n",str);
+    ob.printf("%s }\n",str);
 
     if(colorIndex.size()>0) {
-      fprintf(fp,"%s colorIndex [\n",str);
-      for(i=0;i<(int)colorIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,colorIndex[i]);
-        if(colorIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      ob.printf("%s colorIndex [\n",str);
+      putIndexArray(ob,indent,colorIndex,0);
+      ob.printf("%s ]\n",str);
     }
   }
 
@@ -339,33 +389,26 @@ void SaverWrl::saveIndexedFaceSet
   //   texCoord.size()/2==coord.size()/3
 
   if(texCoord.size()>0) {
-    int i;
 
-    fprintf(fp,"%s texCoord TextureCoordinate {\n",str);
-    fprintf(fp,"%s  point [\n",str);
-    for(i=0;i<(int)texCoord.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,texCoord[i]);
-      if(i%2==1) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    ob.printf("%s texCoord TextureCoordinate {\n",str);
+    ob.printf("%s  point [\n",str);
+    putFloatArray(ob,indent,texCoord,2);
+    ob.printf("%s  ]\n",str);
+    ob.printf("%s }\n",str);
 
     if(texCoordIndex.size()>0) {
-      fprintf(fp,"%s texCoordIndex [\n",str);
-      for(i=0;i<(int)texCoordIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,texCoordIndex[i]);
-        if(texCoordIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      ob.printf("%s texCoordIndex [\n",str);
+      putIndexArray(ob,indent,texCoordIndex,0);
+      ob.printf("%s ]\n",str);
     }
   }
 
-  fprintf(fp,"%s}\n",str); // IndexedFaceSet
+  ob.printf("%s}\n",str); // IndexedFaceSet
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveIndexedLineSet
-(FILE* fp, string indent, IndexedLineSet* indexedLineSet) const {
+(OutputBuffer& ob, string indent, IndexedLineSet* indexedLineSet) const {
   if(indexedLineSet==(IndexedLineSet*)0) return;
 
   const char* str = indent.c_str();
@@ -378,11 +421,7 @@ void SaverWrl::saveIndexedLineSet
   //   SFBool  colorPerVertex    TRUE
   // }
 
-  const string& name = indexedLineSet->getName();
-  if(name=="")
-    fprintf(fp,"%sIndexedLineSet {\n",str);
-  else
-    fprintf(fp,"%sDEF %s IndexedLineSet {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,indexedLineSet,"IndexedLineSet")==false) return;
 
   IndexedLineSet& ifs = *indexedLineSet;
 
@@ -393,58 +432,43 @@ void SaverWrl::saveIndexedLineSet
   bool&          colorPerVertex  = ifs.getColorPerVertex();
 
   {
-    int i;
-    fprintf(fp,"%s coordIndex [\n",str);
-    for(i=0;i<(int)coordIndex.size();i++) {
-      fprintf(fp,"%s%6d ",str,coordIndex[i]);
-      if(coordIndex[i]<0) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s ]\n",str);
+    ob.printf("%s coordIndex [\n",str);
+    putIndexArray(ob,indent,coordIndex,6);
+    ob.printf("%s ]\n",str);
   }
 
   // COORD_PER_VERTEX
   {
-    int i;
-    fprintf(fp,"%s coord Coordinate {\n",str);
-    fprintf(fp,"%s  point [\n",str);
-    for(i=0;i<(int)coord.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,coord[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    ob.printf("%s coord Coordinate {\n",str);
+    ob.printf("%s  point [\n",str);
+    putFloatArray(ob,indent,coord,3);
+    ob.printf("%s  ]\n",str);
+    ob.printf("%s }\n",str);
   }
 
   if(color.size()>0) {
-    int i;
-    fprintf(fp,"%s colorPerVertex %s\n",str,
+    ob.printf("%s colorPerVertex %s\n",str,
             (colorPerVertex==true)?"TRUE":"FALSE");
 
-    fprintf(fp,"%s color Color {\n",str);
-    fprintf(fp,"%s  color [\n",str);
-    for(i=0;i<(int)color.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,color[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    ob.printf("%s color Color {\n",str);
+    ob.printf("%s  color [\n",str);
+    putFloatArray(ob,indent,color,3);
+    ob.printf("%s  ]\n",str);
+    ob.printf("%s }\n",str);
 
     if(colorIndex.size()>0) {
-      fprintf(fp,"%s colorIndex [\n",str);
-      for(i=0;i<(int)colorIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,colorIndex[i]);
-        if(colorIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      ob.printf("%s colorIndex [\n",str);
+      putIndexArray(ob,indent,colorIndex,0);
+      ob.printf("%s ]\n",str);
     }
   }
 
-  fprintf(fp,"%s}\n",str); // IndexedLineSet
+  ob.printf("%s}\n",str); // IndexedLineSet
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveShape
-(FILE* fp, string indent, Shape* shape) const {
+(OutputBuffer& ob, string indent, Shape* shape) const {
   if(shape==(Shape*)0) return;
 
   const char* str = indent.c_str();
@@ -456,38 +480,34 @@ void SaverWrl::saveShape
 
   Node* node;
 
-  const string& name = shape->getName();
-  if(name=="")
-    fprintf(fp,"%sShape {\n",str);
-  else
-    fprintf(fp,"%sDEF %s Shape {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,shape,"Shape")==false) return;
 
   node = shape->getAppearance();
   if(node!=(Node*)0) {
-    fprintf(fp,"%s appearance\n",str);
+    ob.printf("%s appearance\n",str);
     Appearance* appearance = (Appearance*)node;
-    saveAppearance(fp,indent+"  ", appearance);
+    saveAppearance(ob,indent+"  ", appearance);
   }
   node = shape->getGeometry();
   if(node!=(Node*)0) {
     if(node->isIndexedFaceSet()) {
-      fprintf(fp,"%s geometry\n",str);
+      ob.printf("%s geometry\n",str);
       IndexedFaceSet* indexedFaceSet = (IndexedFaceSet*)node;
-      saveIndexedFaceSet(fp,indent+"  ",indexedFaceSet);
+      saveIndexedFaceSet(ob,indent+"  ",indexedFaceSet);
     } else if(node->isIndexedLineSet()) {
-      fprintf(fp,"%s geometry\n",str);
+      ob.printf("%s geometry\n",str);
       IndexedLineSet* indexedLineSet = (IndexedLineSet*)node;
-      saveIndexedLineSet(fp,indent+"  ",indexedLineSet);
+      saveIndexedLineSet(ob,indent+"  ",indexedLineSet);
     } else {
       // TBD
     }
   }
-  fprintf(fp,"%s}\n",str);
+  ob.printf("%s}\n",str);
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveTransform
-(FILE* fp, string indent, Transform* transform) const {
+(OutputBuffer& ob, string indent, Transform* transform) const {
   if(transform==(Transform*)0) return;
 
   const char* str = indent.c_str();
@@ -503,76 +523,72 @@ void SaverWrl::saveTransform
   //   MFNode     children          []
   // }
 
-  const string& name = transform->getName();
-  if(name=="")
-    fprintf(fp,"%sTransform {\n",str);
-  else
-    fprintf(fp,"%sDEF %s Transform {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,transform,"Transform")==false) return;
 
   Vec3f&    center           = transform->getCenter();
   if(center.x!=0.0f || center.y!=0.0f || center.z!= 0.0f)
-    fprintf(fp,"%s center %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s center %8.4f %8.4f %8.4f\n",str,
             center.x,center.y,center.z);
 
   Rotation& rotation         = transform->getRotation();
   Vec3f&    axis             = rotation.getAxis();
   float     angle            = rotation.getAngle();
   if(axis.x!=0.0f || axis.y!=0.0f || axis.z!= 1.0f || angle!= 0.0f)
-    fprintf(fp,"%s rotation %8.4f %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s rotation %8.4f %8.4f %8.4f %8.4f\n",str,
             axis.x,axis.y,axis.z,angle);
 
   Vec3f&    scale            = transform->getScale();
   if(scale.x!=1.0f || scale.y!=1.0f || scale.z!= 1.0f)
-    fprintf(fp,"%s scale %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s scale %8.4f %8.4f %8.4f\n",str,
             scale.x,scale.y,scale.z);
 
   Rotation& scaleOrientation = transform->getScaleOrientation();
             axis             = scaleOrientation.getAxis();
             angle            = scaleOrientation.getAngle();
   if(axis.x!=0.0f || axis.y!=0.0f || axis.z!= 1.0f || angle!= 0.0f)
-    fprintf(fp,"%s rotation %8.4f %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s rotation %8.4f %8.4f %8.4f %8.4f\n",str,
             axis.x,axis.y,axis.z,angle);
 
   Vec3f&    translation      = transform->getTranslation();
   if(translation.x!=0.0f || translation.y!=0.0f || translation.z!= 0.0f)
-    fprintf(fp,"%s translation %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s translation %8.4f %8.4f %8.4f\n",str,
             translation.x,translation.y,translation.z);
 
   Vec3f&    bboxCenter       = transform->getBBoxCenter();
   if(bboxCenter.x!=0.0f || bboxCenter.y!=0.0f || bboxCenter.z!= 0.0f)
-    fprintf(fp,"%s bboxCenter %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s bboxCenter %8.4f %8.4f %8.4f\n",str,
             bboxCenter.x,bboxCenter.y,bboxCenter.z);
   
   Vec3f&    bboxSize         = transform->getBBoxSize();
   if(bboxSize.x!=-1.0f || bboxSize.y!=-1.0f || bboxSize.z!= -1.0f)
-    fprintf(fp,"%s bboxSize %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s bboxSize %8.4f %8.4f %8.4f\n",str,
             bboxSize.x,bboxSize.y,bboxSize.z);
   
   int nChildren = transform->getNumberOfChildren();
   if(nChildren>0) {
     Node* node;
-    fprintf(fp,"%s children [\n",indent.c_str());
+    ob.printf("%s children [\n",indent.c_str());
     for(int i=0;i<nChildren;i++) {
       node = (*transform)[i];
       if(node->isShape()) {
-        saveShape(fp,indent+"  ",(Shape*)node);
+        saveShape(ob,indent+"  ",(Shape*)node);
 	  } else if(node->isTransform()) {
-        saveTransform(fp,indent+"  ",(Transform*)node);
+        saveTransform(ob,indent+"  ",(Transform*)node);
 	  } else if(node->isGroup()) {
-        saveGroup(fp,indent+"  ",(Group*)node);
+        saveGroup(ob,indent+"  ",(Group*)node);
       } else {
         // throw StrException("unexpected node type as child of Transform");
       }
     }
-    fprintf(fp,"%s ]\n",indent.c_str());
+    ob.printf("%s ]\n",indent.c_str());
   }
 
-  fprintf(fp,"%s}\n",str);
+  ob.printf("%s}\n",str);
 }
 
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveGroup
-(FILE* fp, string indent, Group* group) const {
+(OutputBuffer& ob, string indent, Group* group) const {
   if(group==(Group*)0) return;
 
   const char* str = indent.c_str();
@@ -583,67 +599,64 @@ void SaverWrl::saveGroup
   //   MFNode children    []
   // }
 
-  const string& name = group->getName();
-  if(name=="")
-    fprintf(fp,"%sGroup {\n",str);
-  else
-    fprintf(fp,"%sDEF %s Group {\n",str,name.c_str());
+  if(putNodeHeader(ob,str,group,"Group")==false) return;
 
   Vec3f&    bboxCenter       = group->getBBoxCenter();
   if(bboxCenter.x!=0.0f || bboxCenter.y!=0.0f || bboxCenter.z!= 0.0f)
-    fprintf(fp,"%s bboxCenter %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s bboxCenter %8.4f %8.4f %8.4f\n",str,
             bboxCenter.x,bboxCenter.y,bboxCenter.z);
   
   Vec3f&    bboxSize         = group->getBBoxSize();
   if(bboxSize.x!=-1.0f || bboxSize.y!=-1.0f || bboxSize.z!= -1.0f)
-    fprintf(fp,"%s bboxSize %8.4f %8.4f %8.4f\n",str,
+    ob.printf("%s bboxSize %8.4f %8.4f %8.4f\n",str,
             bboxSize.x,bboxSize.y,bboxSize.z);
   
   int nChildren = group->getNumberOfChildren();
   if(nChildren>0) {
     Node* node;
+    ob.printf("%s children [\n",str);
     for(int i=0;i<nChildren;i++) {
       node = (*group)[i];
       if(node->isShape()) {
-        saveShape(fp,indent+" ",(Shape*)node);
+        saveShape(ob,indent+"  ",(Shape*)node);
 	  } else if(node->isTransform()) {
-        saveTransform(fp,indent+" ",(Transform*)node);
+        saveTransform(ob,indent+"  ",(Transform*)node);
 	  } else if(node->isGroup()) {
-        saveGroup(fp,indent+" ",(Group*)node);
+        saveGroup(ob,indent+"  ",(Group*)node);
       } else {
-        // throw StrException("unexpected node type as child of Transform");
+        // throw StrException("unexpected node type as child of Group");
       }
     }
+    ob.printf("%s ]\n",str);
   }
 
-  fprintf(fp,"%s}\n",str);
+  ob.printf("%s}\n",str);
 }
 
 //////////////////////////////////////////////////////////////////////
-bool SaverWrl::save(const char* filename, SceneGraph& wrl) const {
-  bool success = false;
-  if(filename!=(char*)0) {
-     FILE* fp = fopen(filename,"w");
-    if(	fp!=(FILE*)0) {
-      fprintf(fp,"#VRML V2.0 utf8\n");
-      string indent="";
-      int nChildren = wrl.getNumberOfChildren();
-      for(int i=0;i<nChildren;i++) {
-        Node* node = wrl[i];
-        if(node->isShape()) {
-          Shape* shape = (Shape*)node;
-          saveShape(fp,indent,shape);
-        } else if(node->isTransform()) {
-          Transform* transform = (Transform*)node;
-          saveTransform(fp,indent,transform);
-        } else if(node->isGroup()) {
-          Group* group = (Group*)node;
-          saveGroup(fp,indent,group);
-        }
-      }
-      fclose(fp);
-      success = true;
+bool SaverWrl::_save(FILE* fp, const char* url, SceneGraph& wrl) const {
+  (void) url;
+  OutputBuffer ob(fp);
+  _useName.clear();
+  _defNode.clear();
+  ob.printf("#VRML V2.0 utf8\n");
+  string indent="";
+  int nChildren = wrl.getNumberOfChildren();
+  for(int i=0;i<nChildren;i++) {
+    Node* node = wrl[i];
+    if(node->isShape()) {
+      Shape* shape = (Shape*)node;
+      saveShape(ob,indent,shape);
+    } else if(node->isTransform()) {
+      Transform* transform = (Transform*)node;
+      saveTransform(ob,indent,transform);
+    } else if(node->isGroup()) {
+      Group* group = (Group*)node;
+      saveGroup(ob,indent,group);
     }
   }
+  bool success = ob.flush();
+  _useName.clear();
+  _defNode.clear();
   return success;
 }
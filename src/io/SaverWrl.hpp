@@ -36,6 +36,8 @@
 #define _SAVER_WRL_HPP_
 
 #include "Saver.hpp"
+#include "OutputBuffer.hpp"
+#include <map>
 #include <wrl/Shape.hpp>
 #include <wrl/Appearance.hpp>
 #include <wrl/Material.hpp>
@@ -51,32 +53,58 @@ private:
 
 const static char* _ext;
 
+  static int _floatPrecision;
+
+  // DEF names of the shared nodes written so far, and the node last
+  // defined with each name, while a file is being saved
+  mutable map<const Node*,string> _useName;
+  mutable map<string,const Node*> _defNode;
+
 public:
 
   SaverWrl()  {};
   ~SaverWrl() {};
 
-  bool  save(const char* filename, SceneGraph& wrl) const;
   const char* ext() const { return _ext; }
+
+  // number of decimals of the coord, normal, color, and texCoord
+  // values; 4 by default, and negative for the shortest string which
+  // reads back as the same float
+  static void setFloatPrecision(const int precision);
+  static int  getFloatPrecision();
   
+protected:
+
+  bool  _save(FILE* fp, const char* url, SceneGraph& wrl) const;
+
 private:
+
+  static void putFloat(OutputBuffer& ob, const float value);
+  bool putNodeHeader
+  (OutputBuffer& ob, const char* str, Node* node, const char* type) const;
+  static void putFloatArray
+  (OutputBuffer& ob, const string& indent, const vector<float>& value,
+   const int n);
+  static void putIndexArray
+  (OutputBuffer& ob, const string& indent, const vector<int>& index,
+   const int width);
   
   void saveAppearance
-  (FILE* fp, string indent, Appearance* appearance) const;
+  (OutputBuffer& ob, string indent, Appearance* appearance) const;
   void saveGroup
-  (FILE* fp, string indent, Group* group) const;
+  (OutputBuffer& ob, string indent, Group* group) const;
   void saveImageTexture
-  (FILE* fp, string indent, ImageTexture* imageTexture) const;
+  (OutputBuffer& ob, string indent, ImageTexture* imageTexture) const;
   void saveIndexedFaceSet
-  (FILE* fp, string indent, IndexedFaceSet* indexedFaceSet) const;
+  (OutputBuffer& ob, string indent, IndexedFaceSet* indexedFaceSet) const;
   void saveIndexedLineSet
-  (FILE* fp, string indent, IndexedLineSet* indexedLineSet) const;
+  (OutputBuffer& ob, string indent, IndexedLineSet* indexedLineSet) const;
   void saveMaterial
-  (FILE* fp, string indent, Material* material) const;
+  (OutputBuffer& ob, string indent, Material* material) const;
   void saveShape
-  (FILE* fp, string indent, Shape* shape) const;
+  (OutputBuffer& ob, string indent, Shape* shape) const;
   void saveTransform
-  (FILE* fp, string indent, Transform* transform) const;
+  (OutputBuffer& ob, string indent, Transform* transform) const;
   
 };
 
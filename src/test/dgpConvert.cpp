@@ -0,0 +1,455 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-08-05 16:38:52 taubin>
+//------------------------------------------------------------------------
+//
+// dgpConvert.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the Brown University nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+// ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL GABRIEL TAUBIN BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <iostream>
+#include <filesystem>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <set>
+#include <cstdio>
+
+using namespace std;
+
+#include <io/AppLoader.hpp>
+#include <io/AppSaver.hpp>
+#include <io/GzFile.hpp>
+#include <io/OutputBuffer.hpp>
+#include <io/LoaderDgpb.hpp>
+#include <io/LoaderPly.hpp>
+#include <io/LoaderStl.hpp>
+#include <io/LoaderWrl.hpp>
+#include <io/SaverDgpb.hpp>
+#include <io/SaverPly.hpp>
+#include <io/SaverStl.hpp>
+#include <io/SaverWrl.hpp>
+#include <wrl/SceneGraphProcessor.hpp>
+#include "dgpPrt.hpp"
+
+// estimated peak memory of a conversion, per byte of the input file;
+// the arrays of the scene graph take about as much memory as a binary
+// file, and vector growth and the Ply to IndexedFaceSet copy the rest
+#define MEMORY_PER_BYTE            3
+// gzip compresses meshes about 4 to 1
+#define MEMORY_PER_COMPRESSED_BYTE 12
+
+class Data {
+public:
+  bool   _debug;
+  bool   _binaryOutput;
+  bool   _gzipOutput;
+  bool   _reorder;
+  bool   _compact;
+  int    _nThreads;
+  size_t _memoryMB;
+  string _format;
+  string _inDir;
+  string _outDir;
+public:
+  Data():
+    _debug(false),
+    _binaryOutput(false),
+    _gzipOutput(false),
+    _reorder(false),
+    _compact(false),
+    _nThreads(0),
+    _memoryMB(0),
+    _format("ply"),
+    _inDir(""),
+    _outDir("")
+  { }
+};
+
+void options(Data& D) {
+  cout << "   -d|-debug               [" << tv(D._debug)          << "]" << endl;
+  cout << "   -b|-binaryOutput        [" << tv(D._binaryOutput)   << "]" << endl;
+  cout << "   -z|-gzipOutput          [" << tv(D._gzipOutput)     << "]" << endl;
+  cout << "   -r|-reorder             [" << tv(D._reorder)        << "]" << endl;
+  cout << "   -c|-compact             [" << tv(D._compact)        << "]" << endl;
+  cout << "   -f|-format wrl|ply|stl|dgpb [" << D._format         << "]" << endl;
+  cout << "   -j|-threads n           [" << D._nThreads << "] (0 = one per core)" << endl;
+  cout << "   -m|-memory MB           [" << D._memoryMB << "] (0 = no limit)" << endl;
+}
+
+void usage(Data& D) {
+  cout << "USAGE: dgpConvert [options] inDir outDir" << endl;
+  cout << "   -h|-help" << endl;
+  options(D);
+  cout << endl;
+  cout << "  converts every file found in the inDir tree to the output format," << endl;
+  cout << "  writing it to the same relative path in the outDir tree" << endl;
+  cout << "  -reorder sorts the vertices and faces of the meshes for memory" << endl;
+  cout << "  locality, and the triangles for the GPU vertex cache" << endl;
+  cout << "  -compact removes the vertices and properties not used by any face" << endl;
+  cout << endl;
+  exit(0);
+}
+
+void error(const char *msg) {
+  cout << "ERROR: dgpConvert | " << ((msg)?msg:"") << endl;
+  exit(0);
+}
+
+//////////////////////////////////////////////////////////////////////
+class Job {
+public:
+  filesystem::path _inFile;
+  filesystem::path _outFile;
+  size_t           _nBytes;
+  size_t           _memory;
+};
+
+//////////////////////////////////////////////////////////////////////
+// loaders and savers of one worker thread; they keep state while a
+// file is loaded or saved, and cannot be shared between threads
+class Converter {
+public:
+  Converter() {
+    _loader.registerLoader(&_plyLoader);
+    _loader.registerLoader(&_stlLoader);
+    _loader.registerLoader(&_wrlLoader);
+    _loader.registerLoader(&_dgpbLoader);
+    _saver.registerSaver(&_plySaver);
+    _saver.registerSaver(&_stlSaver);
+    _saver.registerSaver(&_wrlSaver);
+    _saver.registerSaver(&_dgpbSaver);
+  }
+  bool load(const char* filename, SceneGraph& wrl) {
+    return _loader.load(filename,wrl);
+  }
+  bool save(const char* filename, SceneGraph& wrl) {
+    return _saver.save(filename,wrl);
+  }
+private:
+  LoaderPly  _plyLoader;
+  LoaderStl  _stlLoader;
+  LoaderWrl  _wrlLoader;
+  LoaderDgpb _dgpbLoader;
+  SaverPly   _plySaver;
+  SaverStl   _stlSaver;
+  SaverWrl   _wrlSaver;
+  SaverDgpb  _dgpbSaver;
+  AppLoader  _loader;
+  AppSaver   _saver;
+};
+
+//////////////////////////////////////////////////////////////////////
+// blocks the worker threads while the estimated memory of the
+// conversions in progress would exceed the budget; a conversion
+// larger than the whole budget runs alone
+class MemoryBudget {
+public:
+  MemoryBudget(const size_t budget):
+    _budget(budget),_inUse(0),_peak(0) {
+  }
+  void acquire(const size_t n) {
+    unique_lock<mutex> lock(_mutex);
+    if(_budget>0)
+      _cv.wait(lock,[this,n]{ return _inUse==0 || _inUse+n<=_budget; });
+    _inUse += n;
+    if(_inUse>_peak) _peak = _inUse;
+  }
+  void release(const size_t n) {
+    {
+      lock_guard<mutex> lock(_mutex);
+      _inUse -= n;
+    }
+    _cv.notify_all();
+  }
+  size_t getPeak() const { return _peak; }
+private:
+  mutex              _mutex;
+  condition_variable _cv;
+  size_t             _budget;
+  size_t             _inUse;
+  size_t             _peak;
+};
+
+//////////////////////////////////////////////////////////////////////
+static bool isRegisteredExt(const string& ext) {
+  return (ext=="wrl" || ext=="ply" || ext=="stl" || ext=="dgpb");
+}
+
+// returns false if the file is not in a format which can be loaded
+static bool makeJob
+(Data& D, const filesystem::path& inFile, const filesystem::path& relPath,
+ Job& job) {
+  string ext = AppLoader::sniffExtension(inFile.string().c_str());
+  if(ext=="") {
+    filesystem::path p(GzFile::stripSuffix(inFile.string().c_str()));
+    ext = p.extension().string();
+    if(ext.size()>0) ext = ext.substr(1);
+  }
+  if(isRegisteredExt(ext)==false) return false;
+
+  // name.ext or name.ext.gz to name.format or name.format.gz
+  filesystem::path outFile =
+    filesystem::path(D._outDir)/
+    filesystem::path(GzFile::stripSuffix(relPath.string().c_str()));
+  outFile.replace_extension(D._format);
+  if(D._gzipOutput) outFile += ".gz";
+
+  error_code ec;
+  uintmax_t nBytes = filesystem::file_size(inFile,ec);
+  job._inFile  = inFile;
+  job._outFile = outFile;
+  job._nBytes  = (ec)?0:static_cast<size_t>(nBytes);
+  job._memory  = job._nBytes*
+    ((GzFile::isCompressed(inFile.string().c_str()))?
+     MEMORY_PER_COMPRESSED_BYTE:MEMORY_PER_BYTE);
+  return true;
+}
+
+static double msSince(const chrono::steady_clock::time_point& t0) {
+  return chrono::duration<double,milli>(chrono::steady_clock::now()-t0).count();
+}
+
+//////////////////////////////////////////////////////////////////////
+int main(int argc, char **argv) {
+
+  Data D;
+
+  if(argc==1) usage(D);
+
+  for(int i=1;i<argc;i++) {
+    if(string(argv[i])=="-h" || string(argv[i])=="-help") {
+      usage(D);
+    } else if(string(argv[i])=="-d" || string(argv[i])=="-debug") {
+      D._debug = !D._debug;
+    } else if(string(argv[i])=="-b" || string(argv[i])=="-binaryOutput") {
+      D._binaryOutput = !D._binaryOutput;
+    } else if(string(argv[i])=="-z" || string(argv[i])=="-gzipOutput") {
+      D._gzipOutput = !D._gzipOutput;
+    } else if(string(argv[i])=="-r" || string(argv[i])=="-reorder") {
+      D._reorder = !D._reorder;
+    } else if(string(argv[i])=="-c" || string(argv[i])=="-compact") {
+      D._compact = !D._compact;
+    } else if(string(argv[i])=="-f" || string(argv[i])=="-format") {
+      if(++i>=argc) error("missing format");
+      D._format = string(argv[i]);
+    } else if(string(argv[i])=="-j" || string(argv[i])=="-threads") {
+      if(++i>=argc) error("missing number of threads");
+      D._nThreads = atoi(argv[i]);
+    } else if(string(argv[i])=="-m" || string(argv[i])=="-memory") {
+      if(++i>=argc) error("missing memory budget");
+      D._memoryMB = static_cast<size_t>(atol(argv[i]));
+    } else if(string(argv[i])[0]=='-') {
+      error("unknown option");
+    } else if(D._inDir=="") {
+      D._inDir = string(argv[i]);
+    } else if(D._outDir=="") {
+      D._outDir = string(argv[i]);
+    } else {
+      error("too many command line arguments");
+    }
+  }
+
+  if(D._inDir =="") error("no inDir");
+  if(D._outDir=="") error("no outDir");
+  if(isRegisteredExt(D._format)==false) error("unknown output format");
+  if(D._nThreads<=0) D._nThreads = static_cast<int>(thread::hardware_concurrency());
+  if(D._nThreads<=0) D._nThreads = 1;
+
+  if(D._debug) {
+    cout << "dgpConvert {" << endl;
+    cout << endl;
+    options(D);
+    cout << endl;
+    cout << "  inDir   = " << D._inDir << endl;
+    cout << "  outDir  = " << D._outDir << endl;
+    cout << endl;
+  }
+
+  //////////////////////////////////////////////////////////////////////
+  // collect the files to convert
+
+  vector<filesystem::path> inFile,relPath;
+  error_code ec;
+  filesystem::path inDir(D._inDir);
+  if(filesystem::is_regular_file(inDir,ec)) {
+    inFile.push_back(inDir);
+    relPath.push_back(inDir.filename());
+  } else if(filesystem::is_directory(inDir,ec)) {
+    filesystem::recursive_directory_iterator it(inDir,ec), end;
+    for(;!ec && it!=end;it.increment(ec)) {
+      if(it->is_regular_file(ec)==false) continue;
+      // lexically, so that symbolic links stay inside outDir
+      inFile.push_back(it->path());
+      relPath.push_back(it->path().lexically_relative(inDir));
+    }
+  } else {
+    error("inDir not found");
+  }
+
+  // files which would overwrite an input file, or the output of
+  // another input file (as a.wrl and a.wrl.gz), are skipped
+  vector<Job> job;
+  set<string> outFile;
+  int nSkipped = 0;
+  for(size_t i=0;i<inFile.size();i++) {
+    Job j;
+    if(makeJob(D,inFile[i],relPath[i],j)==false) continue;
+    if(filesystem::equivalent(j._inFile,j._outFile,ec) ||
+       outFile.insert(j._outFile.lexically_normal().string()).second==false) {
+      printf("  SKIPPED  %s: %s is an input or another output\n",
+             j._inFile.string().c_str(),j._outFile.string().c_str());
+      nSkipped++;
+      continue;
+    }
+    job.push_back(j);
+  }
+
+  // largest files first, so that the longest conversions do not end up
+  // running alone at the end
+  sort(job.begin(),job.end(),[](const Job& a, const Job& b) {
+      return a._nBytes>b._nBytes;
+    });
+
+  //////////////////////////////////////////////////////////////////////
+  // static settings shared by all the savers
+
+  SaverStl::setFileType
+    ((D._binaryOutput)?SaverStl::FileType::BINARY:SaverStl::FileType::ASCII);
+  SaverPly::setDefaultDataType
+    ((D._binaryOutput)?
+     Ply::DataType::BINARY_LITTLE_ENDIAN:Ply::DataType::ASCII);
+  Ply::setDebug(D._debug);
+  // the files are converted in parallel; one thread per saver
+  if(D._nThreads>1) OutputBuffer::setNumberOfThreads(1);
+
+  //////////////////////////////////////////////////////////////////////
+  // convert
+
+  const int    nJobs = static_cast<int>(job.size());
+  const int    nThreads = min(D._nThreads,max(nJobs,1));
+  MemoryBudget budget(D._memoryMB<<20);
+  atomic<int>  nextJob(0);
+  atomic<int>  nFailed(0);
+  mutex        printMutex;
+  double       loadMs = 0.0, saveMs = 0.0;
+  size_t       nBytes = 0;
+
+  auto t0 = chrono::steady_clock::now();
+
+  auto worker = [&]() {
+    Converter converter;
+    int iJob;
+    while((iJob=nextJob++)<nJobs) {
+      Job& j = job[iJob];
+      budget.acquire(j._memory);
+
+      const char* failed = nullptr;
+      double tLoad = 0.0, tSave = 0.0;
+      {
+        SceneGraph wrl;
+        auto t = chrono::steady_clock::now();
+        bool success = converter.load(j._inFile.string().c_str(),wrl);
+        tLoad = msSince(t);
+        if(success==false) {
+          failed = "load";
+        } else {
+          SceneGraphProcessor processor(wrl);
+          // as for the savers, one thread per job when the files are
+          // converted in parallel
+          if(nThreads>1) processor.setNumberOfThreads(1);
+          if(D._compact) {
+            processor.removeUnusedVertices();
+          }
+          if(D._reorder) {
+            processor.vertexReorder();
+            processor.triangleReorder();
+          }
+          error_code ec;
+          filesystem::create_directories(j._outFile.parent_path(),ec);
+          t = chrono::steady_clock::now();
+          success = converter.save(j._outFile.string().c_str(),wrl);
+          tSave = msSince(t);
+          if(success==false) failed = "save";
+        }
+      }
+
+      budget.release(j._memory);
+
+      lock_guard<mutex> lock(printMutex);
+      if(failed!=nullptr) {
+        nFailed++;
+        printf("  FAILED %-4s %8.1f MB  %s\n",
+               failed,j._nBytes/1048576.0,j._inFile.string().c_str());
+      } else {
+        loadMs += tLoad;
+        saveMs += tSave;
+        nBytes += j._nBytes;
+        printf("  load %8.0f ms  save %8.0f ms %8.1f MB  %s -> %s\n",
+               tLoad,tSave,j._nBytes/1048576.0,
+               j._inFile.string().c_str(),j._outFile.string().c_str());
+      }
+      fflush(stdout);
+    }
+  };
+
+  vector<thread> pool;
+  for(int i=1;i<nThreads;i++)
+    pool.push_back(thread(worker));
+  worker();
+  for(thread& t : pool)
+    t.join();
+
+  double wallMs = msSince(t0);
+
+  //////////////////////////////////////////////////////////////////////
+  // summary
+
+  printf("dgpConvert | %d files converted, %d failed, %d skipped\n",
+         nJobs-nFailed,static_cast<int>(nFailed),nSkipped);
+  printf("  input    %10.1f MB\n",nBytes/1048576.0);
+  printf("  load     %10.0f ms\n",loadMs);
+  printf("  save     %10.0f ms\n",saveMs);
+  printf("  wall     %10.0f ms\n",wallMs);
+  if(wallMs>0.0)
+    printf("  rate     %10.1f MB/s\n",(nBytes/1048576.0)/(wallMs/1000.0));
+  printf("  threads  %10d\n",nThreads);
+  printf("  memory   %10.1f MB estimated peak",budget.getPeak()/1048576.0);
+  if(D._memoryMB>0) printf(", %d MB budget",static_cast<int>(D._memoryMB));
+  printf("\n");
+
+  if(D._debug) {
+    cout << "} dgpConvert" << endl;
+  }
+
+  return (nFailed>0 || nSkipped>0)?-1:0;
+}
@@ -42,9 +42,11 @@ using namespace std;
 #include <wrl/IndexedFaceSet.hpp>
 #include <io/AppLoader.hpp>
 #include <io/AppSaver.hpp>
+#include <io/LoaderDgpb.hpp>
 #include <io/LoaderPly.hpp>
 #include <io/LoaderStl.hpp>
 #include <io/LoaderWrl.hpp>
+#include <io/SaverDgpb.hpp>
 #include <io/SaverPly.hpp>
 #include <io/SaverStl.hpp>
 #include <io/SaverWrl.hpp>
@@ -134,6 +136,8 @@ int main(int argc, char **argv) {
   loaderFactory.registerLoader(stlLoader);
   LoaderWrl* wrlLoader = new LoaderWrl();
   loaderFactory.registerLoader(wrlLoader);
+  LoaderDgpb* dgpbLoader = new LoaderDgpb();
+  loaderFactory.registerLoader(dgpbLoader);
 
   // register output file savers  
   SaverPly* plySaver = new SaverPly();
@@ -142,6 +146,8 @@ int main(int argc, char **argv) {
   saverFactory.registerSaver(stlSaver);
   SaverWrl* wrlSaver = new SaverWrl();
   saverFactory.registerSaver(wrlSaver);
+  SaverDgpb* dgpbSaver = new SaverDgpb();
+  saverFactory.registerSaver(dgpbSaver);
 
   SaverStl::FileType stlFt =
     (D._binaryOutput)?SaverStl::FileType::BINARY:SaverStl::FileType::ASCII;
@@ -189,14 +195,14 @@ int main(int argc, char **argv) {
   Node* node;
   while((node=sgt.next())!=nullptr) {
 
-    Shape* shape = dynamic_cast<Shape*>(node);
-    if(shape==nullptr) continue;
+    if(node->isShape()==false) continue;
+    Shape* shape = (Shape*)node;
 
     string shapeName = shape->getName();
 
     node = shape->getGeometry();
-    IndexedFaceSet* ifs = dynamic_cast<IndexedFaceSet*>(node);
-    if(ifs==nullptr) continue;
+    if(node==nullptr || node->isIndexedFaceSet()==false) continue;
+    IndexedFaceSet* ifs = (IndexedFaceSet*)node;
 
     printIndexedFaceSetInfo(cout,shapeName,iIfs,*ifs,"    ");
 
@@ -38,11 +38,14 @@
 using namespace std;
 
 #include <wrl/SceneGraphTraversal.hpp>
+#include <wrl/SceneGraphProcessor.hpp>
 #include <io/AppLoader.hpp>
 #include <io/AppSaver.hpp>
+#include <io/LoaderDgpb.hpp>
 #include <io/LoaderPly.hpp>
 #include <io/LoaderStl.hpp>
 #include <io/LoaderWrl.hpp>
+#include <io/SaverDgpb.hpp>
 #include <io/SaverPly.hpp>
 #include <io/SaverStl.hpp>
 #include <io/SaverWrl.hpp>
@@ -55,6 +58,7 @@ public:
   bool   _removeNormal;
   bool   _removeColor;
   bool   _removeTexCoord;
+  bool   _compact;
   string _inFile;
   string _outFile;
 public:
@@ -64,6 +68,7 @@ public:
     _removeNormal(false),
     _removeColor(false),
     _removeTexCoord(false),
+    _compact(false),
     _inFile(""),
     _outFile("")
   { }
@@ -76,6 +81,7 @@ void options(Data& D) {
   cout << "  -rn|-removeNormal        [" << tv(D._removeNormal)   << "]" << endl;
   cout << "  -rc|-removeColor         [" << tv(D._removeColor)    << "]" << endl;
   cout << "  -rt|-removeTexCoord      [" << tv(D._removeTexCoord) << "]" << endl;
+  cout << "   -c|-compact             [" << tv(D._compact)        << "]" << endl;
 }
 
 void usage(Data& D) {
@@ -115,6 +121,8 @@ int main(int argc, char **argv) {
       D._removeColor = !D._removeColor;
     } else if(string(argv[i])=="-rt" || string(argv[i])=="-removeTexCoord") {
       D._removeTexCoord = !D._removeTexCoord;
+    } else if(string(argv[i])=="-c" || string(argv[i])=="-compact") {
+      D._compact = !D._compact;
     } else if(string(argv[i])[0]=='-') {
       error("unknown option");
     } else if(D._inFile=="") {
@@ -154,6 +162,8 @@ int main(int argc, char **argv) {
   loaderFactory.registerLoader(stlLoader);
   LoaderWrl* wrlLoader = new LoaderWrl();
   loaderFactory.registerLoader(wrlLoader);
+  LoaderDgpb* dgpbLoader = new LoaderDgpb();
+  loaderFactory.registerLoader(dgpbLoader);
 
   // register output file savers  
   SaverPly* plySaver = new SaverPly();
@@ -162,6 +172,8 @@ int main(int argc, char **argv) {
   saverFactory.registerSaver(stlSaver);
   SaverWrl* wrlSaver = new SaverWrl();
   saverFactory.registerSaver(wrlSaver);
+  SaverDgpb* dgpbSaver = new SaverDgpb();
+  saverFactory.registerSaver(dgpbSaver);
 
   SaverStl::FileType stlFt =
     (D._binaryOutput)?SaverStl::FileType::BINARY:SaverStl::FileType::ASCII;
@@ -205,13 +217,13 @@ int main(int argc, char **argv) {
     Node* node;
     SceneGraphTraversal sgt(wrl);
     for(int iIfs=0;(node=sgt.next())!=(Node*)0;iIfs++) {
-      Shape* shape = dynamic_cast<Shape*>(node);
-      if(shape==(Shape*)0) continue;
+      if(node->isShape()==false) continue;
+      Shape* shape = (Shape*)node;
       const string& shapeName = shape->getName();
       
-      IndexedFaceSet* ifs =
-        dynamic_cast<IndexedFaceSet*>(shape->getGeometry());
-      if(ifs==(IndexedFaceSet*)0) continue;
+      node = shape->getGeometry();
+      if(node==(Node*)0 || node->isIndexedFaceSet()==false) continue;
+      IndexedFaceSet* ifs = (IndexedFaceSet*)node;
 
       if(D._debug) {
         cout << "  before processing" << endl;
@@ -230,6 +242,12 @@ int main(int argc, char **argv) {
 
     if(D._debug) cout << "  }" << endl;  
   }
+
+  // remove the vertices and properties left unused
+  if(D._compact) {
+    SceneGraphProcessor processor(wrl);
+    processor.removeUnusedVertices();
+  }
   
   //////////////////////////////////////////////////////////////////////
   // write
@@ -41,9 +41,11 @@ using namespace std;
 
 #include <io/AppLoader.hpp>
 #include <io/AppSaver.hpp>
+#include <io/LoaderDgpb.hpp>
 #include <io/LoaderPly.hpp>
 #include <io/LoaderStl.hpp>
 #include <io/LoaderWrl.hpp>
+#include <io/SaverDgpb.hpp>
 #include <io/SaverPly.hpp>
 #include <io/SaverStl.hpp>
 #include <io/SaverWrl.hpp>
@@ -144,6 +146,8 @@ int main(int argc, char **argv) {
   loaderFactory.registerLoader(stlLoader);
   LoaderWrl* wrlLoader = new LoaderWrl();
   loaderFactory.registerLoader(wrlLoader);
+  LoaderDgpb* dgpbLoader = new LoaderDgpb();
+  loaderFactory.registerLoader(dgpbLoader);
 
   //  If SaverPly::setDefaultDataType is used, it must be called
   //  before the Saver constructor; otherwise SaverPly::setDataType
@@ -158,6 +162,8 @@ int main(int argc, char **argv) {
   saverFactory.registerSaver(stlSaver);
   SaverWrl* wrlSaver = new SaverWrl();
   saverFactory.registerSaver(wrlSaver);
+  SaverDgpb* dgpbSaver = new SaverDgpb();
+  saverFactory.registerSaver(dgpbSaver);
 
   SaverStl::FileType stlFt =
     (D._binaryOutput)?SaverStl::FileType::BINARY:SaverStl::FileType::ASCII;
@@ -200,14 +206,14 @@ int main(int argc, char **argv) {
   Node* node;
   SceneGraphTraversal sgt(wrl);
   for(int iIfs=0;(node=sgt.next())!=(Node*)0;iIfs++) {
-    Shape* shape = dynamic_cast<Shape*>(node);
-    if(shape==(Shape*)0) continue;
+    if(node->isShape()==false) continue;
+    Shape* shape = (Shape*)node;
 
     const string& shapeName = shape->getName();
     
-    IndexedFaceSet* ifs =
-      dynamic_cast<IndexedFaceSet*>(shape->getGeometry());
-    if(ifs==(IndexedFaceSet*)0) continue;
+    node = shape->getGeometry();
+    if(node==(Node*)0 || node->isIndexedFaceSet()==false) continue;
+    IndexedFaceSet* ifs = (IndexedFaceSet*)node;
 
     if(D._removeProperties) {
 
@@ -0,0 +1,112 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-19 10:12:34 taubin>
+//------------------------------------------------------------------------
+//
+// Arena.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include <new>
+#include "Arena.hpp"
+
+Arena::Arena(const size_t chunkSize):
+  _chunkSize((chunkSize<4*alignment)?4*alignment:chunkSize),
+  _chunk(),
+  _next((char*)0),
+  _end((char*)0),
+  _nRefs(1) {
+}
+
+Arena::~Arena() {
+  _freeChunks();
+}
+
+void Arena::_freeChunks() {
+  for(char* chunk : _chunk) ::operator delete(chunk);
+  _chunk.clear();
+  _next = _end = (char*)0;
+}
+
+//////////////////////////////////////////////////////////////////////
+void* Arena::allocate(const size_t size) {
+  const size_t n = (size+alignment-1)&~(alignment-1);
+  if(n>_chunkSize/4) {
+    // the large block goes in a chunk of its own, inserted before the
+    // current one, so that the rest of the current chunk is still used
+    char* chunk = (char*)::operator new(n);
+    _chunk.insert((_chunk.size()>0)?_chunk.end()-1:_chunk.end(),chunk);
+    _nRefs.fetch_add(1,memory_order_relaxed);
+    return chunk;
+  }
+  if(_next==(char*)0 || (size_t)(_end-_next)<n) {
+    char* chunk = (char*)::operator new(_chunkSize);
+    _chunk.push_back(chunk);
+    _next = chunk;
+    _end  = chunk+_chunkSize;
+  }
+  void* p = _next;
+  _next += n;
+  _nRefs.fetch_add(1,memory_order_relaxed);
+  return p;
+}
+
+void Arena::deallocate(void* /*p*/) {
+  if(_nRefs.fetch_sub(1,memory_order_acq_rel)==1) delete this;
+}
+
+//////////////////////////////////////////////////////////////////////
+size_t Arena::getNumberOfAllocations() const {
+  return _nRefs.load(memory_order_acquire)-1;
+}
+
+size_t Arena::getNumberOfChunks() const {
+  return _chunk.size();
+}
+
+size_t Arena::getChunkSize() const {
+  return _chunkSize;
+}
+
+bool Arena::reset() {
+  if(_nRefs.load(memory_order_acquire)>1) return false;
+  _freeChunks();
+  return true;
+}
+
+void Arena::release() {
+  if(_nRefs.fetch_sub(1,memory_order_acq_rel)==1) delete this;
+}
@@ -0,0 +1,100 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-19 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// Arena.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+
+using namespace std;
+
+// Bump allocator for many small objects which are released together.
+// Memory is taken from chunks of chunkSize bytes; blocks larger than
+// a quarter of a chunk get a chunk of their own. Blocks are aligned
+// to alignof(max_align_t). deallocate() does not reuse the block, it
+// only counts the live blocks; reset() returns all the chunks at once
+// when no block is live.
+//
+// allocate() and reset() must not be called concurrently; blocks may
+// be deallocated from any thread, also while the owner calls release().
+
+class Arena {
+
+public:
+
+  static const size_t alignment = alignof(max_align_t);
+
+  Arena(const size_t chunkSize=(1<<20));
+  ~Arena();
+
+  void*  allocate(const size_t size);
+  void   deallocate(void* p);
+
+  size_t getNumberOfAllocations() const; // live blocks
+  size_t getNumberOfChunks() const;
+  size_t getChunkSize() const;
+
+  // releases all the chunks if no block is live, and returns false
+  // otherwise
+  bool   reset();
+
+  // to be called by the owner in place of delete: the arena is
+  // deleted now if no block is live, or else by the deallocate() call
+  // which releases its last live block
+  void   release();
+
+private:
+
+  size_t         _chunkSize;
+  vector<char*>  _chunk;
+  char*          _next;
+  char*          _end;
+
+  // the live blocks, plus one for the owner until release(); the
+  // caller which takes it to zero deletes the arena
+  atomic<size_t> _nRefs;
+
+  void           _freeChunks();
+};
+
+#endif // ARENA_HPP
@@ -42,6 +42,11 @@
 #include <cmath>
 #include "BBox.hpp"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BBOX_SSE2
+#endif
+
 BBox::~BBox() {
   if(_min   !=(float*)0) delete [] _min;
   if(_max   !=(float*)0) delete [] _max;
@@ -213,3 +218,44 @@ float BBox::getDiameter() const {
   }
   return (diam2>0.0f)?(float)sqrt(diam2):0.0f;
 }
+
+//////////////////////////////////////////////////////////////////////
+bool BBox::getMinMax(const float* coord, const size_t nV, float box[6]) {
+  if(nV==0) return false;
+  int j;
+  for(j=0;j<3;j++) box[j] = box[j+3] = coord[j];
+  size_t iV = 1;
+#ifdef BBOX_SSE2
+  // 4 points are 3 registers, holding (x y z x) (y z x y) (z x y z)
+  if(nV>=5) {
+    const float* p = coord+3;
+    __m128 min0 = _mm_set_ps(box[0],box[2],box[1],box[0]);
+    __m128 min1 = _mm_set_ps(box[1],box[0],box[2],box[1]);
+    __m128 min2 = _mm_set_ps(box[2],box[1],box[0],box[2]);
+    __m128 max0 = min0, max1 = min1, max2 = min2;
+    for(;iV+4<=nV;iV+=4,p+=12) {
+      const __m128 v0 = _mm_loadu_ps(p);
+      const __m128 v1 = _mm_loadu_ps(p+4);
+      const __m128 v2 = _mm_loadu_ps(p+8);
+      // with the new value as first operand, NaN values are skipped
+      min0 = _mm_min_ps(v0,min0); max0 = _mm_max_ps(v0,max0);
+      min1 = _mm_min_ps(v1,min1); max1 = _mm_max_ps(v1,max1);
+      min2 = _mm_min_ps(v2,min2); max2 = _mm_max_ps(v2,max2);
+    }
+    float m[12],M[12];
+    _mm_storeu_ps(m,min0); _mm_storeu_ps(m+4,min1); _mm_storeu_ps(m+8,min2);
+    _mm_storeu_ps(M,max0); _mm_storeu_ps(M+4,max1); _mm_storeu_ps(M+8,max2);
+    for(int i=0;i<12;i++) {
+      if(m[i]<box[i%3]  ) box[i%3]   = m[i];
+      if(M[i]>box[i%3+3]) box[i%3+3] = M[i];
+    }
+  }
+#endif
+  for(;iV<nV;iV++)
+    for(j=0;j<3;j++) {
+      const float x = coord[3*iV+j];
+      if(x<box[j]  ) box[j]   = x;
+      if(x>box[j+3]) box[j+3] = x;
+    }
+  return true;
+}
@@ -74,6 +74,13 @@ public:
 
   void   setMin(const float* value /*[3]*/);
   void   setMax(const float* value /*[3]*/);
+
+  // box = { xMin, yMin, zMin, xMax, yMax, zMax } of the nV points
+  // stored as x,y,z triples in coord; returns false if nV is 0.
+  // NaN coordinates are skipped, other than in the first point. Four points are reduced at
+  // once with SSE2 instructions if the compiler targets them; the
+  // result does not depend on the instruction set
+  static bool getMinMax(const float* coord, const size_t nV, float box[6]);
 };
 
 #endif /* _BBOX_HPP_ */
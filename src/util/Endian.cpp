@@ -87,6 +87,38 @@ Endian::SingleValueBuffer& Endian::swap8
   return buff;
 }
 
+void Endian::swapArray
+(void* data, const unsigned long nValues,
+ const int valueSize, const unsigned long stride) {
+  uchar* p = static_cast<uchar*>(data);
+  uchar tmp;
+  const unsigned long step =
+    (stride>0)?stride:static_cast<unsigned long>(valueSize);
+  unsigned long i;
+  switch(valueSize) {
+  case 2:
+    for(i=0;i<nValues;i++,p+=step) {
+      tmp = p[0]; p[0] = p[1]; p[1] = tmp;
+    }
+    break;
+  case 4:
+    for(i=0;i<nValues;i++,p+=step) {
+      tmp = p[0]; p[0] = p[3]; p[3] = tmp;
+      tmp = p[1]; p[1] = p[2]; p[2] = tmp;
+    }
+    break;
+  case 8:
+    for(i=0;i<nValues;i++,p+=step) {
+      tmp = p[0]; p[0] = p[7]; p[7] = tmp;
+      tmp = p[1]; p[1] = p[6]; p[6] = tmp;
+      tmp = p[2]; p[2] = p[5]; p[5] = tmp;
+      tmp = p[3]; p[3] = p[4]; p[4] = tmp;
+    }
+    break;
+  default:
+    break;
+  }
+}
 
 //////////////////////////////////////////////////////////////////////
 // static
@@ -85,6 +85,12 @@ namespace Endian {
 #define swapLong   swap8
 #define swapDouble swap8
 
+  // swaps the bytes of nValues values of valueSize (2, 4 or 8) bytes
+  // each, in place; consecutive values are stride bytes apart
+  // (stride==0 means tightly packed)
+  void swapArray(void* data, const unsigned long nValues,
+                 const int valueSize, const unsigned long stride=0);
+
   bool isLittleEndianSystem();
 
 };
@@ -0,0 +1,182 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:40:19 taubin>
+//------------------------------------------------------------------------
+//
+// Quantize.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include <math.h>
+#include "Quantize.hpp"
+
+//////////////////////////////////////////////////////////////////////
+static inline float _snorm8(const int q) {
+  float v = static_cast<float>(q)/127.0f;
+  return (v<-1.0f)?-1.0f:v;
+}
+
+static inline float _signNotZero(const float v) {
+  return (v<0.0f)?-1.0f:1.0f;
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::decodeOct16(const unsigned short q, float n[3]) {
+  float x = _snorm8(static_cast<signed char>(q&0xff));
+  float y = _snorm8(static_cast<signed char>(q>>8));
+  float z = 1.0f-fabsf(x)-fabsf(y);
+  if(z<0.0f) {
+    float t = x;
+    x = (1.0f-fabsf(y))*_signNotZero(t);
+    y = (1.0f-fabsf(t))*_signNotZero(y);
+  }
+  float len = sqrtf(x*x+y*y+z*z);
+  n[0] = x/len; n[1] = y/len; n[2] = z/len;
+}
+
+//////////////////////////////////////////////////////////////////////
+unsigned short Quantize::encodeOct16(const float n[3]) {
+  float sum = fabsf(n[0])+fabsf(n[1])+fabsf(n[2]);
+  if(sum<=0.0f) return 0;
+  float x = n[0]/sum;
+  float y = n[1]/sum;
+  if(n[2]<0.0f) {
+    float t = x;
+    x = (1.0f-fabsf(y))*_signNotZero(t);
+    y = (1.0f-fabsf(t))*_signNotZero(y);
+  }
+  // rounding each coordinate to the nearest value is not always the
+  // closest direction once decoded; try the four neighbours
+  float len = sqrtf(n[0]*n[0]+n[1]*n[1]+n[2]*n[2]);
+  int   x0  = static_cast<int>(floorf(x*127.0f));
+  int   y0  = static_cast<int>(floorf(y*127.0f));
+  unsigned short best = 0;
+  float bestDot = -2.0f;
+  float m[3];
+  for(int i=0;i<2;i++) {
+    int qx = x0+i; if(qx>127) qx = 127; else if(qx<-127) qx = -127;
+    for(int j=0;j<2;j++) {
+      int qy = y0+j; if(qy>127) qy = 127; else if(qy<-127) qy = -127;
+      unsigned short q =
+        static_cast<unsigned short>((qx&0xff)|((qy&0xff)<<8));
+      decodeOct16(q,m);
+      float dot = (m[0]*n[0]+m[1]*n[1]+m[2]*n[2])/len;
+      if(dot>bestDot) { bestDot = dot; best = q; }
+    }
+  }
+  return best;
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::encodeNormal
+(const vector<float>& normal, vector<unsigned short>& qNormal) {
+  size_t nNormal = normal.size()/3;
+  qNormal.resize(nNormal);
+  for(size_t i=0;i<nNormal;i++)
+    qNormal[i] = encodeOct16(&normal[3*i]);
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::decodeNormal
+(const vector<unsigned short>& qNormal, vector<float>& normal) {
+  size_t nNormal = qNormal.size();
+  normal.resize(3*nNormal);
+  for(size_t i=0;i<nNormal;i++)
+    decodeOct16(qNormal[i],&normal[3*i]);
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::encodeColor
+(const vector<float>& color, vector<unsigned char>& qColor) {
+  size_t n = color.size();
+  qColor.resize(n);
+  for(size_t i=0;i<n;i++) {
+    float c = color[i];
+    c = (c>1.0f)?1.0f:(c>0.0f)?c:0.0f;
+    qColor[i] = static_cast<unsigned char>(c*255.0f+0.5f);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::decodeColor
+(const vector<unsigned char>& qColor, vector<float>& color) {
+  size_t n = qColor.size();
+  color.resize(n);
+  for(size_t i=0;i<n;i++)
+    color[i] = static_cast<float>(qColor[i])/255.0f;
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::encodeCoord
+(const vector<float>& coord, vector<unsigned short>& qCoord, float box[6]) {
+  size_t n = coord.size();
+  size_t i;
+  int    j;
+  float  xMax[3] = { 0.0f, 0.0f, 0.0f };
+  for(j=0;j<6;j++) box[j] = 0.0f;
+  if(n>=3) {
+    for(j=0;j<3;j++) box[j] = xMax[j] = coord[j];
+    for(i=3;i+2<n;i+=3)
+      for(j=0;j<3;j++) {
+        if(coord[i+j]<box[j]) box[j] = coord[i+j];
+        if(coord[i+j]>xMax[j]) xMax[j] = coord[i+j];
+      }
+    for(j=0;j<3;j++)
+      box[3+j] = (xMax[j]-box[j])/65535.0f;
+  }
+  float scale[3];
+  for(j=0;j<3;j++)
+    scale[j] = (box[3+j]>0.0f)?1.0f/box[3+j]:0.0f;
+  qCoord.resize(n);
+  for(i=0;i<n;i++) {
+    j = static_cast<int>(i%3);
+    float q = (coord[i]-box[j])*scale[j]+0.5f;
+    qCoord[i] = static_cast<unsigned short>((q<65535.0f)?q:65535.0f);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void Quantize::decodeCoord
+(const vector<unsigned short>& qCoord, const float box[6],
+ vector<float>& coord) {
+  size_t n = qCoord.size();
+  coord.resize(n);
+  for(size_t i=0;i+2<n;i+=3) {
+    coord[i  ] = box[0]+box[3]*static_cast<float>(qCoord[i  ]);
+    coord[i+1] = box[1]+box[4]*static_cast<float>(qCoord[i+1]);
+    coord[i+2] = box[2]+box[5]*static_cast<float>(qCoord[i+2]);
+  }
+}
@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:40:16 taubin>
+//------------------------------------------------------------------------
+//
+// Quantize.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef QUANTIZE_HPP
+#define QUANTIZE_HPP
+
+#include <vector>
+
+using namespace std;
+
+// Compact encodings of vertex attributes
+//
+// - normals are mapped onto the octahedron, unfolded onto the square
+//   [-1,1]x[-1,1], and stored as two 8 bit signed values packed in 16
+//   bits; the angular error is below 0.6 degrees
+// - colors are stored as three 8 bit values per color, which is exact
+//   for colors read from files as 8 bit values
+// - coordinates are stored as three 16 bit values, relative to their
+//   bounding box; the error along each axis is about 1/131070 of the
+//   box side
+//
+// The decoders produce unit length normals, and colors and
+// coordinates with the same layout as the IndexedFaceSet arrays
+
+namespace Quantize {
+
+  // n[3] need not be unit length; the zero vector encodes as (0,0,1)
+  unsigned short encodeOct16(const float n[3]);
+  void           decodeOct16(const unsigned short q, float n[3]);
+
+  void encodeNormal(const vector<float>& normal,
+                    vector<unsigned short>& qNormal);
+  void decodeNormal(const vector<unsigned short>& qNormal,
+                    vector<float>& normal);
+
+  // values are clamped to [0,1]
+  void encodeColor(const vector<float>& color,
+                   vector<unsigned char>& qColor);
+  void decodeColor(const vector<unsigned char>& qColor,
+                   vector<float>& color);
+
+  // box = { xMin, yMin, zMin, xStep, yStep, zStep }, set by the encoder
+  void encodeCoord(const vector<float>& coord,
+                   vector<unsigned short>& qCoord, float box[6]);
+  void decodeCoord(const vector<unsigned short>& qCoord,
+                   const float box[6], vector<float>& coord);
+
+};
+
+#endif // QUANTIZE_HPP
@@ -0,0 +1,172 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:40:19 taubin>
+//------------------------------------------------------------------------
+//
+// ThreadPool.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(const int nThreads):
+  _nThreads(nThreads),
+  _queue(0),
+  _task(nullptr),
+  _batch(0),
+  _nBusy(0),
+  _stop(false),
+  _error(nullptr),
+  _failed(false) {
+  if(_nThreads<=0) _nThreads = static_cast<int>(thread::hardware_concurrency());
+  if(_nThreads<=0) _nThreads = 1;
+  vector<Queue>(_nThreads).swap(_queue);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    lock_guard<mutex> lock(_mutex);
+    _stop = true;
+  }
+  _start.notify_all();
+  for(thread& t : _thread) t.join();
+}
+
+int ThreadPool::getNumberOfThreads() const {
+  return _nThreads;
+}
+
+//////////////////////////////////////////////////////////////////////
+void ThreadPool::run(const int nTasks, const function<void(int)>& task) {
+  if(_nThreads==1 || nTasks<=1) {
+    for(int i=0;i<nTasks;i++) task(i);
+    return;
+  }
+  // the other threads are created on the first parallel batch
+  if(_thread.size()==0)
+    for(int iThread=1;iThread<_nThreads;iThread++)
+      _thread.push_back(thread(&ThreadPool::_loop,this,iThread));
+  {
+    lock_guard<mutex> lock(_mutex);
+    for(int i=0;i<nTasks;i++)
+      _queue[i%_nThreads]._task.push_back(i);
+    _task  = &task;
+    _nBusy = _nThreads-1;
+    _batch++;
+  }
+  _start.notify_all();
+  _work(0);
+  exception_ptr error;
+  {
+    unique_lock<mutex> lock(_mutex);
+    _done.wait(lock,[this]{ return _nBusy==0; });
+    _task = nullptr;
+    error.swap(_error);
+    _failed = false;
+  }
+  if(error) rethrow_exception(error);
+}
+
+void ThreadPool::runRange
+(const int n, const int grain, const function<void(int,int)>& task) {
+  if(n<=0) return;
+  long long nRanges = (n+(long long)grain-1)/(grain>0?grain:1);
+  if(nRanges>4LL*_nThreads) nRanges = 4LL*_nThreads;
+  if(nRanges<=1) {
+    task(0,n);
+    return;
+  }
+  run(static_cast<int>(nRanges),[n,nRanges,&task](int iRange) {
+      const int i0 = static_cast<int>(( iRange   *(long long)n)/nRanges);
+      const int i1 = static_cast<int>(((iRange+1)*(long long)n)/nRanges);
+      task(i0,i1);
+    });
+}
+
+//////////////////////////////////////////////////////////////////////
+bool ThreadPool::_next(const int iThread, int& iTask) {
+  {
+    Queue& q = _queue[iThread];
+    lock_guard<mutex> lock(q._mutex);
+    if(q._task.size()>0) {
+      iTask = q._task.front(); q._task.pop_front();
+      return true;
+    }
+  }
+  for(int k=1;k<_nThreads;k++) {
+    Queue& q = _queue[(iThread+k)%_nThreads];
+    lock_guard<mutex> lock(q._mutex);
+    if(q._task.size()>0) {
+      iTask = q._task.back(); q._task.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+// the exceptions are caught here, so that no thread leaves the batch
+// while the others are still running tasks
+void ThreadPool::_work(const int iThread) {
+  int iTask;
+  while(_next(iThread,iTask)) {
+    if(_failed.load(memory_order_relaxed)) continue;
+    try {
+      (*_task)(iTask);
+    } catch(...) {
+      lock_guard<mutex> lock(_mutex);
+      if(!_error) _error = current_exception();
+      _failed = true;
+    }
+  }
+}
+
+void ThreadPool::_loop(const int iThread) {
+  unsigned long batch = 0;
+  for(;;) {
+    {
+      unique_lock<mutex> lock(_mutex);
+      _start.wait(lock,[this,batch]{ return _stop || _batch!=batch; });
+      if(_stop) return;
+      batch = _batch;
+    }
+    _work(iThread);
+    {
+      lock_guard<mutex> lock(_mutex);
+      _nBusy--;
+    }
+    _done.notify_one();
+  }
+}
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:40:16 taubin>
+//------------------------------------------------------------------------
+//
+// ThreadPool.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <atomic>
+
+using namespace std;
+
+// Runs batches of independent tasks on a set of threads which are
+// created on the first run() and kept until the pool is destroyed.
+//
+// The tasks of a batch are dealt in turn to one queue per thread; each
+// thread takes tasks from the front of its own queue, and when it runs
+// out, steals from the back of the other queues. Passing the tasks
+// sorted by decreasing cost starts the largest ones first, and leaves
+// the smallest ones to balance the load at the end.
+
+class ThreadPool {
+
+public:
+
+  // 0 means one thread per hardware thread
+  ThreadPool(const int nThreads=0);
+  ~ThreadPool();
+
+  int  getNumberOfThreads() const;
+
+  // runs task(i) for i in [0:nTasks), and returns when all are done;
+  // the calling thread works on the batch as well. If a task throws,
+  // the tasks not yet started are skipped, and the first exception is
+  // rethrown by run() once no thread is running a task. run() is not
+  // re-entrant: it must not be called from a task, nor from two
+  // threads at once on the same pool
+  void run(const int nTasks, const function<void(int)>& task);
+
+  // splits [0:n) into consecutive ranges of at least grain elements,
+  // a few per thread, and runs task(i0,i1) on each range [i0:i1)
+  void runRange(const int n, const int grain,
+                const function<void(int,int)>& task);
+
+private:
+
+  struct Queue {
+    mutex      _mutex;
+    deque<int> _task;
+  };
+
+  int                         _nThreads;
+  vector<thread>              _thread;
+  vector<Queue>               _queue;
+  const function<void(int)>*  _task;
+  mutex                       _mutex;
+  condition_variable          _start;
+  condition_variable          _done;
+  unsigned long               _batch;
+  int                         _nBusy;
+  bool                        _stop;
+  exception_ptr               _error;
+  atomic<bool>                _failed;
+
+  bool _next(const int iThread, int& iTask);
+  void _work(const int iThread);
+  void _loop(const int iThread);
+
+};
+
+#endif // THREAD_POOL_HPP
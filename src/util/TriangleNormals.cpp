@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:40:19 taubin>
+//------------------------------------------------------------------------
+//
+// TriangleNormals.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+
+
+#include <math.h>
+#include <stddef.h>
+#include "TriangleNormals.hpp"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define TRIANGLE_NORMALS_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#include <emmintrin.h>
+#define TRIANGLE_NORMALS_SSE2
+#endif
+
+// p[iC][j][k] is coordinate j of corner iC of triangle k of the block,
+// and n[j][k] coordinate j of its normal
+struct Block {
+  alignas(32) float p[3][3][8];
+  alignas(32) float n[3][8];
+};
+
+static const int _blockSize = 8;
+
+//////////////////////////////////////////////////////////////////////
+static inline void _normal
+(const float p0[3], const float p1[3], const float p2[3],
+ float n[3], const bool normalize) {
+  float v1[3],v2[3];
+  v1[0] = p1[0]-p0[0]; v1[1] = p1[1]-p0[1]; v1[2] = p1[2]-p0[2];
+  v2[0] = p2[0]-p0[0]; v2[1] = p2[1]-p0[1]; v2[2] = p2[2]-p0[2];
+  n[0] = v1[1]*v2[2]-v1[2]*v2[1];
+  n[1] = v1[2]*v2[0]-v1[0]*v2[2];
+  n[2] = v1[0]*v2[1]-v1[1]*v2[0];
+  if(normalize) {
+    float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
+    if(nn>0.0f) {
+      nn = (float)sqrt(nn);
+      n[0] /= nn; n[1] /= nn; n[2] /= nn;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+#if defined(TRIANGLE_NORMALS_AVX)
+
+static void _block(Block& b, const bool normalize) {
+  __m256 x0 = _mm256_load_ps(b.p[0][0]);
+  __m256 y0 = _mm256_load_ps(b.p[0][1]);
+  __m256 z0 = _mm256_load_ps(b.p[0][2]);
+  __m256 x1 = _mm256_sub_ps(_mm256_load_ps(b.p[1][0]),x0);
+  __m256 y1 = _mm256_sub_ps(_mm256_load_ps(b.p[1][1]),y0);
+  __m256 z1 = _mm256_sub_ps(_mm256_load_ps(b.p[1][2]),z0);
+  __m256 x2 = _mm256_sub_ps(_mm256_load_ps(b.p[2][0]),x0);
+  __m256 y2 = _mm256_sub_ps(_mm256_load_ps(b.p[2][1]),y0);
+  __m256 z2 = _mm256_sub_ps(_mm256_load_ps(b.p[2][2]),z0);
+  __m256 nx = _mm256_sub_ps(_mm256_mul_ps(y1,z2),_mm256_mul_ps(z1,y2));
+  __m256 ny = _mm256_sub_ps(_mm256_mul_ps(z1,x2),_mm256_mul_ps(x1,z2));
+  __m256 nz = _mm256_sub_ps(_mm256_mul_ps(x1,y2),_mm256_mul_ps(y1,x2));
+  if(normalize) {
+    __m256 nn = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx,nx),
+                                            _mm256_mul_ps(ny,ny)),
+                              _mm256_mul_ps(nz,nz));
+    // zero length normals are left unchanged
+    __m256 nonZero = _mm256_cmp_ps(nn,_mm256_setzero_ps(),_CMP_GT_OQ);
+    __m256 len = _mm256_sqrt_ps(nn);
+    nx = _mm256_blendv_ps(nx,_mm256_div_ps(nx,len),nonZero);
+    ny = _mm256_blendv_ps(ny,_mm256_div_ps(ny,len),nonZero);
+    nz = _mm256_blendv_ps(nz,_mm256_div_ps(nz,len),nonZero);
+  }
+  _mm256_store_ps(b.n[0],nx);
+  _mm256_store_ps(b.n[1],ny);
+  _mm256_store_ps(b.n[2],nz);
+}
+
+#elif defined(TRIANGLE_NORMALS_SSE2)
+
+static inline __m128 _select(const __m128 mask, const __m128 a, const __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask,a),_mm_andnot_ps(mask,b));
+}
+
+static void _block(Block& b, const bool normalize) {
+  for(int k=0;k<_blockSize;k+=4) {
+    __m128 x0 = _mm_load_ps(b.p[0][0]+k);
+    __m128 y0 = _mm_load_ps(b.p[0][1]+k);
+    __m128 z0 = _mm_load_ps(b.p[0][2]+k);
+    __m128 x1 = _mm_sub_ps(_mm_load_ps(b.p[1][0]+k),x0);
+    __m128 y1 = _mm_sub_ps(_mm_load_ps(b.p[1][1]+k),y0);
+    __m128 z1 = _mm_sub_ps(_mm_load_ps(b.p[1][2]+k),z0);
+    __m128 x2 = _mm_sub_ps(_mm_load_ps(b.p[2][0]+k),x0);
+    __m128 y2 = _mm_sub_ps(_mm_load_ps(b.p[2][1]+k),y0);
+    __m128 z2 = _mm_sub_ps(_mm_load_ps(b.p[2][2]+k),z0);
+    __m128 nx = _mm_sub_ps(_mm_mul_ps(y1,z2),_mm_mul_ps(z1,y2));
+    __m128 ny = _mm_sub_ps(_mm_mul_ps(z1,x2),_mm_mul_ps(x1,z2));
+    __m128 nz = _mm_sub_ps(_mm_mul_ps(x1,y2),_mm_mul_ps(y1,x2));
+    if(normalize) {
+      __m128 nn = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx,nx),_mm_mul_ps(ny,ny)),
+                             _mm_mul_ps(nz,nz));
+      // zero length normals are left unchanged
+      __m128 nonZero = _mm_cmpgt_ps(nn,_mm_setzero_ps());
+      __m128 len = _mm_sqrt_ps(nn);
+      nx = _select(nonZero,_mm_div_ps(nx,len),nx);
+      ny = _select(nonZero,_mm_div_ps(ny,len),ny);
+      nz = _select(nonZero,_mm_div_ps(nz,len),nz);
+    }
+    _mm_store_ps(b.n[0]+k,nx);
+    _mm_store_ps(b.n[1]+k,ny);
+    _mm_store_ps(b.n[2]+k,nz);
+  }
+}
+
+#else
+
+static void _block(Block& b, const bool normalize) {
+  float p0[3],p1[3],p2[3],n[3];
+  for(int k=0;k<_blockSize;k++) {
+    p0[0] = b.p[0][0][k]; p0[1] = b.p[0][1][k]; p0[2] = b.p[0][2][k];
+    p1[0] = b.p[1][0][k]; p1[1] = b.p[1][1][k]; p1[2] = b.p[1][2][k];
+    p2[0] = b.p[2][0][k]; p2[1] = b.p[2][1][k]; p2[2] = b.p[2][2][k];
+    _normal(p0,p1,p2,n,normalize);
+    b.n[0][k] = n[0]; b.n[1][k] = n[1]; b.n[2][k] = n[2];
+  }
+}
+
+#endif
+
+//////////////////////////////////////////////////////////////////////
+void TriangleNormals::compute
+(const float* coord, const int* index, const int stride,
+ const int nT, float* normal, const bool normalize) {
+  Block b;
+  int iT0,k,iC;
+  for(iT0=0;iT0+_blockSize<=nT;iT0+=_blockSize) {
+    // gather the corners
+    for(k=0;k<_blockSize;k++) {
+      const int* t = index+(size_t)(iT0+k)*stride;
+      for(iC=0;iC<3;iC++) {
+        const float* p = coord+3*(size_t)t[iC];
+        b.p[iC][0][k] = p[0];
+        b.p[iC][1][k] = p[1];
+        b.p[iC][2][k] = p[2];
+      }
+    }
+    _block(b,normalize);
+    // scatter the normals
+    float* n = normal+3*(size_t)iT0;
+    for(k=0;k<_blockSize;k++) {
+      n[3*k  ] = b.n[0][k];
+      n[3*k+1] = b.n[1][k];
+      n[3*k+2] = b.n[2][k];
+    }
+  }
+  for(;iT0<nT;iT0++) {
+    const int* t = index+(size_t)iT0*stride;
+    _normal(coord+3*(size_t)t[0],coord+3*(size_t)t[1],coord+3*(size_t)t[2],
+            normal+3*(size_t)iT0,normalize);
+  }
+}
+
+const char* TriangleNormals::getInstructionSet() {
+#if defined(TRIANGLE_NORMALS_AVX)
+  return "AVX";
+#elif defined(TRIANGLE_NORMALS_SSE2)
+  return "SSE2";
+#else
+  return "scalar";
+#endif
+}
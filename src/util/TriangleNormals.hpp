@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-08-05 16:40:16 taubin>
+//------------------------------------------------------------------------
+//
+// TriangleNormals.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef TRIANGLE_NORMALS_HPP
+#define TRIANGLE_NORMALS_HPP
+
+// Face normals of triangles, computed in blocks of 8
+//
+// The coordinates of the three corners of 8 triangles are gathered
+// into one array per corner and axis, and the 8 normals are computed
+// at once with AVX instructions if the compiler targets them (for
+// example with -mavx2 or -march=native), with SSE2 instructions,
+// which every x86-64 processor has, or with scalar code otherwise.
+// The results are the same in all cases, and the same as computed one
+// face at a time by SceneGraphProcessor: the normal of triangle
+// (p0,p1,p2) is (p1-p0)x(p2-p0), divided by its length if normalize
+// is true and the length is not zero.
+
+namespace TriangleNormals {
+
+  // the corners of triangle iT are index[iT*stride+0,1,2], so stride
+  // is 3 for IndexedFaceSet::getTriangleIndex(), and 4 for the
+  // coordIndex of a triangle mesh; normal[3*iT+0,1,2] receives the
+  // normal of triangle iT, for iT in [0:nT)
+  void compute(const float* coord, const int* index, const int stride,
+               const int nT, float* normal, const bool normalize);
+
+  // "AVX", "SSE2", or "scalar"
+  const char* getInstructionSet();
+
+}
+
+#endif // TRIANGLE_NORMALS_HPP
@@ -39,10 +39,14 @@ Appearance::Appearance():
   _material((Node*)0),
   _texture((Node*)0) /*,*/
   /* _textureTransform;((Node*)0) */
-{}
+{
+  _nodeType = APPEARANCE;
+}
 
-Appearance::~Appearance()
-{}
+Appearance::~Appearance() {
+  if(_material!=(Node*)0) _material->unref(this);
+  if(_texture!=(Node*)0) _texture->unref(this);
+}
 
 
 Node* Appearance::getMaterial() {
@@ -58,12 +62,14 @@ Node* Appearance::getTexture() {
 // }
 
 void Appearance::setMaterial(Node* material) {
-  material->setParent(this);
+  if(material!=(Node*)0) material->ref(this);
+  if(_material!=(Node*)0) _material->unref(this);
   _material = material;
 }
 
 void Appearance::setTexture(Node* texture) {
-  texture->setParent(this);
+  if(texture!=(Node*)0) texture->ref(this);
+  if(_texture!=(Node*)0) _texture->unref(this);
   _texture = texture;
 }
 
@@ -66,7 +66,6 @@ public:
   void setTexture(Node* texture);
   // void setTextureTransform(Node* textureTransform);
 
-  virtual bool    isAppearance() const { return         true; }
   virtual string  getType()      const { return "Appearance"; };
   typedef bool    (*Property)(Appearance& appearance);
   typedef void    (*Operator)(Appearance& appearance);
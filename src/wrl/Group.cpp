@@ -37,12 +37,12 @@
 #include <algorithm>
 #include "Transform.hpp"
 #include "Shape.hpp"
-#include "IndexedFaceSet.hpp"
-#include "IndexedLineSet.hpp"
+#include "util/BBox.hpp"
   
 Group::Group():
 _bboxCenter(0.0f,0.0f,0.0f),
 _bboxSize(-1.0f,-1.0f,-1.0f) {
+  _nodeType = GROUP;
 }
 
 Group::~Group() {
@@ -50,11 +50,13 @@ Group::~Group() {
   while(_children.size()>0) {
     child = _children.back();
     _children.pop_back();
-    delete child;
+    child->unref(this);
   }
 }
 
 vector<pNode>& Group::getChildren() {
+  // the caller may add or remove children
+  invalidateBBox();
   return _children;
 }
 
@@ -96,8 +98,9 @@ float Group::getBBoxDiameter() {
 }
 
 void Group::addChild(const pNode child) {
-  child->setParent(this);
+  child->ref(this);
   _children.push_back(child);
+  invalidateBBox();
 }
 
 void Group::removeChild(const pNode child) {
@@ -105,7 +108,8 @@ void Group::removeChild(const pNode child) {
   node = find(_children.begin(),_children.end(),child);
   if(node!=_children.end()) {
     _children.erase(node);
-    delete &(*node);
+    child->unref(this);
+    invalidateBBox();
   }
 }
 
@@ -145,76 +149,79 @@ void Group::appendBBoxCoord(vector<float>& coord) {
   }
 }
 
-void Group::updateBBox(vector<float>& coord) {
-  if(coord.size()>=3) {
-    if(hasEmptyBBox()) {
-        _bboxCenter.x = coord[0];
-        _bboxCenter.y = coord[1];
-        _bboxCenter.z = coord[2];
-        _bboxSize.x = _bboxSize.y = _bboxSize.z = 0.0f;
-    }
-    Vec3f min;
-    Vec3f max;
-    min.x = _bboxCenter.x-0.5f*_bboxSize.x;
-    min.y = _bboxCenter.y-0.5f*_bboxSize.y;
-    min.z = _bboxCenter.z-0.5f*_bboxSize.z;
-    max.x = _bboxCenter.x+0.5f*_bboxSize.x;
-    max.y = _bboxCenter.y+0.5f*_bboxSize.y;
-    max.z = _bboxCenter.z+0.5f*_bboxSize.z;
-    int nCoord = (int)(coord.size()/3);
-    for(int i=0;i<nCoord;i++) {
-      Vec3f p(coord[3*i+0],coord[3*i+1],coord[3*i+2]);
-      if(p.x<min.x) min.x = p.x; else if(p.x>max.x) max.x = p.x;
-      if(p.y<min.y) min.y = p.y; else if(p.y>max.y) max.y = p.y;
-      if(p.z<min.z) min.z = p.z; else if(p.z>max.z) max.z = p.z;
-    }
-  _bboxCenter.x = (max.x+min.x)/2.0f;
-  _bboxCenter.y = (max.y+min.y)/2.0f;
-  _bboxCenter.z = (max.z+min.z)/2.0f;
-  _bboxSize.x   = (max.x-min.x);
-  _bboxSize.y   = (max.y-min.y);
-  _bboxSize.z   = (max.z-min.z);
+bool Group::getBBox(float box[6]) const {
+  box[0] = _bboxCenter.x-0.5f*_bboxSize.x;
+  box[1] = _bboxCenter.y-0.5f*_bboxSize.y;
+  box[2] = _bboxCenter.z-0.5f*_bboxSize.z;
+  box[3] = _bboxCenter.x+0.5f*_bboxSize.x;
+  box[4] = _bboxCenter.y+0.5f*_bboxSize.y;
+  box[5] = _bboxCenter.z+0.5f*_bboxSize.z;
+  return (_bboxSize.x>=0.0f && _bboxSize.y>=0.0f && _bboxSize.z>=0.0f);
+}
+
+// box <- union of box and other; box is empty if isEmpty is true
+static void _mergeBBox(float box[6], bool& isEmpty, const float other[6]) {
+  for(int j=0;j<3;j++) {
+    if(isEmpty || other[j  ]<box[j  ]) box[j  ] = other[j  ];
+    if(isEmpty || other[j+3]>box[j+3]) box[j+3] = other[j+3];
+  }
+  isEmpty = false;
+}
+
+// box <- bounding box of the 8 corners of box mapped by the matrix M
+// of Transform::getMatrix()
+static void _transformBBox(const float M[16], float box[6]) {
+  float out[6];
+  bool  isEmpty = true;
+  for(int k=0;k<8;k++) {
+    const float p[3] = { box[(k&1)?3:0], box[(k&2)?4:1], box[(k&4)?5:2] };
+    float q[6];
+    for(int i=0;i<3;i++)
+      q[i] = q[i+3] = M[4*i]*p[0]+M[4*i+1]*p[1]+M[4*i+2]*p[2]+M[4*i+3];
+    _mergeBBox(out,isEmpty,q);
+  }
+  for(int j=0;j<6;j++) box[j] = out[j];
+}
+
+static void _setBBox(const float box[6], Vec3f& center, Vec3f& size) {
+  center.x = (box[3]+box[0])/2.0f;
+  center.y = (box[4]+box[1])/2.0f;
+  center.z = (box[5]+box[2])/2.0f;
+  size.x   = (box[3]-box[0]);
+  size.y   = (box[4]-box[1]);
+  size.z   = (box[5]-box[2]);
+}
+
+void Group::updateBBox(const vector<float>& coord) {
+  float box[6],other[6];
+  bool  isEmpty = !getBBox(box);
+  if(BBox::getMinMax(coord.data(),coord.size()/3,other)) {
+    _mergeBBox(box,isEmpty,other);
+    _setBBox(box,_bboxCenter,_bboxSize);
   }
 }
 
 void Group::updateBBox() {
+  if(isBBoxDirty()==false) return;
+  float box[6],other[6];
+  bool  isEmpty = true;
   int nChildren = getNumberOfChildren();
   for(int i=0;i<nChildren;i++) {
     Node* node = (*this)[i];
-    if(node->isTransform()) {
-      Transform* transform = (Transform*)node;
-      transform->updateBBox();
-      // get vertices of bounding box
-      vector<float> coord;
-      transform->appendBBoxCoord(coord);
-      // apply the transform to thoe vertices
-      // TODO Thu Nov 08 18:25:47 2012
-      // update this group bounding box
-      updateBBox(coord);
-    } else if(node->isGroup()) {
+    if(node->isGroup()) {
       Group* group = (Group*)node;
       group->updateBBox();
-      // get vertices of bounding box
-      vector<float> coord;
-      group->appendBBoxCoord(coord);
-      // update this group bounding box
-      updateBBox(coord);
-    } else if(node->isShape()) {
-      Shape* shape = (Shape*)node;
-      node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        IndexedFaceSet* pIfs = (IndexedFaceSet*)node;
-        vector<float> &coord = pIfs->getCoord();    
-        // update this group bounding box
-        updateBBox(coord);
-      } else if(node!=(Node*)0 && node->isIndexedLineSet()) {
-        IndexedLineSet* pIls = (IndexedLineSet*)node;
-        vector<float> &coord = pIls->getCoord();    
-        // update this group bounding box
-        updateBBox(coord);
+      if(group->getBBox(other)) {
+        if(node->isTransform()) { float M[16]; ((Transform*)node)->getMatrix(M); _transformBBox(M,other); }
+        _mergeBBox(box,isEmpty,other);
       }
+    } else if(node->isShape()) {
+      if(((Shape*)node)->getBBox(other))
+        _mergeBBox(box,isEmpty,other);
     }
   }
+  if(isEmpty) clearBBox(); else _setBBox(box,_bboxCenter,_bboxSize);
+  _bboxDirty = false;
 }
 
 void Group::printInfo(string indent) {
@@ -76,10 +76,16 @@ public:
   void                  clearBBox();
   bool                  hasEmptyBBox() const;
   void                  appendBBoxCoord(vector<float>& coord);
-  void                  updateBBox(vector<float>& coord);
+  // box = { xMin, yMin, zMin, xMax, yMax, zMax }; returns false if the
+  // bounding box is empty
+  bool                  getBBox(float box[6]) const;
+  void                  updateBBox(const vector<float>& coord);
+  // recomputes the bounding box from the boxes of the children, with
+  // the transforms of the Transform children applied, if isBBoxDirty()
+  // is true, and recursively only for the children which are dirty
+  // as well; the boxes of the geometry nodes are cached by them
   virtual void          updateBBox();
 
-  virtual bool          isGroup() const { return    true; };
   virtual string        getType() const { return "Group"; };
   typedef bool          (*Property)(Group& group);
   typedef void          (*Operator)(Group& group);
@@ -36,7 +36,7 @@
 #include "ImageTexture.hpp"
 
 ImageTexture::ImageTexture() {
-
+  _nodeType = IMAGE_TEXTURE;
 }
 
 ImageTexture::~ImageTexture() {
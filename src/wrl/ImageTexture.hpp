@@ -59,7 +59,6 @@ public:
   string getUrl(int i);
   void adToUrl(const string& str);
 
-  virtual bool    isImageTexture() const { return           true; }
   virtual string  getType()        const { return "ImageTexture"; }
   typedef bool    (*Property)(ImageTexture& imageTexture);
   typedef void    (*Operator)(ImageTexture& imageTexture);
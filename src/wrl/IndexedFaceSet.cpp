@@ -35,6 +35,9 @@
 #include <iostream>
 #include "util/CastMacros.hpp"
 #include "IndexedFaceSet.hpp"
+#include "core/TriangleMesh.hpp"
+#include "util/Quantize.hpp"
+#include "util/BBox.hpp"
 
 // VRML'97
 //
@@ -59,14 +62,28 @@
 //   field         MFInt32 texCoordIndex     []        # [-1,)
 // }
 
+bool IndexedFaceSet::_defaultTriangleIndex = true;
+
+void IndexedFaceSet::setDefaultTriangleIndex(const bool value) {
+  _defaultTriangleIndex = value;
+}
+
+bool IndexedFaceSet::getDefaultTriangleIndex() {
+  return _defaultTriangleIndex;
+}
+
 IndexedFaceSet::IndexedFaceSet():
   _ccw(true),
   _convex(true),
   _creaseAngle(0),
   _solid(true),
   _normalPerVertex(true),
-  _colorPerVertex(true)
-{}
+  _colorPerVertex(true),
+  _hasBBox(false)
+{
+  _nodeType = INDEXED_FACE_SET;
+  for(int j=0;j<6;j++) _coordQBox[j] = _bbox[j] = 0.0f;
+}
 
 void IndexedFaceSet::clear() {
   _ccw             = true;
@@ -77,12 +94,17 @@ void IndexedFaceSet::clear() {
   _colorPerVertex  = true;
   _coord.clear();
   _coordIndex.clear();
+  _triangleIndex.clear();
   _normal.clear();
   _normalIndex.clear();
   _color.clear();
   _colorIndex.clear();
   _texCoord.clear();
   _texCoordIndex.clear();
+  _coordQ.clear();
+  _normalQ.clear();
+  _colorQ.clear();
+  invalidateBBox();
 }
 
 bool&          IndexedFaceSet::getCcw()              { return _ccw;                }
@@ -91,17 +113,160 @@ float&         IndexedFaceSet::getCreaseangle()      { return _creaseAngle;
 bool&          IndexedFaceSet::getSolid()            { return _solid;              }
 bool&          IndexedFaceSet::getNormalPerVertex()  { return _normalPerVertex;    }
 bool&          IndexedFaceSet::getColorPerVertex()   { return _colorPerVertex;     }
-vector<float>& IndexedFaceSet::getCoord()            { return _coord;              }
-vector<int>&   IndexedFaceSet::getCoordIndex()       { return _coordIndex;         }
-vector<float>& IndexedFaceSet::getNormal()           { return _normal;             }
 vector<int>&   IndexedFaceSet::getNormalIndex()      { return _normalIndex;        }
-vector<float>& IndexedFaceSet::getColor()            { return _color;              }
 vector<int>&   IndexedFaceSet::getColorIndex()       { return _colorIndex;         }
 vector<float>& IndexedFaceSet::getTexCoord()         { return _texCoord;           }
 vector<int>&   IndexedFaceSet::getTexCoordIndex()    { return _texCoordIndex;      }
 
+vector<float>& IndexedFaceSet::getCoord() {
+  if(_coordQ.size()>0) {
+    Quantize::decodeCoord(_coordQ,_coordQBox,_coord);
+    vector<unsigned short>().swap(_coordQ);
+  }
+  // the caller may modify the coordinates
+  invalidateBBox();
+  return _coord;
+}
+
+vector<float>& IndexedFaceSet::getNormal() {
+  if(_normalQ.size()>0) {
+    Quantize::decodeNormal(_normalQ,_normal);
+    vector<unsigned short>().swap(_normalQ);
+  }
+  return _normal;
+}
+
+vector<float>& IndexedFaceSet::getColor() {
+  if(_colorQ.size()>0) {
+    Quantize::decodeColor(_colorQ,_color);
+    vector<unsigned char>().swap(_colorQ);
+  }
+  return _color;
+}
+
+vector<int>& IndexedFaceSet::getCoordIndex() {
+  if(_triangleIndex.size()>0) {
+    TriangleMesh::toCoordIndex(_triangleIndex,_coordIndex);
+    vector<int>().swap(_triangleIndex);
+  }
+  return _coordIndex;
+}
+
+vector<int>& IndexedFaceSet::getTriangleIndex() {
+  return _triangleIndex;
+}
+
+bool IndexedFaceSet::hasTriangleIndex() const {
+  return (_triangleIndex.size()>0);
+}
+
+bool IndexedFaceSet::useTriangleIndex() {
+  if(_triangleIndex.size()>0) return true;
+  if(_coordIndex.size()==0) return false;
+  // properties per corner are indexed by the VRML corners
+  if(_texCoordIndex.size()>0 ||
+     (_normalPerVertex && _normalIndex.size()>0) ||
+     (_colorPerVertex  && _colorIndex.size()>0))
+    return false;
+  if(TriangleMesh::fromCoordIndex(_coordIndex,_triangleIndex)==false)
+    return false;
+  vector<int>().swap(_coordIndex);
+  return true;
+}
+
+bool IndexedFaceSet::quantizeCoord() {
+  if(_coord.size()==0) return _coordQ.size()>0;
+  Quantize::encodeCoord(_coord,_coordQ,_coordQBox);
+  vector<float>().swap(_coord);
+  invalidateBBox();
+  return true;
+}
+
+bool IndexedFaceSet::quantizeNormal() {
+  if(_normal.size()==0) return _normalQ.size()>0;
+  Quantize::encodeNormal(_normal,_normalQ);
+  vector<float>().swap(_normal);
+  return true;
+}
+
+bool IndexedFaceSet::quantizeColor() {
+  if(_color.size()==0) return _colorQ.size()>0;
+  Quantize::encodeColor(_color,_colorQ);
+  vector<float>().swap(_color);
+  return true;
+}
+
+bool IndexedFaceSet::hasQuantizedCoord() const {
+  return (_coordQ.size()>0);
+}
+
+bool IndexedFaceSet::hasQuantizedNormal() const {
+  return (_normalQ.size()>0);
+}
+
+bool IndexedFaceSet::hasQuantizedColor() const {
+  return (_colorQ.size()>0);
+}
+
+const vector<float>& IndexedFaceSet::readCoord(vector<float>& buffer) const {
+  if(_coordQ.size()==0) return _coord;
+  Quantize::decodeCoord(_coordQ,_coordQBox,buffer);
+  return buffer;
+}
+
+const vector<float>& IndexedFaceSet::readNormal(vector<float>& buffer) const {
+  if(_normalQ.size()==0) return _normal;
+  Quantize::decodeNormal(_normalQ,buffer);
+  return buffer;
+}
+
+const vector<float>& IndexedFaceSet::readColor(vector<float>& buffer) const {
+  if(_colorQ.size()==0) return _color;
+  Quantize::decodeColor(_colorQ,buffer);
+  return buffer;
+}
+
+const vector<unsigned short>& IndexedFaceSet::getQuantizedCoord() const {
+  return _coordQ;
+}
+
+const float* IndexedFaceSet::getQuantizedCoordBox() const {
+  return _coordQBox;
+}
+
+const vector<unsigned short>& IndexedFaceSet::getQuantizedNormal() const {
+  return _normalQ;
+}
+
+const vector<unsigned char>& IndexedFaceSet::getQuantizedColor() const {
+  return _colorQ;
+}
+
+bool IndexedFaceSet::getBBox(float box[6]) {
+  if(isBBoxDirty()) {
+    vector<float> buffer;
+    const vector<float>& coord = readCoord(buffer);
+    _hasBBox = BBox::getMinMax(coord.data(),coord.size()/3,_bbox);
+    _bboxDirty = false;
+  }
+  for(int j=0;j<6;j++) box[j] = _bbox[j];
+  return _hasBBox;
+}
+
+size_t IndexedFaceSet::_coordSize() const {
+  return (_coordQ.size()>0)?_coordQ.size():_coord.size();
+}
+
+size_t IndexedFaceSet::_normalSize() const {
+  return (_normalQ.size()>0)?3*_normalQ.size():_normal.size();
+}
+
+size_t IndexedFaceSet::_colorSize() const {
+  return (_colorQ.size()>0)?_colorQ.size():_color.size();
+}
+
 int IndexedFaceSet::getNumberOfCoord() {
-  return static_cast<int>(_coord.size()/3);
+  return static_cast<int>(_coordSize()/3);
 }
 
 int IndexedFaceSet::getNumberOfVertices() {
@@ -109,11 +274,11 @@ int IndexedFaceSet::getNumberOfVertices() {
 }
 
 int IndexedFaceSet::getNumberOfNormal() {
-  return static_cast<int>(_normal.size()/3);
+  return static_cast<int>(_normalSize()/3);
 }
 
 int IndexedFaceSet::getNumberOfColor() {
-  return static_cast<int>(_color.size()/3);
+  return static_cast<int>(_colorSize()/3);
 }
 
 int IndexedFaceSet::getNumberOfTexCoord() {
@@ -121,6 +286,7 @@ int IndexedFaceSet::getNumberOfTexCoord() {
 }
 
 bool IndexedFaceSet::isTriangleMesh() {
+  if(_triangleIndex.size()>0) return true;
   bool value = true;
   int i0,i1,nFi;
   for(i0=i1=0;i1<(int)_coordIndex.size();i1++) {
@@ -137,6 +303,7 @@ bool IndexedFaceSet::isTriangleMesh() {
 }
 
 int IndexedFaceSet::getNumberOfFaces()   {
+  if(_triangleIndex.size()>0) return static_cast<int>(_triangleIndex.size()/3);
   int nFaces = 0;
   for(int i=0;i<(int)_coordIndex.size();i++)
     if(_coordIndex[i]<0)
@@ -145,6 +312,7 @@ int IndexedFaceSet::getNumberOfFaces()   {
 }
 
 int IndexedFaceSet::getNumberOfCorners() {
+  if(_triangleIndex.size()>0) return static_cast<int>(_triangleIndex.size());
   return (int)(_coordIndex.size())-getNumberOfFaces();
 }
   
@@ -173,7 +341,7 @@ IndexedFaceSet::Binding IndexedFaceSet::getNormalBinding() {
   //   }
   // }
   return
-    (_normal.size()==0      )?PB_NONE:
+    (_normalSize()==0       )?PB_NONE:
     (_normalPerVertex==false)?
     ((_normalIndex.size()>0  )?PB_PER_FACE_INDEXED:PB_PER_FACE  ):
     ((_normalIndex.size()>0  )?PB_PER_CORNER      :PB_PER_VERTEX);
@@ -200,7 +368,7 @@ IndexedFaceSet::Binding IndexedFaceSet::getColorBinding() {
   //   }
   // }
   return
-    (_color.size()==0      )?PB_NONE:
+    (_colorSize()==0       )?PB_NONE:
     (_colorPerVertex==false)?
     ((_colorIndex.size()>0  )?PB_PER_FACE_INDEXED:PB_PER_FACE  ):
     ((_colorIndex.size()>0  )?PB_PER_CORNER      :PB_PER_VERTEX);
@@ -235,31 +403,34 @@ bool IndexedFaceSet::hasColorPerVertex() {
   if(_colorIndex.size()==0) return false;
   int nVertices = getNumberOfVertices();
   if(nVertices<=0) return false;
-  return (_color.size()==UL(3*nVertices));
+  return (_colorSize()==UL(3*nVertices));
 }
 
 bool IndexedFaceSet::hasColorPerFace() {
   if(_colorPerVertex==true) return false;
   int nFaces  = getNumberOfFaces();
   if(nFaces<=0) return false;
-  int nColors = I(_color.size()/3);
+  int nColors = I(_colorSize()/3);
   if(nColors<=0) return false;
   // color per face non-indexed
   if(_colorIndex.size()==0)
-    return (_color.size()==UL(3*nFaces));
+    return (_colorSize()==UL(3*nFaces));
   // color per face indexed
   return (_colorIndex.size()==_coordIndex.size());
 }
 
 bool IndexedFaceSet::hasColorPerCorner() {
   if(_colorPerVertex==false) return false;
+  if(_colorIndex.size()==0) return false;
   int nVertices = getNumberOfVertices();
   if(nVertices<=0) return false;
-  int nColor    = I(_color.size()/3);
+  int nColor    = I(_colorSize()/3);
   if(nColor<=0) return false;
   int nFaces    = getNumberOfFaces();
   if(nFaces<=0) return false;
-  return (_colorIndex.size()==_coordIndex.size());
+  // one index per corner, plus one -1 per face, in the layout of
+  // getCoordIndex(); never the case while the triangleIndex is used
+  return (_colorIndex.size()==UL(getNumberOfCorners()+nFaces));
 }
 
 bool IndexedFaceSet::hasColor() {
@@ -271,30 +442,31 @@ bool IndexedFaceSet::hasNormalPerVertex() {
   if(_normalIndex.size()>0) return false;
   int nVertices = getNumberOfVertices();
   if(nVertices<=0) return false;
-  return (_normal.size()==UL(3*nVertices));
+  return (_normalSize()==UL(3*nVertices));
 }
 
 bool IndexedFaceSet::hasNormalPerFace() {
   if(_normalPerVertex==true) return false;
   int nFaces  = getNumberOfFaces();
   if(nFaces<=0) return false;
-  int nNormals = I(_normal.size()/3);
+  int nNormals = I(_normalSize()/3);
   if(nNormals<=0) return false;
   // normal per face non-indexed
-  if(_normalIndex.size()==0) return (_normal.size()==UL(3*nFaces));
+  if(_normalIndex.size()==0) return (_normalSize()==UL(3*nFaces));
   // normal per face indexed
   return (_normalIndex.size()==_coordIndex.size());
 }
 
 bool IndexedFaceSet::hasNormalPerCorner() {
   if(_normalPerVertex==false) return false;
+  if(_normalIndex.size()==0) return false;
   int nVertices = getNumberOfVertices();
   if(nVertices<=0) return false;
-  int nNormals = I(_normal.size()/3);
+  int nNormals = I(_normalSize()/3);
   if(nNormals<=0) return false;
   int nFaces    = getNumberOfFaces();
   if(nFaces<=0) return false;
-  return (_normalIndex.size()==_coordIndex.size());
+  return (_normalIndex.size()==UL(getNumberOfCorners()+nFaces));
 }
 
 bool IndexedFaceSet::hasNormal() {
@@ -350,15 +522,22 @@ void IndexedFaceSet::printInfo(string indent) {
   std::cout << indent << "  coordBinding       = " <<
     stringBinding(getCoordBinding()) << "\n";
   std::cout << indent << "  nCoord             = " <<
-    _coord.size()/3 << "\n";
+    _coordSize()/3 << "\n";
+  if(_coordQ.size()>0)
+    std::cout << indent << "  coord quantized    = 16 bit\n";
   std::cout << indent << "  coordIndex.size()  = " <<
     _coordIndex.size() << "\n";
+  if(_triangleIndex.size()>0)
+    std::cout << indent << "  triangleIndex.size() = " <<
+      _triangleIndex.size() << "\n";
   std::cout << indent << "  normalBinding      = " <<
     stringBinding(getNormalBinding()) << "\n";
   std::cout << indent << "  normalPerVertex    = " <<
     _normalPerVertex << "\n";
   std::cout << indent << "  nNormal            = " <<
-    _normal.size()/3 << "\n";
+    _normalSize()/3 << "\n";
+  if(_normalQ.size()>0)
+    std::cout << indent << "  normal quantized   = 16 bit octahedral\n";
   std::cout << indent << "  normalIndex.size() = " <<
     _normalIndex.size() << "\n";
   std::cout << indent << "  colorBinding       = " <<
@@ -366,7 +545,9 @@ void IndexedFaceSet::printInfo(string indent) {
   std::cout << indent << "  colorPerVertex     = " <<
     _colorPerVertex << "\n";
   std::cout << indent << "  nColor             = " <<
-    _color.size()/3 << "\n";
+    _colorSize()/3 << "\n";
+  if(_colorQ.size()>0)
+    std::cout << indent << "  color quantized    = 8 bit\n";
   std::cout << indent << "  colorIndex.size()  = " <<
     _colorIndex.size() << "\n";
   std::cout << indent << "  texCoordBinding    = " <<
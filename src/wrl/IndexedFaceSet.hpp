@@ -75,6 +75,10 @@ private:
   vector<float>  _coord;
   vector<int>    _coordIndex;
 
+  // faces of a triangle mesh, three vertex indices each, held instead
+  // of coordIndex; see useTriangleIndex()
+  vector<int>    _triangleIndex;
+
   bool           _normalPerVertex;
   vector<float>  _normal;
   vector<int>    _normalIndex;
@@ -86,6 +90,18 @@ private:
   vector<float>  _texCoord;
   vector<int>    _texCoordIndex;
 
+  // compact encodings held instead of coord, normal and color; see
+  // quantizeCoord()
+  vector<unsigned short> _coordQ;
+  float                  _coordQBox[6];
+  vector<unsigned short> _normalQ;
+  vector<unsigned char>  _colorQ;
+
+  // { xMin, yMin, zMin, xMax, yMax, zMax } of coord, valid while
+  // isBBoxDirty() is false; see getBBox()
+  float                  _bbox[6];
+  bool                   _hasBBox;
+
 public:
   
   IndexedFaceSet();
@@ -97,7 +113,11 @@ public:
   bool&           getSolid();
   bool&           getNormalPerVertex();
   bool&           getColorPerVertex();
+  // getCoord(), getNormal() and getColor() decode the values back
+  // into floats if they are held in a compact encoding
   vector<float>&  getCoord();
+  // converts the faces back to the VRML layout if they are held in
+  // triangleIndex
   vector<int>&    getCoordIndex();
   vector<float>&  getNormal();
   vector<int>&    getNormalIndex();
@@ -107,6 +127,56 @@ public:
   vector<int>&    getTexCoordIndex();
 
   bool            isTriangleMesh();
+
+  // - Triangle meshes may hold their faces in triangleIndex, three
+  //   vertex indices per face without -1 separators, instead of in
+  //   coordIndex; this takes 25% less memory, and consumers which
+  //   check hasTriangleIndex() can loop over the faces without
+  //   looking for separators
+  // - useTriangleIndex() moves the faces from coordIndex into
+  //   triangleIndex, and returns true, if all the faces are triangles,
+  //   and no property is bound per corner
+  // - getCoordIndex() moves them back
+  // - loaders fill getTriangleIndex() directly, while coordIndex is
+  //   empty, if getDefaultTriangleIndex() is true
+  bool            hasTriangleIndex() const;
+  bool            useTriangleIndex();
+  vector<int>&    getTriangleIndex();
+
+  static void     setDefaultTriangleIndex(const bool value);
+  static bool     getDefaultTriangleIndex();
+
+  // - coord, normal and color may be held in compact encodings, see
+  //   util/Quantize.hpp: 16 bit coordinates relative to the bounding
+  //   box, 16 bit octahedral normals, and 8 bit colors; this takes
+  //   1/2, 1/6 and 1/4 of the memory, respectively, and is lossy
+  // - quantizeCoord(), quantizeNormal() and quantizeColor() encode the
+  //   values and release the float arrays; they return false if there
+  //   is nothing to encode
+  // - readCoord(), readNormal() and readColor() give read-only access
+  //   to the values without changing the storage: they decode into
+  //   buffer and return it if the values are encoded, and return the
+  //   float array otherwise
+  bool            quantizeCoord();
+  bool            quantizeNormal();
+  bool            quantizeColor();
+  bool            hasQuantizedCoord() const;
+  bool            hasQuantizedNormal() const;
+  bool            hasQuantizedColor() const;
+  const vector<float>& readCoord(vector<float>& buffer) const;
+  const vector<float>& readNormal(vector<float>& buffer) const;
+  const vector<float>& readColor(vector<float>& buffer) const;
+  const vector<unsigned short>& getQuantizedCoord() const;
+  const float*                  getQuantizedCoordBox() const;
+  const vector<unsigned short>& getQuantizedNormal() const;
+  const vector<unsigned char>&  getQuantizedColor() const;
+
+  // box = { xMin, yMin, zMin, xMax, yMax, zMax } of the coordinates;
+  // returns false if there are none. The box is cached until the
+  // coordinates are accessed through getCoord(), quantizeCoord() or
+  // clear()
+  bool            getBBox(float box[6]);
+
   int             getNumberOfFaces();
   int             getNumberOfCorners();
 
@@ -155,12 +225,19 @@ public:
   bool            hasTexCoordPerCorner();
   bool            hasTexCoord();
 
-  virtual bool    isIndexedFaceSet() const { return             true; }
   virtual string  getType()          const { return "IndexedFaceSet"; }
   typedef bool    (*Property)(IndexedFaceSet& ifs);
   typedef void    (*Operator)(IndexedFaceSet& ifs);
 
   virtual void    printInfo(string indent);
+
+private:
+
+  static bool     _defaultTriangleIndex;
+
+  size_t          _coordSize() const;
+  size_t          _normalSize() const;
+  size_t          _colorSize() const;
 };
 
 #endif /* _IndexedFaceSet_h_ */
@@ -40,6 +40,7 @@
 // DAMAGE.
 
 #include "IndexedFaceSetPly.hpp"
+#include <core/TriangleMesh.hpp>
 #include <util/Endian.hpp>
 #include <util/CastMacros.hpp>
 #include <io/StrException.hpp>
@@ -191,7 +192,10 @@ IndexedFaceSetPly::IndexedFaceSetPly(Ply * ply, const string indent):
         Ply::Element::Property* coordIndexP = face->getProperty("coordIndex");
         vector<int>* coordIndexV =
           static_cast<vector<int>*>(coordIndexP->getValue());
-        coordIndex.insert(coordIndex.end(),coordIndexV->begin(),coordIndexV->end());
+        // triangle meshes are held in triangleIndex, without the -1's
+        if(getDefaultTriangleIndex()==false ||
+           TriangleMesh::fromCoordIndex(*coordIndexV,getTriangleIndex())==false)
+          coordIndex.insert(coordIndex.end(),coordIndexV->begin(),coordIndexV->end());
     
         // normals per face
         Ply::Element::Property* normalP = face->getProperty("normal");
@@ -337,12 +341,18 @@ IndexedFaceSetPly::IndexedFaceSetPly(Ply * ply, const string indent):
       
         Ply::Element::Property* indxP = face->getProperty("vertex_indices");
         vector<int>*            indxV = static_cast<vector<int>*>(indxP->getValue());
+        // triangle meshes are held in triangleIndex, without the -1's
+        bool triangles = getDefaultTriangleIndex() && nFaces>0;
+        for(iF=0;triangles && iF<nFaces;iF++)
+          triangles = (indxP->getListFirst(iF+1)-indxP->getListFirst(iF)==3);
+        vector<int>& faceIndex = (triangles)?getTriangleIndex():coordIndex;
         for(iF=0;iF<nFaces;iF++) {
           i0   = indxP->getListFirst(iF );
           i1   = indxP->getListFirst(iF+1);
           for(i=i0;i<i1;i++)
-            coordIndex.push_back((*indxV)[UL(i)]);
-          coordIndex.push_back(-1);
+            faceIndex.push_back((*indxV)[UL(i)]);
+          if(triangles==false)
+            faceIndex.push_back(-1);
         }
     
         // normals per face
@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include "IndexedLineSet.hpp"
+#include "util/BBox.hpp"
 
 // VRML'97
 //
@@ -48,8 +49,12 @@
 // }
 
 IndexedLineSet::IndexedLineSet():
-  _colorPerVertex(true)
-{}
+  _colorPerVertex(true),
+  _hasBBox(false)
+{
+  _nodeType = INDEXED_LINE_SET;
+  for(int j=0;j<6;j++) _bbox[j] = 0.0f;
+}
 
 void IndexedLineSet::clear() {
   _coord.clear();
@@ -57,14 +62,29 @@ void IndexedLineSet::clear() {
   _color.clear();
   _colorIndex.clear();
   _colorPerVertex  = true;
+  invalidateBBox();
 }
 
 bool&          IndexedLineSet::getColorPerVertex()   { return _colorPerVertex;     }
-vector<float>& IndexedLineSet::getCoord()            { return _coord;              }
 vector<int>&   IndexedLineSet::getCoordIndex()       { return _coordIndex;         }
 vector<float>& IndexedLineSet::getColor()            { return _color;              }
 vector<int>&   IndexedLineSet::getColorIndex()       { return _colorIndex;         }
 
+// the caller may modify the coordinates
+vector<float>& IndexedLineSet::getCoord() {
+  invalidateBBox();
+  return _coord;
+}
+
+bool IndexedLineSet::getBBox(float box[6]) {
+  if(isBBoxDirty()) {
+    _hasBBox = BBox::getMinMax(_coord.data(),_coord.size()/3,_bbox);
+    _bboxDirty = false;
+  }
+  for(int j=0;j<6;j++) box[j] = _bbox[j];
+  return _hasBBox;
+}
+
 int            IndexedLineSet::getNumberOfCoord()    { return (int)(_coord.size()/3);    }
 int            IndexedLineSet::getNumberOfColor()    { return (int)(_color.size()/3);    }
 
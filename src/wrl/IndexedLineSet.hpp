@@ -62,6 +62,11 @@ private:
   vector<int>   _colorIndex;
   bool          _colorPerVertex;
 
+  // { xMin, yMin, zMin, xMax, yMax, zMax } of coord, valid while
+  // isBBoxDirty() is false; see getBBox()
+  float         _bbox[6];
+  bool          _hasBBox;
+
 public:
   
   IndexedLineSet();
@@ -73,6 +78,11 @@ public:
   vector<float>& getColor();
   vector<int>&   getColorIndex();
 
+  // box = { xMin, yMin, zMin, xMax, yMax, zMax } of the coordinates;
+  // returns false if there are none. The box is cached until the
+  // coordinates are accessed through getCoord() or clear()
+  bool           getBBox(float box[6]);
+
   int            getNumberOfPolylines();
 
   int            getNumberOfCoord();
@@ -80,7 +90,6 @@ public:
 
   void           setColorPerVertex(bool value);
 
-  virtual bool    isIndexedLineSet() const { return             true; }
   virtual string  getType()          const { return "IndexedLineSet"; }
   typedef bool    (*Property)(IndexedLineSet& ifs);
   typedef void    (*Operator)(IndexedLineSet& ifs);
@@ -42,6 +42,7 @@ Material::Material():
   _shininess(0.2f),
   _specularColor(0.0f,0.0f,0.0f),
   _transparency(0.0f) {
+  _nodeType = MATERIAL;
 }
 
 Material::~Material() {
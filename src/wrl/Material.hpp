@@ -78,7 +78,6 @@ public:
   void   setSpecularColor(Color& value);
   void   setTransparency(float value);
 
-  virtual bool    isMaterial() const { return true; }
   virtual string  getType()    const { return "Material"; }
   typedef bool    (*Property)(Material& material);
   typedef void    (*Operator)(Material& material);
@@ -160,12 +160,45 @@ void Vec4f::normalize() {
 Node::Node():
   _name(""),
   _parent((Node*)0),
-  _show(true) {
+  _show(true),
+  _nodeType(NODE),
+  _refCount(0),
+  _bboxDirty(true) {
 }
 
 Node::~Node() {
 }
 
+// the header keeps the node aligned as a block returned by new is
+static const size_t _allocHeader = alignof(max_align_t);
+
+void* Node::operator new(size_t size) {
+  return operator new(size,(Arena*)0);
+}
+
+void* Node::operator new(size_t size, Arena* arena) {
+  char* p = (char*)((arena!=(Arena*)0)?
+                    arena->allocate(size+_allocHeader):
+                    ::operator new(size+_allocHeader));
+  *((Arena**)p) = arena;
+  return p+_allocHeader;
+}
+
+void Node::operator delete(void* p) {
+  if(p==(void*)0) return;
+  char*  q     = ((char*)p)-_allocHeader;
+  Arena* arena = *((Arena**)q);
+  if(arena!=(Arena*)0)
+    arena->deallocate(q);
+  else
+    ::operator delete(q);
+}
+
+// called when the constructor of a node allocated by new (arena) throws
+void Node::operator delete(void* p, Arena* /*arena*/) {
+  operator delete(p);
+}
+
 const string& Node::getName() const {
   return _name;
 }
@@ -187,6 +220,50 @@ void Node::setParent(const Node* node) {
   _parent = node;
 }
 
+void Node::ref(const Node* parent) {
+  if(_refCount==0)
+    _parent = parent;
+  else
+    _otherParent.push_back(parent);
+  _refCount++;
+}
+
+void Node::unref(const Node* parent) {
+  if(--_refCount<=0) {
+    delete this;
+  } else if(_parent==parent && _otherParent.size()>0) {
+    _parent = _otherParent.back(); _otherParent.pop_back();
+  } else {
+    for(size_t i=0;i<_otherParent.size();i++)
+      if(_otherParent[i]==parent) {
+        _otherParent[i] = _otherParent.back(); _otherParent.pop_back();
+        break;
+      }
+  }
+}
+
+int Node::getRefCount() const {
+  return _refCount;
+}
+
+void Node::invalidateBBox() const {
+  const Node* node = this;
+  // the ancestors of a dirty node are dirty as well, so the walk stops
+  // at the first node already marked, and visits each ancestor once
+  while(node!=(Node*)0 &&
+        node->_bboxDirty.exchange(true,memory_order_relaxed)==false) {
+    // the other parents of a shared node are followed recursively
+    for(const Node* parent : node->_otherParent)
+      parent->invalidateBBox();
+    // a SceneGraph is its own parent
+    node = (node->_parent!=node)?node->_parent:(Node*)0;
+  }
+}
+
+bool Node::isBBoxDirty() const {
+  return _bboxDirty.load(memory_order_relaxed);
+}
+
 bool Node::getShow() const {
   return _show;
 }
@@ -198,7 +275,7 @@ void Node::setShow(const bool value) {
 int Node::getDepth() const {
   int d = 0;
   const Node* p = _parent;
-  while((p!=p->_parent)) {
+  while(p!=(Node*)0 && p!=p->_parent) {
     if(p->isGroup())
       d++;
     p = p->_parent;
@@ -207,17 +284,6 @@ int Node::getDepth() const {
   return d;
 }
 
-bool    Node::isAppearance() const     { return  false; }
-bool    Node::isGroup() const          { return  false; }
-bool    Node::isImageTexture() const   { return  false; }
-bool    Node::isIndexedFaceSet() const { return  false; }
-bool    Node::isIndexedLineSet() const { return  false; }
-bool    Node::isMaterial() const       { return  false; }
-bool    Node::isPixelTexture() const   { return  false; }
-bool    Node::isSceneGraph() const     { return  false; }
-bool    Node::isShape() const          { return  false; }
-bool    Node::isTransform() const      { return  false; }
-
 string  Node::getType() const          { return "Node"; }
 
 void    Node::printInfo(string indent) {
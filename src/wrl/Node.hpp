@@ -36,6 +36,10 @@
 #define _Node_h_
 
 #include <string>
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include "util/Arena.hpp"
 
 using namespace std;
 
@@ -88,17 +92,54 @@ public:
 
 class Node {
 
+public:
+
+  // class of a node, set by the constructor of the class; Group and
+  // the classes derived from it come last, see isGroup()
+  enum NodeType : unsigned char {
+    NODE = 0,
+    APPEARANCE,
+    IMAGE_TEXTURE,
+    INDEXED_FACE_SET,
+    INDEXED_LINE_SET,
+    MATERIAL,
+    PIXEL_TEXTURE,
+    SHAPE,
+    GROUP,
+    SCENE_GRAPH,
+    TRANSFORM
+  };
+
 protected:
 
   string      _name;
   const Node* _parent;
   bool        _show;
+  NodeType    _nodeType;
+  int         _refCount;
+
+  // the parents which hold the node besides _parent, one entry per
+  // reference; see ref()
+  vector<const Node*> _otherParent;
+
+  // set when the bounding box cached by the node, if any, has to be
+  // recomputed; see invalidateBBox()
+  mutable atomic<bool> _bboxDirty;
 
 public:
   
   Node();
   virtual ~Node();
 
+  // Nodes are allocated with a header which records the Arena they
+  // were taken from, so that delete works the same for all of them;
+  // new (arena) Shape() allocates from the arena, or from the heap
+  // when arena is null. See SceneGraph::setUseArena()
+  static void*    operator new(size_t size);
+  static void*    operator new(size_t size, Arena* arena);
+  static void     operator delete(void* p);
+  static void     operator delete(void* p, Arena* arena);
+
   const string&   getName() const;
   void            setName(const string& name);
   bool            nameEquals(const string& name);
@@ -108,16 +149,43 @@ public:
   void            setShow(const bool value);
   int             getDepth() const; 
 
-  virtual bool    isAppearance() const;
-  virtual bool    isGroup() const;
-  virtual bool    isImageTexture() const;
-  virtual bool    isIndexedFaceSet() const;
-  virtual bool    isIndexedLineSet() const;
-  virtual bool    isMaterial() const;
-  virtual bool    isPixelTexture() const;
-  virtual bool    isSceneGraph() const;
-  virtual bool    isShape() const;
-  virtual bool    isTransform() const;
+  // Nodes stored in the fields of Group, Shape, and Appearance nodes
+  // are reference counted, so that the same node can be shared by
+  // several parents (VRML DEF/USE). getParent() returns the first
+  // parent the node was stored in; when that parent drops the node,
+  // one of the remaining parents takes its place. The node is deleted
+  // by the last one.
+  void            ref(const Node* parent);
+  void            unref(const Node* parent);
+  int             getRefCount() const;
+
+  // Group and geometry nodes cache their bounding boxes. A node whose
+  // coordinates or transform change calls invalidateBBox(), which
+  // marks the node and its ancestors along all the parents, so that
+  // only the boxes of those nodes are recomputed by the next
+  // Group::updateBBox(); this may be called from concurrent threads.
+  // Values changed through the references returned by the get
+  // methods of Transform and Group are not tracked
+  void            invalidateBBox() const;
+  bool            isBBoxDirty() const;
+
+  // the type tests compare the type tag, rather than calling a
+  // virtual method or dynamic_cast for every node visited; code which
+  // handles several types can switch on getNodeType(). A test is true
+  // for the derived classes as well: isGroup() for SceneGraph and
+  // Transform, and isPixelTexture() for ImageTexture
+  NodeType        getNodeType()      const { return _nodeType;                   }
+  bool            isAppearance()     const { return _nodeType==APPEARANCE;       }
+  bool            isGroup()          const { return _nodeType>=GROUP;            }
+  bool            isImageTexture()   const { return _nodeType==IMAGE_TEXTURE;    }
+  bool            isIndexedFaceSet() const { return _nodeType==INDEXED_FACE_SET; }
+  bool            isIndexedLineSet() const { return _nodeType==INDEXED_LINE_SET; }
+  bool            isMaterial()       const { return _nodeType==MATERIAL;         }
+  bool            isPixelTexture()   const { return _nodeType==PIXEL_TEXTURE ||
+                                                    _nodeType==IMAGE_TEXTURE;    }
+  bool            isSceneGraph()     const { return _nodeType==SCENE_GRAPH;      }
+  bool            isShape()          const { return _nodeType==SHAPE;            }
+  bool            isTransform()      const { return _nodeType==TRANSFORM;        }
   virtual string  getType() const;
 
   typedef bool    (*Property)(Node& node);
@@ -38,7 +38,7 @@
 PixelTexture::PixelTexture():
   _repeatS(true),
   _repeatT(true) {
-
+  _nodeType = PIXEL_TEXTURE;
   }
 
 PixelTexture::~PixelTexture() {
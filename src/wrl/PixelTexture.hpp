@@ -65,7 +65,6 @@ public:
   void setRepeatS(bool value);
   void setRepeatT(bool value);
 
-  virtual bool    isPixelTexture() const { return           true; }
   virtual string  getType()        const { return "PixelTexture"; }
   typedef bool    (*Property)(PixelTexture& pixelTexture);
   typedef void    (*OPerator)(PixelTexture& pixelTexture);
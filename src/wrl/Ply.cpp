@@ -58,6 +58,11 @@ void Ply::setDebug(const bool value) {
   _debug = value;
 }
 
+// static
+bool Ply::getDebug() {
+  return _debug;
+}
+
 // static
 void Ply::setFloatFormat(const string fmt) {
   _floatFormat = fmt;
@@ -56,6 +56,7 @@ public:
   };
 
   static void         setDebug(const bool value);
+  static bool         getDebug();
   static void         setFloatFormat(const string fmt);
   static void         setIntFormat(const string fmt);
   static void         setSkipComments(const bool value);
@@ -38,19 +38,49 @@
 #include "Shape.hpp"
 #include "Appearance.hpp"
   
-SceneGraph::SceneGraph() {
+SceneGraph::SceneGraph():
+  _useArena(false),
+  _arena((Arena*)0) {
+  _nodeType = SCENE_GRAPH;
   _parent = this;
 }
 
 SceneGraph::~SceneGraph() {
+  // the children are deleted here, rather than by ~Group(), so that
+  // the arena is released after them
+  clear();
+  if(_arena!=(Arena*)0) _arena->release();
 }
 
 void SceneGraph::clear() {
   pNode node;
   while(_children.size()>0) {
     node = _children.back(); _children.pop_back();
-    delete node;
+    node->unref(this);
   }
+  invalidateBBox();
+  if(_arena!=(Arena*)0 && _arena->reset()==false) {
+    // some nodes are still in use
+    _arena->release();
+    _arena = (Arena*)0;
+  }
+}
+
+void SceneGraph::setUseArena(const bool value) {
+  _useArena = value;
+  if(_useArena==false && _arena!=(Arena*)0) {
+    _arena->release();
+    _arena = (Arena*)0;
+  }
+}
+
+bool SceneGraph::getUseArena() const {
+  return _useArena;
+}
+
+Arena* SceneGraph::getArena() {
+  if(_useArena && _arena==(Arena*)0) _arena = new Arena();
+  return _arena;
 }
 
 string& SceneGraph::getUrl() {
@@ -51,6 +51,8 @@ class SceneGraph : public Group {
 private:
 
   string _url;
+  bool   _useArena;
+  Arena* _arena;
 
 public:
   
@@ -58,13 +60,23 @@ public:
   virtual ~SceneGraph();
 
   void            clear();
+
+  // When enabled, the loaders allocate the nodes of the scene graph
+  // from an Arena owned by it, which keeps them contiguous in memory,
+  // and clear() returns the arena chunks at once after the nodes are
+  // destroyed. Nodes which are still referenced elsewhere at that
+  // point keep the old arena alive, and a new one is started.
+  // getArena() returns null when disabled, which the loaders take as
+  // the heap
+  void            setUseArena(const bool value);
+  bool            getUseArena() const;
+  Arena*          getArena();
   
   string&         getUrl();
   void            setUrl(const string& url);
 
   Node*           find(const string& name);
 
-  virtual bool    isSceneGraph() const { return         true; }
   virtual string  getType()      const { return "SceneGraph"; }
   typedef bool    (*Property)(SceneGraph& sceneGraph);
   typedef void    (*Operator)(SceneGraph& sceneGraph);
@@ -34,6 +34,7 @@
 
 #include <math.h>
 #include <iostream>
+#include <algorithm>
 #include "SceneGraphProcessor.hpp"
 #include "SceneGraphTraversal.hpp"
 #include "Shape.hpp"
@@ -41,12 +42,32 @@
 #include "IndexedLineSet.hpp"
 #include "Appearance.hpp"
 #include "Material.hpp"
+#include "io/StrException.hpp"
+#include "core/Graph.hpp"
+#include "core/HalfEdges.hpp"
+#include "core/Partition.hpp"
+#include "core/TriangleMesh.hpp"
+#include "util/TriangleNormals.hpp"
 
 SceneGraphProcessor::SceneGraphProcessor(SceneGraph& wrl):
-  _wrl(wrl) {
+  _wrl(wrl),
+  _nThreads(0),
+  _pool((ThreadPool*)0) {
 }
 
 SceneGraphProcessor::~SceneGraphProcessor() {
+  if(_pool!=(ThreadPool*)0) delete _pool;
+}
+
+void SceneGraphProcessor::setNumberOfThreads(const int nThreads) {
+  if(nThreads==_nThreads) return;
+  _nThreads = nThreads;
+  if(_pool!=(ThreadPool*)0) delete _pool;
+  _pool = (ThreadPool*)0;
+}
+
+int SceneGraphProcessor::getNumberOfThreads() const {
+  return _nThreads;
 }
 
 void SceneGraphProcessor::normalClear() {
@@ -62,14 +83,48 @@ void SceneGraphProcessor::computeNormalPerFace() {
 }
 
 void SceneGraphProcessor::computeNormalPerVertex() {
-  _applyToIndexedFaceSet(_computeNormalPerVertex);
+  // IndexedFaceSets with at least this many vertices are split across
+  // the threads; the smaller ones are processed one per thread
+  const int minVerticesToSplit = 1<<16;
+  vector<IndexedFaceSet*> ifsList;
+  _getIndexedFaceSets(ifsList);
+  ThreadPool& pool = _getThreadPool();
+  size_t nLarge = 0; // ifsList is sorted by decreasing size
+  if(pool.getNumberOfThreads()>1)
+    while(nLarge<ifsList.size() &&
+          ifsList[nLarge]->getNumberOfCoord()>=minVerticesToSplit)
+      nLarge++;
+  for(size_t i=0;i<nLarge;i++)
+    _computeNormalPerVertex(*ifsList[i],pool);
+  pool.run(static_cast<int>(ifsList.size()-nLarge),
+           [&ifsList,nLarge](int i) {
+             _computeNormalPerVertex(*ifsList[nLarge+i]);
+           });
 }
 
 void SceneGraphProcessor::computeNormalPerCorner() {
   _applyToIndexedFaceSet(_computeNormalPerCorner);
 }
 
-void SceneGraphProcessor::_applyToIndexedFaceSet(IndexedFaceSet::Operator o) {
+void SceneGraphProcessor::quantize() {
+  _applyToIndexedFaceSet(_quantize);
+}
+
+void SceneGraphProcessor::dequantize() {
+  _applyToIndexedFaceSet(_dequantize);
+}
+
+void SceneGraphProcessor::vertexReorder() {
+  _applyToIndexedFaceSet(_vertexReorder);
+}
+
+void SceneGraphProcessor::triangleReorder() {
+  _applyToIndexedFaceSet(_triangleReorder);
+}
+
+float SceneGraphProcessor::getAcmr(const int cacheSize) {
+  double nTransformed = 0.0;
+  int    nTriangles   = 0;
   SceneGraphTraversal traversal(_wrl);
   traversal.start();
   Node* node;
@@ -79,10 +134,61 @@ void SceneGraphProcessor::_applyToIndexedFaceSet(IndexedFaceSet::Operator o) {
       node = shape->getGeometry();
       if(node!=(Node*)0 && node->isIndexedFaceSet()) {
         IndexedFaceSet& ifs = *((IndexedFaceSet*)node);
-        o(ifs);
+        vector<int> triangleIndex;
+        if(ifs.hasTriangleIndex()==false &&
+           TriangleMesh::fromCoordIndex(ifs.getCoordIndex(),triangleIndex)==false)
+          continue;
+        TriangleMesh mesh(ifs.getNumberOfVertices(),
+                          (ifs.hasTriangleIndex())?
+                          ifs.getTriangleIndex():triangleIndex);
+        nTransformed += mesh.getAcmr(cacheSize)*mesh.getNumberOfFaces();
+        nTriangles   += mesh.getNumberOfFaces();
       }
     }
   }
+  return (nTriangles>0)?static_cast<float>(nTransformed/nTriangles):0.0f;
+}
+
+void SceneGraphProcessor::removeUnusedVertices() {
+  _applyToIndexedFaceSet(_removeUnusedVertices);
+}
+
+// collects every IndexedFaceSet once, even if it is shared by several
+// Shapes, the largest ones first
+void SceneGraphProcessor::_getIndexedFaceSets(vector<IndexedFaceSet*>& ifsList) {
+  ifsList.clear();
+  SceneGraphTraversal traversal(_wrl);
+  traversal.start();
+  Node* node;
+  while((node=traversal.next())!=(Node*)0) {
+    if(node->isShape()) {
+      Shape* shape = (Shape*)node;
+      node = shape->getGeometry();
+      if(node!=(Node*)0 && node->isIndexedFaceSet())
+        ifsList.push_back((IndexedFaceSet*)node);
+    }
+  }
+  vector< pair<int,IndexedFaceSet*> > key(ifsList.size());
+  for(size_t i=0;i<ifsList.size();i++)
+    key[i] = make_pair(-ifsList[i]->getNumberOfCoord(),ifsList[i]);
+  // by decreasing size, and the same node next to its other uses
+  sort(key.begin(),key.end());
+  ifsList.clear();
+  for(size_t i=0;i<key.size();i++)
+    if(i==0 || key[i].second!=key[i-1].second)
+      ifsList.push_back(key[i].second);
+}
+
+ThreadPool& SceneGraphProcessor::_getThreadPool() {
+  if(_pool==(ThreadPool*)0) _pool = new ThreadPool(_nThreads);
+  return *_pool;
+}
+
+void SceneGraphProcessor::_applyToIndexedFaceSet(IndexedFaceSet::Operator o) {
+  vector<IndexedFaceSet*> ifsList;
+  _getIndexedFaceSets(ifsList);
+  _getThreadPool().run(static_cast<int>(ifsList.size()),
+                       [&ifsList,o](int i) { o(*ifsList[i]); });
 }
 
 void SceneGraphProcessor::_normalClear(IndexedFaceSet& ifs) {
@@ -93,6 +199,346 @@ void SceneGraphProcessor::_normalClear(IndexedFaceSet& ifs) {
   normalIndex.clear();
 }
 
+void SceneGraphProcessor::_quantize(IndexedFaceSet& ifs) {
+  ifs.quantizeCoord();
+  ifs.quantizeNormal();
+  ifs.quantizeColor();
+}
+
+void SceneGraphProcessor::_dequantize(IndexedFaceSet& ifs) {
+  ifs.getCoord();
+  ifs.getNormal();
+  ifs.getColor();
+}
+
+// spreads the 21 lower bits of v over every third bit
+static unsigned long long _mortonSpread(const unsigned v) {
+  unsigned long long x = v&0x1fffff;
+  x = (x|(x<<32))&0x001f00000000ffffULL;
+  x = (x|(x<<16))&0x001f0000ff0000ffULL;
+  x = (x|(x<< 8))&0x100f00f00f00f00fULL;
+  x = (x|(x<< 4))&0x10c30c30c30c30c3ULL;
+  x = (x|(x<< 2))&0x1249249249249249ULL;
+  return x;
+}
+
+// inverse of _mortonSpread
+static unsigned _mortonCompact(unsigned long long x) {
+  x &= 0x1249249249249249ULL;
+  x = (x|(x>> 2))&0x10c30c30c30c30c3ULL;
+  x = (x|(x>> 4))&0x100f00f00f00f00fULL;
+  x = (x|(x>> 8))&0x001f0000ff0000ffULL;
+  x = (x|(x>>16))&0x001f00000000ffffULL;
+  x = (x|(x>>32))&0x00000000001fffffULL;
+  return static_cast<unsigned>(x);
+}
+
+// value[dim*i+j] <- value[dim*order[i]+j]; arrays of other sizes are
+// not bound to the permuted elements, and are left unchanged
+template<class T>
+static void _permute
+(vector<T>& value, const size_t dim, const vector<int>& order) {
+  if(value.size()!=dim*order.size()) return;
+  vector<T> tmp(value.size());
+  for(size_t i=0;i<order.size();i++)
+    for(size_t j=0;j<dim;j++)
+      tmp[dim*i+j] = value[dim*order[i]+j];
+  value.swap(tmp);
+}
+
+// reorders the faces of an array with the layout of coordIndex, where
+// face iF spans [faceStart[iF]:faceStart[iF+1]), separator included
+static void _permuteFaces
+(vector<int>& index, const vector<int>& faceStart, const vector<int>& order) {
+  if(index.size()!=static_cast<size_t>(faceStart.back())) return;
+  vector<int> tmp;
+  tmp.reserve(index.size());
+  for(size_t i=0;i<order.size();i++)
+    tmp.insert(tmp.end(),
+               index.begin()+faceStart[order[i]],
+               index.begin()+faceStart[order[i]+1]);
+  index.swap(tmp);
+}
+
+// true if an array of nValues values, indexed by an array of size
+// indexSize, has the size its binding requires
+static bool _hasBindingSize
+(const IndexedFaceSet::Binding binding,
+ const int nValues, const size_t indexSize,
+ const int nV, const size_t nF, const size_t nIndex) {
+  switch(binding) {
+  case IndexedFaceSet::PB_PER_VERTEX:       return nValues==nV;
+  case IndexedFaceSet::PB_PER_FACE:         return static_cast<size_t>(nValues)==nF;
+  case IndexedFaceSet::PB_PER_FACE_INDEXED: return indexSize==nF;
+  case IndexedFaceSet::PB_PER_CORNER:       return indexSize==nIndex;
+  default:                                  return true;
+  }
+}
+
+// true if coordIndex ends with the last face delimited by faceStart,
+// and the normal, color and texCoord arrays have the sizes required by
+// their bindings; otherwise a reordering of the vertices or the faces
+// would leave some of them bound to the wrong elements
+static bool _hasBindingSizes
+(IndexedFaceSet& ifs, const int nV, const vector<int>& coordIndex,
+ const vector<int>& faceStart) {
+  const size_t nIndex = coordIndex.size();
+  const size_t nF     = faceStart.size()-1;
+  return
+    nIndex==static_cast<size_t>(faceStart.back()) &&
+    _hasBindingSize(ifs.getNormalBinding(),ifs.getNumberOfNormal(),
+                    ifs.getNormalIndex().size(),nV,nF,nIndex) &&
+    _hasBindingSize(ifs.getColorBinding(),ifs.getNumberOfColor(),
+                    ifs.getColorIndex().size(),nV,nF,nIndex) &&
+    _hasBindingSize(ifs.getTexCoordBinding(),ifs.getNumberOfTexCoord(),
+                    ifs.getTexCoordIndex().size(),nV,nF,nIndex);
+}
+
+// reorders the faces of coordIndex, and of the normal, color and
+// texCoord arrays bound per face or per corner
+static void _permuteFaceArrays
+(IndexedFaceSet& ifs, vector<int>& coordIndex,
+ const vector<int>& faceStart, const vector<int>& order) {
+  IndexedFaceSet::Binding nBinding = ifs.getNormalBinding();
+  IndexedFaceSet::Binding cBinding = ifs.getColorBinding();
+  IndexedFaceSet::Binding tBinding = ifs.getTexCoordBinding();
+  _permuteFaces(coordIndex,faceStart,order);
+  if(nBinding==IndexedFaceSet::PB_PER_FACE) {
+    bool quantized = ifs.hasQuantizedNormal();
+    _permute(ifs.getNormal(),3,order);
+    if(quantized) ifs.quantizeNormal();
+  } else if(nBinding==IndexedFaceSet::PB_PER_FACE_INDEXED) {
+    _permute(ifs.getNormalIndex(),1,order);
+  } else if(nBinding==IndexedFaceSet::PB_PER_CORNER) {
+    _permuteFaces(ifs.getNormalIndex(),faceStart,order);
+  }
+  if(cBinding==IndexedFaceSet::PB_PER_FACE) {
+    bool quantized = ifs.hasQuantizedColor();
+    _permute(ifs.getColor(),3,order);
+    if(quantized) ifs.quantizeColor();
+  } else if(cBinding==IndexedFaceSet::PB_PER_FACE_INDEXED) {
+    _permute(ifs.getColorIndex(),1,order);
+  } else if(cBinding==IndexedFaceSet::PB_PER_CORNER) {
+    _permuteFaces(ifs.getColorIndex(),faceStart,order);
+  }
+  if(tBinding==IndexedFaceSet::PB_PER_CORNER)
+    _permuteFaces(ifs.getTexCoordIndex(),faceStart,order);
+}
+
+void SceneGraphProcessor::_vertexReorder(IndexedFaceSet& ifs) {
+  int nV = ifs.getNumberOfVertices();
+  if(nV<2) return;
+
+  IndexedFaceSet::Binding nBinding = ifs.getNormalBinding();
+  IndexedFaceSet::Binding cBinding = ifs.getColorBinding();
+  IndexedFaceSet::Binding tBinding = ifs.getTexCoordBinding();
+  bool triangles   = ifs.hasTriangleIndex();
+  vector<int>& coordIndex =
+    (triangles)?ifs.getTriangleIndex():ifs.getCoordIndex();
+
+  int i,iV,iF,nF;
+  for(i=0;i<(int)coordIndex.size();i++)
+    if(coordIndex[i]>=nV) return;
+
+  // the -1 separators do not move when the vertices are renumbered
+  vector<int> faceStart(1,0);
+  if(triangles) {
+    nF = static_cast<int>(coordIndex.size()/3);
+    for(iF=1;iF<=nF;iF++) faceStart.push_back(3*iF);
+  } else {
+    for(i=0;i<(int)coordIndex.size();i++)
+      if(coordIndex[i]<0) faceStart.push_back(i+1);
+    nF = static_cast<int>(faceStart.size())-1;
+  }
+  if(_hasBindingSizes(ifs,nV,coordIndex,faceStart)==false) return;
+
+  // the compact encodings are decoded, and encoded back at the end
+  bool qCoord  = ifs.hasQuantizedCoord();
+  bool qNormal = ifs.hasQuantizedNormal();
+  bool qColor  = ifs.hasQuantizedColor();
+  vector<float>& coord       = ifs.getCoord();
+  vector<float>& normal      = ifs.getNormal();
+  vector<float>& color       = ifs.getColor();
+  vector<float>& texCoord    = ifs.getTexCoord();
+
+  // vertices sorted by the Morton code of their position within the
+  // bounding box, quantized to 21 bits per axis
+  float xMin[3],xMax[3],scale[3];
+  int   j;
+  for(j=0;j<3;j++) xMin[j] = xMax[j] = coord[j];
+  for(iV=1;iV<nV;iV++)
+    for(j=0;j<3;j++) {
+      if(coord[3*iV+j]<xMin[j]) xMin[j] = coord[3*iV+j];
+      if(coord[3*iV+j]>xMax[j]) xMax[j] = coord[3*iV+j];
+    }
+  for(j=0;j<3;j++)
+    scale[j] = (xMax[j]>xMin[j])?2097151.0f/(xMax[j]-xMin[j]):0.0f;
+  vector< pair<unsigned long long,int> > key(nV);
+  for(iV=0;iV<nV;iV++) {
+    unsigned long long code = 0;
+    for(j=0;j<3;j++) {
+      float q = (coord[3*iV+j]-xMin[j])*scale[j];
+      q = (q<2097151.0f)?((q>0.0f)?q:0.0f):2097151.0f;
+      code |= _mortonSpread(static_cast<unsigned>(q))<<j;
+    }
+    key[iV] = make_pair(code,iV);
+  }
+  sort(key.begin(),key.end());
+  vector<int> vOrder(nV),vNew(nV);
+  for(iV=0;iV<nV;iV++) {
+    vOrder[iV] = key[iV].second;
+    vNew[key[iV].second] = iV;
+  }
+  vector< pair<unsigned long long,int> >().swap(key);
+
+  _permute(coord,3,vOrder);
+  if(nBinding==IndexedFaceSet::PB_PER_VERTEX) _permute(normal,3,vOrder);
+  if(cBinding==IndexedFaceSet::PB_PER_VERTEX) _permute(color,3,vOrder);
+  if(tBinding==IndexedFaceSet::PB_PER_VERTEX) _permute(texCoord,2,vOrder);
+  for(i=0;i<(int)coordIndex.size();i++)
+    if(coordIndex[i]>=0) coordIndex[i] = vNew[coordIndex[i]];
+
+  // faces sorted by their smallest vertex index
+  vector< pair<int,int> > fKey(nF);
+  for(iF=0;iF<nF;iF++) {
+    int iMin = nV;
+    for(i=faceStart[iF];i<faceStart[iF+1];i++)
+      if(coordIndex[i]>=0 && coordIndex[i]<iMin) iMin = coordIndex[i];
+    fKey[iF] = make_pair(iMin,iF);
+  }
+  sort(fKey.begin(),fKey.end());
+  vector<int> fOrder(nF);
+  for(iF=0;iF<nF;iF++) fOrder[iF] = fKey[iF].second;
+  vector< pair<int,int> >().swap(fKey);
+
+  _permuteFaceArrays(ifs,coordIndex,faceStart,fOrder);
+
+  if(qCoord)  ifs.quantizeCoord();
+  if(qNormal) ifs.quantizeNormal();
+  if(qColor)  ifs.quantizeColor();
+}
+
+void SceneGraphProcessor::_triangleReorder(IndexedFaceSet& ifs) {
+  bool triangles = ifs.hasTriangleIndex();
+  vector<int>  tmp;
+  vector<int>& coordIndex =
+    (triangles)?ifs.getTriangleIndex():ifs.getCoordIndex();
+  if(triangles==false &&
+     TriangleMesh::fromCoordIndex(coordIndex,tmp)==false)
+    return;
+  int stride = (triangles)?3:4;
+  int nF     = static_cast<int>(((triangles)?coordIndex:tmp).size()/3);
+  vector<int> faceStart(nF+1);
+  for(int iF=0;iF<=nF;iF++) faceStart[iF] = stride*iF;
+  int nV = ifs.getNumberOfVertices();
+  if(_hasBindingSizes(ifs,nV,coordIndex,faceStart)==false) return;
+  vector<int> fOrder;
+  TriangleMesh mesh(nV,(triangles)?coordIndex:tmp);
+  mesh.getVertexCacheOrder(fOrder);
+  _permuteFaceArrays(ifs,coordIndex,faceStart,fOrder);
+}
+
+// numbers the values in [0:n) used by index in increasing order, in
+// newIndex, with -1 for the unused ones, and renumbers index; returns
+// the number of values used, or -1, leaving index unchanged, if it has
+// values out of range
+static int _compactIndex
+(vector<int>& index, const int n, vector<int>& newIndex) {
+  for(const int i : index)
+    if(i>=n) return -1;
+  newIndex.assign(n,-1);
+  for(const int i : index)
+    if(i>=0) newIndex[i] = 0;
+  int nUsed = 0;
+  for(int k=0;k<n;k++)
+    if(newIndex[k]==0) newIndex[k] = nUsed++;
+  for(int& i : index)
+    if(i>=0) i = newIndex[i];
+  return nUsed;
+}
+
+// moves the elements kept by _compactIndex() to their new positions;
+// since newIndex[k]<=k this can be done in place
+template<class T>
+static void _compact
+(vector<T>& value, const size_t dim, const vector<int>& newIndex,
+ const int nUsed) {
+  if(nUsed<0 || value.size()!=dim*newIndex.size()) return;
+  for(size_t k=0;k<newIndex.size();k++)
+    if(newIndex[k]>=0)
+      for(size_t j=0;j<dim;j++)
+        value[dim*newIndex[k]+j] = value[dim*k+j];
+  value.resize(dim*nUsed);
+}
+
+void SceneGraphProcessor::_removeUnusedVertices(IndexedFaceSet& ifs) {
+  bool triangles = ifs.hasTriangleIndex();
+  vector<int>& coordIndex =
+    (triangles)?ifs.getTriangleIndex():ifs.getCoordIndex();
+  if(coordIndex.size()==0) return;
+
+  IndexedFaceSet::Binding nBinding = ifs.getNormalBinding();
+  IndexedFaceSet::Binding cBinding = ifs.getColorBinding();
+  IndexedFaceSet::Binding tBinding = ifs.getTexCoordBinding();
+
+  // the compact encodings are decoded, and encoded back at the end
+  bool qCoord  = ifs.hasQuantizedCoord();
+  bool qNormal = ifs.hasQuantizedNormal();
+  bool qColor  = ifs.hasQuantizedColor();
+  vector<float>& coord         = ifs.getCoord();
+  vector<float>& normal        = ifs.getNormal();
+  vector<int>&   normalIndex   = ifs.getNormalIndex();
+  vector<float>& color         = ifs.getColor();
+  vector<int>&   colorIndex    = ifs.getColorIndex();
+  vector<float>& texCoord      = ifs.getTexCoord();
+  vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
+
+  vector<int> newIndex;
+  int nV    = static_cast<int>(coord.size()/3);
+  int nUsed = _compactIndex(coordIndex,nV,newIndex);
+  if(nUsed>=0 && nUsed<nV) {
+    _compact(coord,3,newIndex,nUsed);
+    if(nBinding==IndexedFaceSet::PB_PER_VERTEX)
+      _compact(normal,3,newIndex,nUsed);
+    if(cBinding==IndexedFaceSet::PB_PER_VERTEX)
+      _compact(color,3,newIndex,nUsed);
+    if(tBinding==IndexedFaceSet::PB_PER_VERTEX)
+      _compact(texCoord,2,newIndex,nUsed);
+  }
+
+  // properties accessed through their own index arrays
+  if(nBinding==IndexedFaceSet::PB_PER_FACE_INDEXED ||
+     nBinding==IndexedFaceSet::PB_PER_CORNER) {
+    nUsed = _compactIndex
+      (normalIndex,static_cast<int>(normal.size()/3),newIndex);
+    _compact(normal,3,newIndex,nUsed);
+  }
+  if(cBinding==IndexedFaceSet::PB_PER_FACE_INDEXED ||
+     cBinding==IndexedFaceSet::PB_PER_CORNER) {
+    nUsed = _compactIndex
+      (colorIndex,static_cast<int>(color.size()/3),newIndex);
+    _compact(color,3,newIndex,nUsed);
+  }
+  if(tBinding==IndexedFaceSet::PB_PER_CORNER) {
+    nUsed = _compactIndex
+      (texCoordIndex,static_cast<int>(texCoord.size()/2),newIndex);
+    _compact(texCoord,2,newIndex,nUsed);
+  }
+
+  coord.shrink_to_fit();
+  coordIndex.shrink_to_fit();
+  normal.shrink_to_fit();
+  normalIndex.shrink_to_fit();
+  color.shrink_to_fit();
+  colorIndex.shrink_to_fit();
+  texCoord.shrink_to_fit();
+  texCoordIndex.shrink_to_fit();
+
+  if(qCoord)  ifs.quantizeCoord();
+  if(qNormal) ifs.quantizeNormal();
+  if(qColor)  ifs.quantizeColor();
+}
+
 void SceneGraphProcessor::_normalInvert(IndexedFaceSet& ifs) {
   vector<float>& normal = ifs.getNormal();
   for(int i=0;i<(int)normal.size();i++)
@@ -100,7 +546,7 @@ void SceneGraphProcessor::_normalInvert(IndexedFaceSet& ifs) {
 }
 
 void SceneGraphProcessor::_computeFaceNormal
-(vector<float>& coord, vector<int>& coordIndex,
+(const vector<float>& coord, const vector<int>& coordIndex,
  int i0, int i1, Vec3f& n, bool normalize) {
   int niF,iV,i;
   Vec3f p,pi,ni,v1,v2;
@@ -187,15 +633,67 @@ void SceneGraphProcessor::_computeFaceNormal
   }
 }
 
+void SceneGraphProcessor::_computeFaceNormals
+(const vector<float>& coord, const vector<int>& coordIndex,
+ vector<float>& faceNormal) {
+  const int nC = (int)coordIndex.size();
+  int nF,iF,i,i0,i1;
+  for(nF=i=0;i<nC;i++)
+    if(coordIndex[i]<0) nF++;
+  faceNormal.resize(3*(size_t)nF);
+  bool isTriangleMesh = (nC==4*nF);
+  for(iF=0;isTriangleMesh && iF<nF;iF++)
+    isTriangleMesh = (coordIndex[4*iF+3]<0);
+  if(isTriangleMesh) {
+    TriangleNormals::compute(coord.data(),coordIndex.data(),4,nF,
+                             faceNormal.data(),true);
+  } else {
+    Vec3f n;
+    for(iF=i0=i1=0;i1<nC;i1++) {
+      if(coordIndex[i1]<0) {
+        _computeFaceNormal(coord,coordIndex,i0,i1,n,true);
+        faceNormal[3*(size_t)iF  ] = n[0];
+        faceNormal[3*(size_t)iF+1] = n[1];
+        faceNormal[3*(size_t)iF+2] = n[2];
+        i0=i1+1; iF++;
+      }
+    }
+  }
+}
+
+bool SceneGraphProcessor::_isSmoothEdge
+(const HalfEdges& mesh, const int iE,
+ const vector<float>& faceNormal, const float cosCreaseAngle) {
+  if(mesh.getNumberOfEdgeHalfEdges(iE)!=2) return false;
+  const int iC0 = mesh.getEdgeHalfEdge(iE,0);
+  const int iC1 = mesh.getEdgeHalfEdge(iE,1);
+  if(mesh.getSrc(iC1)!=mesh.getDst(iC0)) return false; // opposite orientation
+  const float* n0 = &faceNormal[3*(size_t)mesh.getFace(iC0)];
+  const float* n1 = &faceNormal[3*(size_t)mesh.getFace(iC1)];
+  return (n0[0]*n1[0]+n0[1]*n1[1]+n0[2]*n1[2]>cosCreaseAngle);
+}
+
 void SceneGraphProcessor::_computeNormalPerFace(IndexedFaceSet& ifs) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_FACE) return;
   vector<float>& coord       = ifs.getCoord();
-  vector<int>&   coordIndex  = ifs.getCoordIndex();
   vector<float>& normal      = ifs.getNormal();
   vector<int>&   normalIndex = ifs.getNormalIndex();
   ifs.setNormalPerVertex(false);
   normal.clear();
   normalIndex.clear();
+  if(ifs.isTriangleMesh()) {
+    // the faces are read from triangleIndex if present, without
+    // expanding it back into coordIndex
+    const int nT = ifs.getNumberOfFaces();
+    const bool hasTriangleIndex = ifs.hasTriangleIndex();
+    vector<int>& index =
+      (hasTriangleIndex)?ifs.getTriangleIndex():ifs.getCoordIndex();
+    normal.resize(3*(size_t)nT);
+    TriangleNormals::compute(coord.data(),index.data(),
+                             (hasTriangleIndex)?3:4,nT,normal.data(),true);
+    return;
+  }
+  vector<int>&   coordIndex  = ifs.getCoordIndex();
   Vec3f n;
   int /*iF,*/ i0,i1;
   for(i0=i1=0;i1<(int)coordIndex.size();i1++) {
@@ -256,6 +754,108 @@ void SceneGraphProcessor::_computeNormalPerVertex(IndexedFaceSet& ifs) {
   }
 }
 
+// The face normals are computed first, each face independently of the
+// others; then each vertex adds up the normals of its incident faces,
+// listed in a vertex-to-face table in increasing face order, so that
+// no two threads write to the same vertex, and the sums are computed
+// in the same order for any number of threads, and as in the serial
+// version above.
+void SceneGraphProcessor::_computeNormalPerVertex
+(IndexedFaceSet& ifs, ThreadPool& pool) {
+  if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_VERTEX) return;
+  vector<float>& coord       = ifs.getCoord();
+  vector<int>&   coordIndex  = ifs.getCoordIndex();
+  vector<float>& normal      = ifs.getNormal();
+  vector<int>&   normalIndex = ifs.getNormalIndex();
+  ifs.setNormalPerVertex(true);
+  normal.clear();
+  normalIndex.clear();
+  const int grain = 1<<14;
+  int nV,nF,iF,i,iV;
+  nV = (int)(coord.size()/3);
+
+  // faceStart[iF] is the index into coordIndex of the first corner of
+  // face iF, and faceStart[iF+1]-1 the index of its terminating -1;
+  // the number of corners of each vertex is counted in vertexFirst
+  vector<int> faceStart;
+  vector<int> vertexFirst(nV+1,0);
+  faceStart.push_back(0);
+  for(i=0;i<(int)coordIndex.size();i++)
+    if((iV=coordIndex[i])<0) faceStart.push_back(i+1);
+    else                     vertexFirst[iV]++;
+  nF = (int)faceStart.size()-1;
+  // corners after the last -1 do not belong to any face
+  for(i=faceStart[nF];i<(int)coordIndex.size();i++)
+    vertexFirst[coordIndex[i]]--;
+
+  vector<float> faceNormal(3*(size_t)nF);
+  const bool isTriangleMesh = ifs.isTriangleMesh();
+  auto computeFaceNormals = [&](int iF0, int iF1) {
+    if(isTriangleMesh) {
+      TriangleNormals::compute(coord.data(),coordIndex.data()+4*(size_t)iF0,4,
+                               iF1-iF0,faceNormal.data()+3*(size_t)iF0,false);
+      return;
+    }
+    Vec3f n;
+    for(int iF=iF0;iF<iF1;iF++) {
+      _computeFaceNormal(coord,coordIndex,faceStart[iF],faceStart[iF+1]-1,
+                         n,false);
+      faceNormal[3*(size_t)iF  ] = n[0];
+      faceNormal[3*(size_t)iF+1] = n[1];
+      faceNormal[3*(size_t)iF+2] = n[2];
+    }
+  };
+  pool.runRange(nF,grain,computeFaceNormals);
+
+  // the faces incident to vertex iV are
+  // vertexFace[vertexFirst[iV]:vertexFirst[iV+1])
+  int nVF = 0;
+  for(iV=0;iV<nV;iV++) {
+    int n = vertexFirst[iV]; vertexFirst[iV] = nVF; nVF += n;
+  }
+  vertexFirst[nV] = nVF;
+  vector<int> vertexFace(nVF);
+  for(iF=i=0;iF<nF;i++)
+    if((iV=coordIndex[i])<0) iF++;
+    else                     vertexFace[vertexFirst[iV]++] = iF;
+  // vertexFirst[iV] now points to the start of the list of iV+1
+  for(iV=nV;iV>0;iV--)
+    vertexFirst[iV] = vertexFirst[iV-1];
+  vertexFirst[0] = 0;
+  vector<int>().swap(faceStart);
+
+  normal.resize(coord.size());
+  auto accumulateVertexNormals = [&](int iV0, int iV1) {
+    Vec3f n;
+    for(int iV=iV0;iV<iV1;iV++) {
+      n[0] = n[1] = n[2] = 0.0f;
+      for(int k=vertexFirst[iV];k<vertexFirst[iV+1];k++) {
+        const size_t j = 3*(size_t)vertexFace[k];
+        n[0] += faceNormal[j  ];
+        n[1] += faceNormal[j+1];
+        n[2] += faceNormal[j+2];
+      }
+      float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
+      if(nn>0.0f) {
+        nn = (float)sqrt(nn);
+        n[0] /= nn; n[1] /= nn; n[2] /= nn;
+      }
+      normal[3*(size_t)iV  ] = n[0];
+      normal[3*(size_t)iV+1] = n[1];
+      normal[3*(size_t)iV+2] = n[2];
+    }
+  };
+  pool.runRange(nV,grain,accumulateVertexNormals);
+}
+
+// The corners incident to each vertex are grouped into smooth fans:
+// two corners of the same vertex in adjacent faces belong to the same
+// fan if the faces share a regular edge, are consistently oriented,
+// and their normals form an angle smaller than the crease angle. The
+// normal of each fan is the average of the normals of its faces,
+// weighted by the angles of its corners. Corners which are alone in
+// their fan share the normal of their face, so a creaseAngle of 0
+// produces one normal per face.
 void SceneGraphProcessor::_computeNormalPerCorner(IndexedFaceSet& ifs) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_CORNER) return;
 
@@ -267,75 +867,111 @@ void SceneGraphProcessor::_computeNormalPerCorner(IndexedFaceSet& ifs) {
   normal.clear();
   normalIndex.clear();
 
-  Vec3f pP,p0,pN,vP,vN,n;
-  int iF,i,i0,i1,ip,in,nFC,iN,iVp/*,iV0,iVn*/;
-  for(iF=i0=i1=0;i1<(int)coordIndex.size();i1++) {
-    if(coordIndex[i1]<0) {
-      nFC = i1-i0; // number of face corners
-      // n << 0,0,0;
-      n[0]=n[1]=n[2]=0.0f;
-      if(nFC>=3) { // polygon
-        for(i=i0;i<i1;i++) {
-          if((ip=i-1)< i0) ip=i1-1;
-          if((in=i+1)==i1) in=i0  ;
-
-          iVp = coordIndex[ip];
-          // iV0 = coordIndex[i ];
-          // iVn = coordIndex[in];
-
-          // pP << coord[3*iVp  ],coord[3*iVp+1],coord[3*iVp+2];
-          pP[0] = coord[3*iVp  ]; pP[1] = coord[3*iVp+1]; pP[2] = coord[3*iVp+2];
-          // p0 << coord[3*iVp  ],coord[3*iVp+1],coord[3*iVp+2];
-          p0[0] = coord[3*iVp  ]; p0[1] = coord[3*iVp+1]; p0[2] = coord[3*iVp+2];
-          // pN << coord[3*iVp  ],coord[3*iVp+1],coord[3*iVp+2];
-          pN[0] = coord[3*iVp  ]; pN[1] = coord[3*iVp+1]; pN[2] = coord[3*iVp+2];
-          // vP = pP-p0;
-          vP[0] = pP[0]-p0[0]; vP[1] = pP[1]-p0[1]; vP[2] = pP[2]-p0[2];
-          // vN = pN-p0;
-          vN[0] = pN[0]-p0[0]; vN[1] = pN[1]-p0[1]; vN[2] = pN[2]-p0[2];
-
-          // n = vN.cross(vP);
-          n[0] = vN[1]*vP[2]-vN[2]*vP[1];
-          n[1] = vN[2]*vP[0]-vN[0]*vP[2];
-          n[2] = vN[0]*vP[1]-vN[1]*vP[0];
-
-          // n.normalize();
-          float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
-          if(nn>0.0f) {
-            nn = (float)sqrt(nn);
-            n[0] /= nn; n[1] /= nn; n[2] /= nn;
-          }
+  const int nV = ifs.getNumberOfCoord();
+  int nC = (int)coordIndex.size();
+  // corners after the last -1 do not belong to any face
+  while(nC>0 && coordIndex[nC-1]>=0) nC--;
+  const vector<int> coordIndexTail(coordIndex.begin()+nC,coordIndex.end());
+  if(coordIndexTail.size()>0) coordIndex.resize(nC);
+
+  HalfEdges* mesh = (HalfEdges*)0;
+  try {
+    mesh = new HalfEdges(nV,coordIndex);
+  } catch(StrException* e) { // vertex index out of range
+    delete e;
+  }
+  if(mesh==(HalfEdges*)0) {
+    coordIndex.insert(coordIndex.end(),
+                      coordIndexTail.begin(),coordIndexTail.end());
+    return;
+  }
 
-          iN = (int)(normal.size()/3);
-          normal.push_back(n[0]);
-          normal.push_back(n[1]);
-          normal.push_back(n[2]);
-          normalIndex.push_back(iN);
+  int nF,iF,i,i0,i1,iE,iC0,iC1;
+
+  vector<float> faceNormal;
+  _computeFaceNormals(coord,coordIndex,faceNormal);
+  nF = (int)(faceNormal.size()/3);
+
+  // join the corners across the smooth edges
+  const float cosCreaseAngle = (float)cos(ifs.getCreaseangle());
+  Partition fan(nC);
+  for(iE=0;iE<mesh->getNumberOfEdges();iE++) {
+    if(_isSmoothEdge(*mesh,iE,faceNormal,cosCreaseAngle)) {
+      iC0 = mesh->getEdgeHalfEdge(iE,0);
+      iC1 = mesh->getEdgeHalfEdge(iE,1);
+      fan.join(mesh->getNext(iC0),iC1);
+      fan.join(mesh->getNext(iC1),iC0);
+    }
+  }
+  delete mesh;
+
+  // accumulate the angle weighted face normals on the fan roots
+  vector<float> fanNormal(3*(size_t)nC,0.0f);
+  float vP[3],vN[3],c[3],angle;
+  const float *pP,*p0,*pN,*nFace;
+  int ip,in,iR;
+  for(iF=i0=i1=0;i1<nC;i1++) {
+    if(coordIndex[i1]<0) {
+      nFace = &faceNormal[3*(size_t)iF];
+      for(i=i0;i<i1;i++) {
+        if((ip=i-1)< i0) ip=i1-1;
+        if((in=i+1)==i1) in=i0  ;
+        pP = &coord[3*(size_t)coordIndex[ip]];
+        p0 = &coord[3*(size_t)coordIndex[i ]];
+        pN = &coord[3*(size_t)coordIndex[in]];
+        vP[0] = pP[0]-p0[0]; vP[1] = pP[1]-p0[1]; vP[2] = pP[2]-p0[2];
+        vN[0] = pN[0]-p0[0]; vN[1] = pN[1]-p0[1]; vN[2] = pN[2]-p0[2];
+        // c = vN.cross(vP);
+        c[0] = vN[1]*vP[2]-vN[2]*vP[1];
+        c[1] = vN[2]*vP[0]-vN[0]*vP[2];
+        c[2] = vN[0]*vP[1]-vN[1]*vP[0];
+        angle = atan2f(sqrtf(c[0]*c[0]+c[1]*c[1]+c[2]*c[2]),
+                       vN[0]*vP[0]+vN[1]*vP[1]+vN[2]*vP[2]);
+        iR = fan.find(i);
+        fanNormal[3*(size_t)iR  ] += angle*nFace[0];
+        fanNormal[3*(size_t)iR+1] += angle*nFace[1];
+        fanNormal[3*(size_t)iR+2] += angle*nFace[2];
+      }
+      i0=i1+1; iF++;
+    }
+  }
 
+  // one normal per fan, or per face for corners alone in their fan
+  vector<int> fanNormalIndex(nC,-1);
+  vector<int> faceNormalIndex(nF,-1);
+  float* nR;
+  for(iF=i=0;i<nC;i++) {
+    if(coordIndex[i]<0) {
+      normalIndex.push_back(-1);
+      iF++;
+    } else if(fan.getSize(iR=fan.find(i))==1) {
+      if(faceNormalIndex[iF]<0) {
+        faceNormalIndex[iF] = (int)(normal.size()/3);
+        normal.insert(normal.end(),&faceNormal[3*(size_t)iF],
+                      &faceNormal[3*(size_t)iF]+3);
+      }
+      normalIndex.push_back(faceNormalIndex[iF]);
+    } else {
+      if(fanNormalIndex[iR]<0) {
+        fanNormalIndex[iR] = (int)(normal.size()/3);
+        nR = &fanNormal[3*(size_t)iR];
+        float nn = nR[0]*nR[0]+nR[1]*nR[1]+nR[2]*nR[2];
+        if(nn>0.0f) {
+          nn = (float)sqrt(nn);
+          nR[0] /= nn; nR[1] /= nn; nR[2] /= nn;
         }
-        normalIndex.push_back(-1);
-
-      } else /* if(nFC<3) */{ // face with less than 3 vertices
-        // throw exception ?
-        // n << 0,0,0;
-        n[0]=n[1]=n[2]=0.0f;
-        for(i=i0;i<i1;i++) {
-          iN = (int)(normal.size()/3);
-          normal.push_back(n[0]);
-          normal.push_back(n[1]);
-          normal.push_back(n[2]);
-          normalIndex.push_back(iN);
-        }
-        normalIndex.push_back(-1);
+        normal.insert(normal.end(),nR,nR+3);
       }
-
-      i0=i1+1; iF++;
+      normalIndex.push_back(fanNormalIndex[iR]);
     }
   }
+
+  coordIndex.insert(coordIndex.end(),
+                    coordIndexTail.begin(),coordIndexTail.end());
 }
 
 void SceneGraphProcessor::bboxAdd
-(int depth, float scale, bool isCube) {
+(int depth, float scale, bool isCube, bool isOccupied) {
   const string name = "BOUNDING-BOX";
   Shape* shape = (Shape*)0;
   const Node*  node = _wrl.getChild(name);
@@ -393,7 +1029,12 @@ void SceneGraphProcessor::bboxAdd
   float x0 = center.x-dx; float y0 = center.y-dy; float z0 = center.z-dz;
   float x1 = center.x+dx; float y1 = center.y+dy; float z1 = center.z+dz;
 
-  if(depth==0) {
+  if(isOccupied) {
+
+    const float box[6] = { x0,y0,z0,x1,y1,z1 };
+    _bboxAddOccupied(depth,box,coord,coordIndex);
+
+  } else if(depth==0) {
     
     // vertices
     coord.push_back(x0); coord.push_back(y0); coord.push_back(z0);
@@ -478,6 +1119,166 @@ void SceneGraphProcessor::bboxAdd
   }
 }
 
+// sorts the keys, and removes the repeated ones; the ranges of each
+// thread are sorted in parallel, and then merged in pairs
+static void _sortUnique(vector<unsigned long long>& key, ThreadPool& pool) {
+  const int nRanges = pool.getNumberOfThreads();
+  if(nRanges<=1 || key.size()<((size_t)1<<16)) {
+    sort(key.begin(),key.end());
+  } else {
+    vector<size_t> first(nRanges+1);
+    for(int i=0;i<=nRanges;i++)
+      first[i] = (key.size()*i)/nRanges;
+    pool.run(nRanges,[&key,&first](int i) {
+        sort(key.begin()+first[i],key.begin()+first[i+1]);
+      });
+    for(int step=1;step<nRanges;step*=2) {
+      pool.run((nRanges+2*step-1)/(2*step),[&key,&first,nRanges,step](int j) {
+          const int i0 = 2*step*j;
+          const int i1 = min(i0+step,nRanges);
+          const int i2 = min(i0+2*step,nRanges);
+          inplace_merge(key.begin()+first[i0],key.begin()+first[i1],
+                        key.begin()+first[i2]);
+        });
+    }
+  }
+  key.erase(unique(key.begin(),key.end()),key.end());
+}
+
+// The vertices of every IndexedFaceSet, mapped to SceneGraph
+// coordinates by the Transform nodes above it, are labeled with the
+// Morton code of the cell of the 2^depth lattice containing them; once
+// sorted, the distinct codes are the occupied cells of the finest
+// level, and shifting them 3 bits to the right gives the occupied
+// cells of the level above. Each occupied cell of each level
+// contributes its 12 edges, and the edges shared by neighbouring cells
+// of the same level are emitted once. The work is O(V log V) for V
+// vertices, and the sorts and the loops run on the thread pool.
+void SceneGraphProcessor::_bboxAddOccupied
+(int depth, const float box[6],
+ vector<float>& coord, vector<int>& coordIndex) {
+  // the edge keys hold 11 bits per coordinate
+  if(depth<0) depth = 0; else if(depth>10) depth = 10;
+  ThreadPool& pool = _getThreadPool();
+  const int grain = 1<<14;
+  const int N = 1<<depth;
+  const unsigned long long outside = ~0ULL;
+  float scale[3];
+  for(int j=0;j<3;j++)
+    scale[j] = (box[j+3]>box[j])?((float)N)/(box[j+3]-box[j]):0.0f;
+
+  // finest cells containing the vertices, in SceneGraph coordinates
+  vector<unsigned long long> cell;
+  vector<float> buffer;
+  SceneGraphTraversal traversal(_wrl);
+  const float* M;
+  int nodeDepth;
+  Node* node;
+  while((node=traversal.next(M,nodeDepth))!=(Node*)0) {
+    if(node->isShape()==false) continue;
+    node = ((Shape*)node)->getGeometry();
+    if(node==(Node*)0 || node->isIndexedFaceSet()==false) continue;
+    IndexedFaceSet* ifs = (IndexedFaceSet*)node;
+    const vector<float>& coordIfs = ifs->readCoord(buffer);
+    const size_t offset = cell.size();
+    const int nV = (int)(coordIfs.size()/3);
+    cell.resize(offset+nV);
+    pool.runRange(nV,grain,[&](int iV0, int iV1) {
+        for(int iV=iV0;iV<iV1;iV++) {
+          const float* p = &coordIfs[3*(size_t)iV];
+          unsigned long long code = 0;
+          for(int j=0;j<3;j++) {
+            const float x = M[4*j]*p[0]+M[4*j+1]*p[1]+M[4*j+2]*p[2]+M[4*j+3];
+            if(!(box[j]<=x && x<=box[j+3])) { code = outside; break; }
+            int q = (int)((x-box[j])*scale[j]);
+            if(q>=N) q = N-1;
+            code |= _mortonSpread((unsigned)q)<<j;
+          }
+          cell[offset+iV] = code;
+        }
+      });
+  }
+  _sortUnique(cell,pool);
+  if(cell.size()>0 && cell.back()==outside) cell.pop_back();
+
+  // edges of the occupied cells, as keys (level,axis,z,y,x), where
+  // (x,y,z) is the first end of the edge in the lattice of the level
+  vector<unsigned long long> edge;
+  size_t i,n;
+  for(int level=depth;level>=0;level--) {
+    if(level<depth) {
+      for(i=n=0;i<cell.size();i++)
+        if(n==0 || cell[n-1]!=(cell[i]>>3))
+          cell[n++] = cell[i]>>3;
+      cell.resize(n);
+    }
+    const size_t offset = edge.size();
+    edge.resize(offset+12*cell.size());
+    pool.runRange((int)cell.size(),grain,[&,level,offset](int i0, int i1) {
+        unsigned p[3],q[3];
+        for(int i=i0;i<i1;i++) {
+          unsigned long long* e = &edge[offset+12*(size_t)i];
+          for(int j=0;j<3;j++) p[j] = _mortonCompact(cell[i]>>j);
+          for(int a=0;a<3;a++) {
+            const int b = (a+1)%3;
+            const int c = (a+2)%3;
+            for(int k=0;k<4;k++) {
+              q[a] = p[a]; q[b] = p[b]+(k&1); q[c] = p[c]+(k>>1);
+              *e++ = (((unsigned long long)(3*level+a))<<33)|
+                (((unsigned long long)q[2])<<22)|
+                (((unsigned long long)q[1])<<11)|q[0];
+            }
+          }
+        }
+      });
+  }
+  vector<unsigned long long>().swap(cell);
+  _sortUnique(edge,pool);
+
+  // lattice points at the ends of the edges, as keys x+(N+1)*(y+(N+1)*z)
+  const int nE = (int)edge.size();
+  const unsigned long long N1 = N+1;
+  auto getEnds = [&edge,depth,N1](int iE, unsigned long long end[2]) {
+    const unsigned long long e = edge[iE];
+    const int level = (int)(e>>33)/3;
+    const int a     = (int)(e>>33)%3;
+    const unsigned long long s = 1ULL<<(depth-level);
+    unsigned long long q[3] = { (e&0x7ff)*s, ((e>>11)&0x7ff)*s, ((e>>22)&0x7ff)*s };
+    end[0] = q[0]+N1*(q[1]+N1*q[2]);
+    q[a] += s;
+    end[1] = q[0]+N1*(q[1]+N1*q[2]);
+  };
+  vector<unsigned long long> vertex(2*(size_t)nE);
+  pool.runRange(nE,grain,[&](int iE0, int iE1) {
+      for(int iE=iE0;iE<iE1;iE++) getEnds(iE,&vertex[2*(size_t)iE]);
+    });
+  _sortUnique(vertex,pool);
+
+  const int nV = (int)vertex.size();
+  coord.resize(3*(size_t)nV);
+  pool.runRange(nV,grain,[&](int iV0, int iV1) {
+      for(int iV=iV0;iV<iV1;iV++) {
+        unsigned long long v = vertex[iV];
+        for(int j=0;j<3;j++,v/=N1) {
+          const int ix = (int)(v%N1);
+          coord[3*(size_t)iV+j] =
+            (((float)(N-ix))*box[j]+((float)ix)*box[j+3])/((float)N);
+        }
+      }
+    });
+  coordIndex.resize(3*(size_t)nE);
+  pool.runRange(nE,grain,[&](int iE0, int iE1) {
+      unsigned long long end[2];
+      for(int iE=iE0;iE<iE1;iE++) {
+        getEnds(iE,end);
+        for(int k=0;k<2;k++)
+          coordIndex[3*(size_t)iE+k] = (int)
+            (lower_bound(vertex.begin(),vertex.end(),end[k])-vertex.begin());
+        coordIndex[3*(size_t)iE+2] = -1;
+      }
+    });
+}
+
 void SceneGraphProcessor::bboxRemove() {
   vector<pNode>& children = _wrl.getChildren();
   vector<pNode>::iterator i;
@@ -485,118 +1286,211 @@ void SceneGraphProcessor::bboxRemove() {
     if((*i)->nameEquals("BOUNDING-BOX"))
       break;
   if(i!=children.end())
-    children.erase(i);
+    _wrl.removeChild(*i);
+}
+
+// new Shape named EDGES, with an empty IndexedLineSet as geometry
+static Shape* _newEdgesShape() {
+  Shape* shape = new Shape();
+  shape->setName("EDGES");
+  Appearance* appearance = new Appearance();
+  shape->setAppearance(appearance);
+  Material* material = new Material();
+  // colors should be stored in WrlViewerData
+  Color edgeColor(1.0f,0.5f,0.0f);
+  material->setDiffuseColor(edgeColor);
+  appearance->setMaterial(material);
+  shape->setGeometry(new IndexedLineSet());
+  return shape;
 }
 
-void SceneGraphProcessor::edgesAdd() {
+// The IndexedFaceSets in the same Group share the EDGES Shape of the
+// Group. The traversal reaches a Shape, or a Group, once per path
+// from the root; the edges of each Shape are computed once:
+// - a Group shared with DEF/USE gets a single EDGES Shape, which is
+//   drawn under every instance of the Group;
+// - a Shape held by several Groups gets an EDGES Shape of its own,
+//   shared by those Groups, so that each instance draws its edges.
+void SceneGraphProcessor::edgesAdd(const int selection) {
+  // the EDGES Shapes are built again from scratch
+  edgesRemove();
+
+  // the Groups in the order in which the traversal first reaches them
+  vector<Group*> path(1,&_wrl);
   SceneGraphTraversal traversal(_wrl);
   traversal.start();
-  const Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape  = (Shape*)node;
-      const Node* parent = shape->getParent();
-      Group* group = (Group*)parent;
+  Node* node;
+  while((node=traversal.next())!=(Node*)0)
+    if(node->isGroup()) path.push_back((Group*)node);
+  vector<Group*> sorted(path);
+  sort(sorted.begin(),sorted.end());
+  sorted.erase(unique(sorted.begin(),sorted.end()),sorted.end());
+  vector<Group*> groups;
+  vector<bool>   reached(sorted.size(),false);
+  for(Group* group : path) {
+    size_t k = lower_bound(sorted.begin(),sorted.end(),group)-sorted.begin();
+    if(reached[k]) continue;
+    reached[k] = true;
+    groups.push_back(group);
+  }
 
+  // the Groups holding each Shape with an IndexedFaceSet
+  vector< pair<Shape*,Group*> > parent;
+  for(Group* group : groups)
+    for(int i=0;i<group->getNumberOfChildren();i++) {
+      node = (*group)[i];
+      if(node->isShape()==false) continue;
+      Shape* shape = (Shape*)node;
       node = shape->getGeometry();
-      if(node!=(Node*)0 && node->isIndexedFaceSet()) {
-        IndexedFaceSet* ifs = (IndexedFaceSet*)node;
-
-        shape->setShow(false);
-
-        // compose the node name ???
-        string name = "EDGES";
-        node = group->getChild(name);
-        if(node==(Node*)0) {
-          shape = new Shape();
-          shape->setName(name);
-          Appearance* appearance = new Appearance();
-          shape->setAppearance(appearance);
-          Material* material = new Material();
-          // colors should be stored in WrlViewerData
-          Color edgeColor(1.0f,0.5f,0.0f);
-          material->setDiffuseColor(edgeColor);
-          appearance->setMaterial(material);
-          group->addChild(shape);
-        } else if(node->isShape()) {
-          shape = (Shape*)node;
-        } else /* if(node!=(Node*)0 && node->isShape()==false */ {
-          // throw exception ???
-        }
-        if(shape==(Shape*)0) { /* throw exception ??? */ return; }
-
-        IndexedLineSet* ils = (IndexedLineSet*)0;
-        node = shape->getGeometry();
-        if(node==(Node*)0) {
-          ils = new IndexedLineSet();
-          shape->setGeometry(ils);
-        } else if(node->isIndexedLineSet()) {
-          ils = (IndexedLineSet*)node;
-        } else /* if(node!=(Node*)0 && node->isIndexedLineSet()==false) */ {
-          // throw exception ???
+      if(node!=(Node*)0 && node->isIndexedFaceSet())
+        parent.push_back(make_pair(shape,group));
+    }
+  sort(parent.begin(),parent.end());
+  parent.erase(unique(parent.begin(),parent.end()),parent.end());
+
+  vector<bool> done(parent.size(),false);
+  for(Group* group : groups) {
+    IndexedLineSet* ils = (IndexedLineSet*)0;
+    for(int i=0;i<group->getNumberOfChildren();i++) {
+      node = (*group)[i];
+      if(node->isShape()==false || node->nameEquals("EDGES")) continue;
+      Shape* shape = (Shape*)node;
+      node = shape->getGeometry();
+      if(node==(Node*)0 || node->isIndexedFaceSet()==false) continue;
+      IndexedFaceSet* ifs = (IndexedFaceSet*)node;
+
+      size_t k0 = lower_bound(parent.begin(),parent.end(),
+                              make_pair(shape,(Group*)0))-parent.begin();
+      if(done[k0]) continue;
+      done[k0] = true;
+      size_t k1 = k0+1;
+      while(k1<parent.size() && parent[k1].first==shape) k1++;
+
+      shape->setShow(false);
+
+      if(k1-k0==1) {
+        if(ils==(IndexedLineSet*)0) {
+          Shape* edges = _newEdgesShape();
+          group->addChild(edges);
+          ils = (IndexedLineSet*)edges->getGeometry();
         }
-        
-        if(ils==(IndexedLineSet*)0) { /* throw exception ??? */ return; }
-
-        ils->clear();
-
-        vector<float>& coordIfs      = ifs->getCoord();
-        vector<int>&   coordIndexIfs = ifs->getCoordIndex();
-
-        vector<float>& coordIls      = ils->getCoord();
-        vector<int>&   coordIndexIls = ils->getCoordIndex();
-
-        coordIls.insert(coordIls.end(),
-                        coordIfs.begin(),coordIfs.end());
+        _edgesAdd(*ifs,*ils,selection);
+      } else {
+        Shape* edges = _newEdgesShape();
+        for(size_t k=k0;k<k1;k++) parent[k].second->addChild(edges);
+        _edgesAdd(*ifs,*(IndexedLineSet*)edges->getGeometry(),selection);
+      }
+    }
+  }
+}
 
-        int i,i0,i1,nV,iV,iV0,iV1,iF;
-        nV = static_cast<int>(coordIfs.size()/3);
-        for(iV=0;iV<nV;iV++) {
-          coordIls.push_back(coordIfs[3*iV  ]);
-          coordIls.push_back(coordIfs[3*iV+1]);
-          coordIls.push_back(coordIfs[3*iV+2]);
-        }
+// appends the selected edges of ifs to ils, along with the coordinates
+// of their end points; the IndexedFaceSet is not modified, even if it
+// holds its faces in triangleIndex, or its coordinates quantized
+void SceneGraphProcessor::_edgesAdd
+(IndexedFaceSet& ifs, IndexedLineSet& ils, const int selection) {
+  vector<float> coordBuffer;
+  const vector<float>& coordIfs = ifs.readCoord(coordBuffer);
+  vector<int> coordIndexBuffer;
+  if(ifs.hasTriangleIndex())
+    TriangleMesh::toCoordIndex(ifs.getTriangleIndex(),coordIndexBuffer);
+  const vector<int>& coordIndexIfs =
+    (ifs.hasTriangleIndex())?coordIndexBuffer:ifs.getCoordIndex();
+  const int nV = (int)(coordIfs.size()/3);
+
+  // corners after the last -1 do not belong to any face
+  int nC = (int)coordIndexIfs.size();
+  while(nC>0 && coordIndexIfs[nC-1]>=0) nC--;
+  const vector<int>* coordIndex = &coordIndexIfs;
+  if(nC<(int)coordIndexIfs.size()) {
+    coordIndexBuffer.assign(coordIndexIfs.begin(),coordIndexIfs.begin()+nC);
+    coordIndex = &coordIndexBuffer;
+  }
 
-        for(iF=i0=i1=0;i1<(int)coordIndexIfs.size();i1++) {
-          if(coordIndexIfs[i1]<0) {
-            iV0 = coordIndexIfs[i1-1];
-            for(i=i0;i<i1;i++) {
-              iV1 = coordIndexIfs[i];
-              coordIndexIls.push_back(iV0);
-              coordIndexIls.push_back(iV1);
-              coordIndexIls.push_back(-1);
-              iV0 = iV1;
-            }
-            iF++; i0 = i1+1;
-          }
-        }
+  // the face incidence is only needed to classify the edges
+  Edges*     edges = (Edges*)0;
+  Graph*     graph = (Graph*)0;
+  HalfEdges* mesh  = (HalfEdges*)0;
+  if(selection==EDGES_ALL) {
+    graph = new Graph(nV);
+    int i,i0,i1;
+    for(i0=i1=0;i1<nC;i1++) {
+      if((*coordIndex)[i1]<0) {
+        for(i=i0;i<i1;i++)
+          graph->insertEdge((*coordIndex)[i],(*coordIndex)[(i+1<i1)?i+1:i0]);
+        i0 = i1+1;
+      }
+    }
+    edges = graph;
+  } else {
+    try {
+      edges = mesh = new HalfEdges(nV,*coordIndex);
+    } catch(StrException* e) { // vertex index out of range
+      delete e;
+      return;
+    }
+  }
 
+  vector<float> faceNormal;
+  float cosCreaseAngle = 0.0f;
+  if(selection&EDGES_CREASE) {
+    _computeFaceNormals(coordIfs,*coordIndex,faceNormal);
+    cosCreaseAngle = (float)cos(ifs.getCreaseangle());
+  }
 
+  vector<float>& coordIls      = ils.getCoord();
+  vector<int>&   coordIndexIls = ils.getCoordIndex();
+
+  // only the vertices of the selected edges are copied into ils
+  vector<int> vertexIls(nV,-1);
+  int iE,nE,iV,j,nEF;
+  bool selected;
+  nE = edges->getNumberOfEdges();
+  for(iE=0;iE<nE;iE++) {
+    if(selection==EDGES_ALL) {
+      selected = true;
+    } else {
+      nEF = mesh->getNumberOfEdgeHalfEdges(iE);
+      selected =
+        ((selection&EDGES_BOUNDARY) && nEF==1) ||
+        ((selection&EDGES_SINGULAR) && nEF>=3) ||
+        ((selection&EDGES_CREASE)   && nEF==2 &&
+         _isSmoothEdge(*mesh,iE,faceNormal,cosCreaseAngle)==false);
+    }
+    if(selected==false) continue;
+    for(j=0;j<2;j++) {
+      iV = (j==0)?edges->getVertex0(iE):edges->getVertex1(iE);
+      if(vertexIls[iV]<0) {
+        vertexIls[iV] = (int)(coordIls.size()/3);
+        coordIls.insert(coordIls.end(),&coordIfs[3*(size_t)iV],
+                        &coordIfs[3*(size_t)iV]+3);
       }
+      coordIndexIls.push_back(vertexIls[iV]);
     }
+    coordIndexIls.push_back(-1);
   }
+  // Edges has no virtual destructor
+  if(graph!=(Graph*)0) delete graph;
+  if(mesh !=(HalfEdges*)0) delete mesh;
 }
 
 void SceneGraphProcessor::edgesRemove() {
+  // the EDGES Shapes are removed after the traversal, which may still
+  // hold pointers to them; an EDGES Shape may be shared by several
+  // Groups, see edgesAdd(), so all the Groups are visited
+  vector<Group*> groups(1,&_wrl);
   SceneGraphTraversal traversal(_wrl);
   traversal.start();
   Node* node;
-  while((node=traversal.next())!=(Node*)0) {
-    if(node->isShape()) {
-      Shape* shape  = (Shape*)node;
-      const Node* parent = shape->getParent();
-      Group* group = (Group*)parent;
-      vector<pNode>& children = group->getChildren();
-      vector<pNode>::iterator i;
-      do {
-        for(i=children.begin();i!=children.end();i++)
-          if((*i)->nameEquals("EDGES"))
-            break;
-        if(i!=children.end()) {
-          children.erase(i);
-          i=children.begin();
-        }
-      } while(i!=children.end());
+  while((node=traversal.next())!=(Node*)0)
+    if(node->isGroup()) groups.push_back((Group*)node);
+  sort(groups.begin(),groups.end());
+  groups.erase(unique(groups.begin(),groups.end()),groups.end());
+  for(Group* group : groups) {
+    for(int i=group->getNumberOfChildren()-1;i>=0;i--) {
+      Node* child = (*group)[i];
+      if(child->nameEquals("EDGES"))
+        group->removeChild(child);
     }
   }
 }
@@ -888,7 +1782,7 @@ void SceneGraphProcessor::removeSceneGraphChild(const string& name) {
     if((*i)->nameEquals(name))
       break;
   if(i!=children.end())
-    children.erase(i);
+    _wrl.removeChild(*i);
 }
 
 void SceneGraphProcessor::pointsRemove() {
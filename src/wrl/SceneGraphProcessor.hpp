@@ -40,6 +40,9 @@
 #include "Shape.hpp"
 #include "IndexedFaceSet.hpp"
 #include "IndexedLineSet.hpp"
+#include "util/ThreadPool.hpp"
+
+class HalfEdges;
 
 class SceneGraphProcessor {
 
@@ -48,17 +51,72 @@ public:
   SceneGraphProcessor(SceneGraph& wrl);
   ~SceneGraphProcessor();
 
+  // the IndexedFaceSet operators below run on this many threads, one
+  // IndexedFaceSet per task; 0 means one per hardware thread, and 1
+  // runs them in the calling thread
+  void setNumberOfThreads(const int nThreads);
+  int  getNumberOfThreads() const;
+
   void normalClear();
   void normalInvert();
+  // triangle meshes use the block kernel of util/TriangleNormals.hpp
   void computeNormalPerFace();
+  // large IndexedFaceSets are processed one at a time, with their faces
+  // and vertices split across the threads; the result does not depend
+  // on the number of threads
   void computeNormalPerVertex();
+  // corners are smoothed across the edges where the faces meet at an
+  // angle smaller than the creaseAngle of their IndexedFaceSet
   void computeNormalPerCorner();
 
-  void bboxAdd(int depth=0, float scale=1.0f, bool isCube=true);
+  // holds coord, normal and color of every IndexedFaceSet in the
+  // compact encodings of util/Quantize.hpp, or back in floats
+  void quantize();
+  void dequantize();
+
+  // sorts the vertices of every IndexedFaceSet along a Morton curve,
+  // and the faces by their smallest vertex index, so that neighbouring
+  // vertices and faces are close in memory; all the per vertex, per
+  // face and per corner arrays are permuted accordingly
+  void vertexReorder();
+
+  // reorders the faces of every IndexedFaceSet which is a triangle
+  // mesh for the post-transform vertex cache of the GPU; getAcmr()
+  // returns the average number of vertices transformed per triangle
+  // over those meshes, for a FIFO cache of cacheSize vertices
+  void  triangleReorder();
+  float getAcmr(const int cacheSize=32);
+
+  // removes the vertices not used by any face of every IndexedFaceSet,
+  // along with their per vertex properties, and the normals, colors
+  // and texture coordinates not referenced by their index arrays; the
+  // index arrays are renumbered, and the memory released; point clouds,
+  // which have no faces, are left unchanged
+  void removeUnusedVertices();
+
+  // the BOUNDING-BOX Shape is the lattice of 2^depth cells per side
+  // dividing the scene bounding box; if isOccupied is true, only the
+  // cells containing IndexedFaceSet vertices are drawn, at every level
+  // of the octree from 0 to depth
+  void bboxAdd(int depth=0, float scale=1.0f, bool isCube=true,
+               bool isOccupied=false);
   void bboxRemove();
   bool hasBBox();
 
-  void edgesAdd();
+  // adds to the parent Group of every IndexedFaceSet an EDGES Shape,
+  // an IndexedLineSet with one polyline per edge of the mesh, each
+  // edge listed once; selection may combine EDGES_BOUNDARY (edges with
+  // one incident face), EDGES_SINGULAR (three or more), and
+  // EDGES_CREASE (two faces meeting at an angle larger than the
+  // creaseAngle, or with opposite orientations), or be EDGES_ALL
+  enum EdgeSelection {
+    EDGES_ALL      = 0,
+    EDGES_BOUNDARY = 1,
+    EDGES_SINGULAR = 2,
+    EDGES_CREASE   = 4
+  };
+
+  void edgesAdd(const int selection=EDGES_ALL);
   void edgesRemove();
   bool hasEdges();
 
@@ -90,8 +148,14 @@ public:
 private:
 
   SceneGraph&    _wrl;
+  int            _nThreads;
+  ThreadPool*    _pool;
 
   void        _applyToIndexedFaceSet(IndexedFaceSet::Operator p);
+  void        _getIndexedFaceSets(vector<IndexedFaceSet*>& ifsList);
+  ThreadPool& _getThreadPool();
+  void        _bboxAddOccupied(int depth, const float box[6],
+                               vector<float>& coord, vector<int>& coordIndex);
 
   // IndexedFaceSet::Operator
   static void _normalClear(IndexedFaceSet& ifs);
@@ -99,11 +163,34 @@ private:
   static void _computeNormalPerFace(IndexedFaceSet& ifs);
   static void _computeNormalPerVertex(IndexedFaceSet& ifs);
   static void _computeNormalPerCorner(IndexedFaceSet& ifs);
+  static void _quantize(IndexedFaceSet& ifs);
+  static void _dequantize(IndexedFaceSet& ifs);
+  static void _vertexReorder(IndexedFaceSet& ifs);
+  static void _triangleReorder(IndexedFaceSet& ifs);
+  static void _removeUnusedVertices(IndexedFaceSet& ifs);
+
+  // same result, with the faces and the vertices split across the
+  // threads of the pool
+  static void _computeNormalPerVertex(IndexedFaceSet& ifs, ThreadPool& pool);
 
   static void _computeFaceNormal
-              (vector<float>& coord, vector<int>&   coordIndex,
+              (const vector<float>& coord, const vector<int>& coordIndex,
                int i0, int i1, Vec3f& n, bool normalize);
 
+  // unit length normals of the faces terminated by a -1
+  static void _computeFaceNormals
+              (const vector<float>& coord, const vector<int>& coordIndex,
+               vector<float>& faceNormal);
+
+  // true if the edge has two incident faces, consistently oriented,
+  // whose normals form an angle smaller than the crease angle
+  static bool _isSmoothEdge
+              (const HalfEdges& mesh, const int iE,
+               const vector<float>& faceNormal, const float cosCreaseAngle);
+
+  static void _edgesAdd(IndexedFaceSet& ifs, IndexedLineSet& ils,
+                        const int selection);
+
   bool        _hasShapeProperty(Shape::Property p);
   bool        _hasIndexedFaceSetProperty(IndexedFaceSet::Property p);
   bool        _hasIndexedLineSetProperty(IndexedLineSet::Property p);
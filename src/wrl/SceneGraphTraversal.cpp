@@ -34,6 +34,7 @@
 
 #include <iostream>
 #include "SceneGraphTraversal.hpp"
+#include "Transform.hpp"
 
 // Use as follows
 //
@@ -53,24 +54,64 @@ SceneGraphTraversal::SceneGraphTraversal(SceneGraph& wrl):
 
 void SceneGraphTraversal::start() {
   _node.clear();
+  _nodeDepth.clear();
   int n = _wrl.getNumberOfChildren();
-  while((--n)>=0)
+  while((--n)>=0) {
     _node.push_back(_wrl[n]);
+    _nodeDepth.push_back(0);
+  }
+  static const float I[16] = {
+    1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f
+  };
+  _matrix.assign(I,I+16);
 }
 
 Node* SceneGraphTraversal::next() {
-  Node* next = (_node.size()>0)?_node.back():(Node*)0;
+  const float* matrix;
+  int          depth;
+  return next(matrix,depth);
+}
+
+Node* SceneGraphTraversal::next(const float*& matrix, int& depth) {
+  matrix = (const float*)0;
+  depth  = -1;
+  if(_node.size()==0) return (Node*)0;
+  Node* node = _node.back(); _node.pop_back();
+  depth = _nodeDepth.back(); _nodeDepth.pop_back();
   // advance for next call
-  if(_node.size()>0) {
-    Node* node = _node.back(); _node.pop_back();
-    if(node->isGroup()) {
-      Group* group = (Group*)node;
-      int n = group->getNumberOfChildren();
-      while((--n)>=0)
+  if(node->isGroup()) {
+    Group* group = (Group*)node;
+    int n = group->getNumberOfChildren();
+    if(n>0) {
+      // the stack holds no node deeper than node, so the matrices
+      // below depth+1 are no longer needed
+      _matrix.resize(16*(depth+2));
+      float*       M = &_matrix[16*(depth+1)];
+      const float* P = &_matrix[16*depth];
+      if(node->isTransform()) {
+        float T[16];
+        ((Transform*)node)->getMatrix(T);
+        // M = P*T; the last row of both is (0 0 0 1)
+        for(int i=0;i<12;i+=4) {
+          for(int j=0;j<4;j++)
+            M[i+j] = P[i]*T[j]+P[i+1]*T[4+j]+P[i+2]*T[8+j];
+          M[i+3] += P[i+3];
+        }
+        M[12] = M[13] = M[14] = 0.0f; M[15] = 1.0f;
+      } else {
+        for(int i=0;i<16;i++) M[i] = P[i];
+      }
+      while((--n)>=0) {
         _node.push_back((*group)[n]);
+        _nodeDepth.push_back(depth+1);
+      }
     }
   }
-  return next;
+  matrix = &_matrix[16*depth];
+  return node;
 }
 
 int SceneGraphTraversal::depth() {
@@ -42,6 +42,14 @@
 //   // do something with the node
 //   t.advance();
 // }
+//
+// or, to process the nodes in SceneGraph coordinates
+//
+// const float* M;
+// int depth;
+// while((child=t.next(M,depth))!=null) {
+//   // M maps the coordinates of the child to SceneGraph coordinates
+// }
 
 #ifndef _SceneGraphTraversal_h_
 #define _SceneGraphTraversal_h_
@@ -54,6 +62,11 @@ private:
 
   SceneGraph&    _wrl;
   vector<Node*> _node;
+  // depth of each node in _node
+  vector<int>   _nodeDepth;
+  // 16 floats per depth: the matrix of the nodes of that depth in the
+  // current path
+  vector<float> _matrix;
 
 public:
 
@@ -63,6 +76,14 @@ public:
   Node* next();
   int   depth();
 
+  // Like next(), and also returns the depth of the node, 0 for the
+  // children of the SceneGraph, and the matrix mapping the coordinates
+  // of the node to the SceneGraph coordinates, in the layout of
+  // Transform::getMatrix(); the matrix is valid until the following
+  // call. The matrices of the Transform nodes on the current path are
+  // composed once, when the traversal enters them, and kept on a stack
+  Node* next(const float*& matrix, int& depth);
+
 };
 
 #endif /* _SceneGraphTraversal_h_ */
@@ -35,13 +35,18 @@
 #include <iostream>
 #include "Shape.hpp"
 #include "Appearance.hpp"
+#include "IndexedFaceSet.hpp"
+#include "IndexedLineSet.hpp"
 
 Shape::Shape():
   _appearance((Node*)0),
   _geometry((Node*)0) {
+  _nodeType = SHAPE;
 }
 
 Shape::~Shape() {
+  if(_appearance!=(Node*)0) _appearance->unref(this);
+  if(_geometry!=(Node*)0) _geometry->unref(this);
 }
 
 Node* Shape::getAppearance() {
@@ -101,13 +106,25 @@ bool Shape::hasGeometryUnsupported() {
 }
 
 void Shape::setAppearance(Node* node) {
-  node->setParent(this);
+  if(node!=(Node*)0) node->ref(this);
+  if(_appearance!=(Node*)0) _appearance->unref(this);
   _appearance = node;
 }
 
 void Shape::setGeometry(Node* node) {
-  node->setParent(this);
+  if(node!=(Node*)0) node->ref(this);
+  if(_geometry!=(Node*)0) _geometry->unref(this);
   _geometry = node;
+  invalidateBBox();
+}
+
+bool Shape::getBBox(float box[6]) {
+  _bboxDirty = false;
+  if(hasGeometryIndexedFaceSet())
+    return ((IndexedFaceSet*)_geometry)->getBBox(box);
+  if(hasGeometryIndexedLineSet())
+    return ((IndexedLineSet*)_geometry)->getBBox(box);
+  return false;
 }
 
 void Shape::printInfo(string indent) {
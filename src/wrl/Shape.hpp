@@ -64,8 +64,11 @@ public:
   bool            hasGeometryIndexedFaceSet();
   bool            hasGeometryIndexedLineSet();
   bool            hasGeometryUnsupported();
+  // box = { xMin, yMin, zMin, xMax, yMax, zMax }, the box cached by
+  // the geometry node; returns false if the box is empty or the
+  // geometry is not supported
+  bool            getBBox(float box[6]);
   
-  virtual bool    isShape() const { return    true; }
   virtual string  getType() const { return "Shape"; }
   typedef bool    (*Property)(Shape& shape);
   typedef void    (*Operator)(Shape& shape);
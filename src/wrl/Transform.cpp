@@ -41,7 +41,9 @@ Transform::Transform():
   _rotation(0.0f,0.0f,1.0f,0.0f),
   _scale(1.0f,1.0f,1.0f),
   _scaleOrientation(0.0f,0.0f,1.0f,0.0f),
-  _translation(0.0f,0.0f,0.0f) {
+  _translation(0.0f,0.0f,0.0f),
+  _hasMatrix(false) {
+  _nodeType = TRANSFORM;
 }
 
 Transform::~Transform() {
@@ -54,21 +56,61 @@ Vec3f&    Transform::getScale()                      {  return            _scale
 Rotation& Transform::getScaleOrientation()           {  return _scaleOrientation; }
 Vec3f&    Transform::getTranslation()                {  return      _translation; }
 
-void Transform::setCenter(Vec3f& value)              {           _center = value; }
-void Transform::setRotation(Rotation& value)         {         _rotation = value; }
-void Transform::setScale(Vec3f& value)               {            _scale = value; }
-void Transform::setScaleOrientation(Rotation& value) { _scaleOrientation = value; }
-void Transform::setTranslation(Vec3f& value)         {      _translation = value; }
+// the bounding box of a Transform is in the coordinates of its
+// children, but the boxes of its ancestors change with its fields,
+// and so does the cached matrix
+
+void Transform::setCenter(Vec3f& value) {
+  _center = value;
+  _hasMatrix = false;
+  invalidateBBox();
+}
+
+void Transform::setRotation(Rotation& value) {
+  _rotation = value;
+  _hasMatrix = false;
+  invalidateBBox();
+}
+
+void Transform::setScale(Vec3f& value) {
+  _scale = value;
+  _hasMatrix = false;
+  invalidateBBox();
+}
+
+void Transform::setScaleOrientation(Rotation& value) {
+  _scaleOrientation = value;
+  _hasMatrix = false;
+  invalidateBBox();
+}
+
+void Transform::setTranslation(Vec3f& value) {
+  _translation = value;
+  _hasMatrix = false;
+  invalidateBBox();
+}
 
 void Transform::setRotation(Vec4f& value) {
   _rotation = value;
+  _hasMatrix = false;
+  invalidateBBox();
 }
 
 void Transform::setScaleOrientation(Vec4f& value) {
   _scaleOrientation = value;
+  _hasMatrix = false;
+  invalidateBBox();
 }
 
 void Transform::getMatrix(float* M /*[16]*/) {
+  if(_hasMatrix==false) {
+    _makeMatrix(_matrix);
+    _hasMatrix = true;
+  }
+  for(int i=0;i<16;i++) M[i] = _matrix[i];
+}
+
+void Transform::_makeMatrix(float* M /*[16]*/) {
   M[ 0] = 1.0f; M[ 1] = 0.0f; M[ 2] = 0.0f; M[ 3] = 0.0f;
   M[ 4] = 0.0f; M[ 5] = 1.0f; M[ 6] = 0.0f; M[ 7] = 0.0f;
   M[ 8] = 0.0f; M[ 9] = 0.0f; M[10] = 1.0f; M[11] = 0.0f;
@@ -63,6 +63,10 @@ private:
   Rotation      _scaleOrientation; // 0 0 1 0
   Vec3f         _translation;      // 0 0 0
 
+  // getMatrix() cache, cleared by the set methods
+  float         _matrix[16];
+  bool          _hasMatrix;
+
   // inherited from Group
   // vector<Node*> _children;
   // Vec3f         _bboxCenter;
@@ -87,9 +91,11 @@ public:
   void      setScaleOrientation(Vec4f& value);
   void      setTranslation(Vec3f& value);
 
-  void      getMatrix(float* T /*[16]*/);
+  // M maps the coordinates of the children to the coordinates of the
+  // parent, with rows M[0:4), M[4:8), M[8:12), M[12:16); the matrix is
+  // computed again only after one of the fields is set
+  void      getMatrix(float* M /*[16]*/);
 
-  virtual bool    isTransform() const { return        true; }
   virtual string  getType()     const { return "Transform"; }
   typedef bool    (*Property)(Transform& transform);
   typedef void    (*Operator)(Transform& transform);
@@ -98,6 +104,7 @@ public:
 
 private:
 
+  void        _makeMatrix(float* M /*[16]*/);
   static void _makeRotation(Rotation& r, float* R /*[9]*/);
 
 };